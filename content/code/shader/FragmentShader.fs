@@ -2,18 +2,29 @@
 
 #define PI 3.141592
 
-struct Material {
+// Updated when the material changes, see MaterialBlock
+layout (std140) uniform MaterialBlock {
     vec3 color;
-    sampler2D diffuse;
-    sampler2D specular;
     float shininess;
-};
+    bool hasDiffuse;
+    bool hasSpecular;
+} material;
 
-struct Light {
+// Same for every object of a frame, see LightBlock
+layout (std140) uniform LightBlock {
     vec3 position;     // Light position in world space
     vec3 ambient;      // Ambient color of the light
     vec3 diffuse;      // Diffuse color of the light
     vec3 specular;     // Specular color of the light
+} light;
+
+// Same for every object of a frame, see FrameBlock
+layout (std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrix;
+    mat4 lightSpaceMatrix;
+    ivec4 flags;        // x: draw normals as colors
 };
 
 in vec3 FragPos;
@@ -21,16 +32,19 @@ in vec3 viewDir;
 in vec3 Normal;
 in vec2 TexCoords;
 in vec4 FragPosLightSpace;
+#ifdef INSTANCED
+in vec3 InstanceColor;
+#define OBJECT_COLOR InstanceColor
+#else
+#define OBJECT_COLOR material.color
+#endif
 
 out vec4 FragColor;
 
-uniform Material material;
-uniform Light light;
-uniform bool hasDiffuse; 
-uniform bool hasSpecular; 
+uniform sampler2D diffuseMap;
+uniform sampler2D specularMap;
 uniform mat4 localModel;
 uniform int textureType;
-uniform int DebugNormal;
 uniform sampler2D shadowMap;
 
 vec2 Cube(vec3 FragPos);
@@ -76,30 +90,30 @@ void main()
     vec3 lightDir = normalize(light.position - FragPos);
 
     // ---- Ambient Lighting ----
-    vec3 ambient = (light.ambient * material.color);
+    vec3 ambient = (light.ambient * OBJECT_COLOR);
 
     // ---- Diffuse Lighting (Lambertian reflectance) ----
     vec3 diffuse = vec3(0.f); // Initialize to zero
     float diff = max(dot(norm, lightDir), 0.f);
-    if (hasDiffuse) 
-        diffuse = diff * light.diffuse * vec3(texture(material.diffuse, uv));
+    if (material.hasDiffuse) 
+        diffuse = diff * light.diffuse * vec3(texture(diffuseMap, uv));
     else 
-        diffuse = diff * light.diffuse * material.color;
+        diffuse = diff * light.diffuse * OBJECT_COLOR;
 
 
     // ---- Specular Lighting (Phong reflection model) ----
     vec3 specular = vec3(0.f); // Initialize to zero
-    if (hasSpecular) 
+    if (material.hasSpecular) 
     {
         vec3 reflectDir = reflect(-lightDir, norm);
         float spec = pow(max(dot(viewDirNormalized, reflectDir), 0.f), material.shininess);
-        specular = spec * light.specular * vec3(texture(material.specular, uv));
+        specular = spec * light.specular * vec3(texture(specularMap, uv));
     }
     float shadow = ShadowCalculation(FragPosLightSpace);
     // Combine all the lighting components
-    vec3 finalColor = (ambient + (1.0 - shadow) * (diffuse + specular)) * material.color;    
+    vec3 finalColor = (ambient + (1.0 - shadow) * (diffuse + specular)) * OBJECT_COLOR;    
     
-    if (DebugNormal == 1)
+    if (flags.x == 1)
         finalColor = norm;
     // Set the final color output
     FragColor = vec4(finalColor, 1.f);
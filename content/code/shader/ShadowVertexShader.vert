@@ -1,10 +1,26 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
+#ifdef INSTANCED
+layout (location = 3) in mat4 aInstanceModel;
+#endif
 
-uniform mat4 lightSpaceMatrix;
+// Same for every object of a frame, see FrameBlock
+layout (std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrix;
+    mat4 lightSpaceMatrix;
+    ivec4 flags;        // x: draw normals as colors
+};
+
+#ifndef INSTANCED
 uniform mat4 model;
+#endif
 
 void main()
 {
+#ifdef INSTANCED
+    mat4 model = aInstanceModel;
+#endif
     gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
 }  
\ No newline at end of file
@@ -3,21 +3,39 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
+#ifdef INSTANCED
+layout (location = 3) in mat4 aInstanceModel;  // takes locations 3 to 6
+layout (location = 7) in vec3 aInstanceColor;
+#endif
 
 out vec3 FragPos;      // Fragment position in world space
 out vec3 Normal;       // Normal in world space
 out vec2 TexCoords;    // Texture coordinates
 out vec3 viewDir;      // View direction
 out vec4 FragPosLightSpace;
-
+#ifdef INSTANCED
+out vec3 InstanceColor;
+#else
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#endif
 uniform vec3 viewPos;  // Camera position passed from application
-uniform mat4 lightSpaceMatrix;
+
+// Same for every object of a frame, see FrameBlock
+layout (std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrix;
+    mat4 lightSpaceMatrix;
+    ivec4 flags;        // x: draw normals as colors
+};
 
 void main()
 {
+#ifdef INSTANCED
+    mat4 model = aInstanceModel;
+    InstanceColor = aInstanceColor;
+#endif
+
     // Calculate the world position of the fragment
     FragPos = vec3(model * vec4(aPos, 1.0));
     
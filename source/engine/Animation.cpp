@@ -14,8 +14,18 @@ void Animation::Update(float _deltaTime)
 	currentTime += static_cast<float>(ticksPerSecond) * deltaTime;
 	currentTime = static_cast<float>(fmod(currentTime, duration));
 
-	for (auto& pair : model->boneMap)
+	if (m_bones.size() != model->boneMap.size())
 	{
-		pair.second.Update(currentTime);
+		m_bones.clear();
+		for (auto& pair : model->boneMap)
+			m_bones.push_back(&pair.second);
 	}
+
+	// Every bone samples its own keys, the bones of a rig are independent
+	SERVICE_LOCATOR.GetJobSystem()->ParallelFor(static_cast<uint32_t>(m_bones.size()), 16,
+		[this](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; ++i)
+				m_bones[i]->Update(currentTime);
+		});
 }
@@ -14,6 +14,10 @@ public:
 
 	Animation(Model* _model);
 	void Update(float _deltaTime);
+
+private:
+	// Bones of the model in a flat list so they can be sampled in parallel
+	std::vector<Bone*> m_bones;
 };
 
 
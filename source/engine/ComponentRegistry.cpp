@@ -0,0 +1,22 @@
+#include "pch.h"
+#include "ComponentRegistry.h"
+
+std::string_view ComponentRegistry::GetName(size_t id)
+{
+	assert(id < GetCount() && "Component type is not registered");
+	return s_names[id];
+}
+
+size_t ComponentRegistry::registerType(std::string name)
+{
+	// Registrations are rare, so they take turns. The count only grows once the name is written, so
+	// GetName can read any ID below GetCount without the lock, and a failed registration changes nothing
+	std::lock_guard<std::mutex> lock(s_registerMutex);
+	size_t id = s_count.load(std::memory_order_relaxed);
+	if (id >= MAX_COMPONENTS)
+		throw std::runtime_error("Too many component types registered, raise ComponentRegistry::MAX_COMPONENTS");
+
+	s_names[id] = std::move(name);
+	s_count.store(id + 1, std::memory_order_release);
+	return id;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// Assigns every component type a dense integer ID on first use so nodes can store
+// their components in fixed slots instead of a string keyed hash map
+class ComponentRegistry
+{
+public:
+	// Upper bound of distinct component types, also the number of slots per node
+	static constexpr size_t MAX_COMPONENTS = 32;
+	using Signature = std::bitset<MAX_COMPONENTS>;
+
+	//@brief Returns the ID of the component type, registering it on the first call
+	//@return size_t : Dense ID in range [0, MAX_COMPONENTS)
+	template <typename DataType>
+	static size_t GetID()
+	{
+		static const size_t id = registerType(Utils::GetClassName<DataType>());
+		return id;
+	}
+
+	//@brief Returns the class name the component type was registered with (serialization only)
+	//@param id : Component type ID
+	//@return std::string_view : Class name of the component type
+	static std::string_view GetName(size_t id);
+
+	//@brief Returns the number of component types registered so far
+	//@return size_t : Number of registered types
+	static size_t GetCount() { return s_count.load(std::memory_order_acquire); }
+
+private:
+	//@brief Reserves the next free ID for a new component type
+	//@param name : Class name of the component type
+	//@return size_t : The reserved ID
+	static size_t registerType(std::string name);
+
+	static inline std::atomic<size_t> s_count{ 0 };
+	static inline std::array<std::string, MAX_COMPONENTS> s_names;
+	static inline std::mutex s_registerMutex;		// held while an ID is reserved and its name written
+};
@@ -6,10 +6,15 @@
 #include "Input.h"
 #include "physics/PhysicsComponent.h"
 #include "physics/PhysicsManager.h"
+#include "scenemanager/SceneManager.h"
 #include "ServiceLocator.h"
 
 void ControllerComponent::Init()
-{}
+{
+	// The origin follows the player, so the scene around it keeps its precision however far it goes
+	if (Scene* scene = SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene())
+		scene->SetOriginFocus(pOwner);
+}
 
 void ControllerComponent::Update()
 {
@@ -88,20 +93,26 @@ void ControllerComponent::Update()
 	{
 		pRot.z -= 5;
 	}
-	if (m_InputHandler->IsKeyPressed(GLFW_KEY_SPACE))
+	auto* physicsComp = pOwner->GetComponent<PhysicsComponent>();
+	if (physicsComp && physicsComp->Grounded())
 	{
-		auto* physicsComp = pOwner->GetComponent<PhysicsComponent>();
-		if (!physicsComp) { return; }
-		if (!physicsComp->Grounded()) { return; }
-		glm::dvec3 gravity = SERVICE_LOCATOR.GetPhysicsManager()->GetGravity();
-		glm::dvec3 gravNorm = glm::normalize(gravity);
-		double jumpForce = 5.0;
-		glm::dvec3 jump = -gravNorm * jumpForce;
-		physicsComp->ApplyForce(jump);
+		// The body rides along with whatever it stands on, see PhysicsComponent::GroundedResponse
+		const PhysicsComponent::GroundInfo& ground = physicsComp->GetGroundInfo();
+		if (m_InputHandler->IsKeyPressed(GLFW_KEY_SPACE))
+		{
+			// Jump off the ground, the way it faces
+			double jumpForce = 5.0;
+			glm::dvec3 jump = ground.normal * jumpForce;
+			physicsComp->ApplyForce(jump);
+		}
 	}
 	pTransform->SetPosition(pPos);
 	pTransform->SetRotation(pRot);
 }
 
 void ControllerComponent::Shutdown()
-{}
+{
+	Scene* scene = SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene();
+	if (scene && scene->GetOriginFocus() == pOwner)
+		scene->SetOriginFocus(nullptr);
+}
@@ -19,6 +19,8 @@ struct VERTEX_DATA
 {
     std::vector<glm::vec3> vertex_buffer;
     std::vector<unsigned int> index_buffer;
+    glm::vec3 bounds_min{ 0.f };   // corners of the box around vertex_buffer
+    glm::vec3 bounds_max{ 0.f };
 };
 
 struct NORMAL_DATA
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "Engine.h"
 #include "headers.h"
+#include "scenemanager/SceneManager.h"
 
 std::unique_ptr<Engine> Engine::instance = nullptr;
 
@@ -65,6 +66,12 @@ void Engine::Run()
 
 	init();
 
+	if (m_headlessTicks > 0)
+	{
+		Simulate(m_headlessTicks);
+		shutdown();
+	}
+
 	while (m_pGame->IsRunning())
 	{
  		update();
@@ -74,9 +81,22 @@ void Engine::Run()
 	shutdown();
 }
 
+void Engine::Simulate(uint32_t ticks)
+{
+	const double dt = SERVICE_LOCATOR.GetTime()->GetFixedDeltaTime();
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (uint32_t i = 0; i < ticks; ++i)
+		step();
+	const double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	printf("Simulated %u ticks (%.2f s of game time) in %.2f ms, %.2f us/tick, %.1fx real time\n",
+		ticks, ticks * dt, ms, ms * 1000.0 / std::max(ticks, 1u), ticks * dt * 1000.0 / std::max(ms, 1e-6));
+}
+
 void Engine::init()
 {
 	GLFWwindow* context = nullptr;
+	SERVICE_LOCATOR.GetJobSystem()->Init();
 	SERVICE_LOCATOR.GetTime()->Init(1.0f / 60.0f);
 	SERVICE_LOCATOR.GetWindowHandler()->Init();
 	SERVICE_LOCATOR.GetRenderer()->Init();
@@ -89,6 +109,7 @@ void Engine::init()
 	ui->SetDebug(false);
 
 	initGames();
+	buildFrameGraph();
 
     std::cout << "Engine Initialized" << std::endl;
 }
@@ -97,8 +118,8 @@ void Engine::update()
 {
 	Input* input = SERVICE_LOCATOR.GetInput();
 	UI* ui = SERVICE_LOCATOR.GetUI();
-	
-	SERVICE_LOCATOR.GetAudioManager()->Update();
+
+	// GLFW and ImGui state is polled here on the main thread, the tasks below only read it
 	SERVICE_LOCATOR.GetWindowHandler()->Update();
 	input->Update();
 
@@ -112,27 +133,25 @@ void Engine::update()
 
 	SERVICE_LOCATOR.GetTime()->Update();
 
-#ifdef _DEBUG
-	if (!ui->GetIsPaused())
-#endif
-	SERVICE_LOCATOR.GetPhysicsManager()->Update(SERVICE_LOCATOR.GetTime()->GetDeltaTime());
-
-	SERVICE_LOCATOR.GetCollisionManager()->Update();
-	SERVICE_LOCATOR.GetEventHandler()->Update();
-	Camera::GetInstance()->Update();
-	SERVICE_LOCATOR.GetScriptManager()->Update(SERVICE_LOCATOR.GetTime()->GetDeltaTime());
-
-#ifdef _DEBUG
-	if (!ui->GetIsPaused())
-#endif
-	m_pGame->Update();
+	m_frameGraph.Run(*SERVICE_LOCATOR.GetJobSystem());
 }
 
 void Engine::render()
 {
+	// Bodies are drawn between their last two simulated poses, so motion stays smooth
+	// whatever the ratio between the frame rate and the simulation rate
+	double alpha = SERVICE_LOCATOR.GetTime()->GetInterpolationAlpha();
+#ifdef _DEBUG
+	if (SERVICE_LOCATOR.GetUI()->GetIsPaused())
+		alpha = 1.0;
+#endif
+	PhysicsManager* physics = SERVICE_LOCATOR.GetPhysicsManager();
+	physics->BeginInterpolation(alpha);
+
     //TODO: Should be replaced after the scene manager is implemented
 	SERVICE_LOCATOR.GetRenderer()->Render();
 	m_pGame->Render();
+	physics->EndInterpolation();
 	SERVICE_LOCATOR.GetUI()->Render();
 }
 
@@ -159,6 +178,7 @@ void Engine::shutdown()
 	SERVICE_LOCATOR.GetUI()->Shutdown();
 	SERVICE_LOCATOR.GetWindowHandler()->Shutdown();
 	SERVICE_LOCATOR.GetAudioManager()->Shutdown();
+	SERVICE_LOCATOR.GetJobSystem()->Shutdown();
 	exit(EXIT_SUCCESS);
 	std::cout << "Engine Shutdown" << std::endl;
 	//delete instance;
@@ -170,3 +190,59 @@ void Engine::initGames()
 		for (auto& game : m_games)
 			game->Init();
 }
+
+void Engine::buildFrameGraph()
+{
+	using Affinity = TaskGraph::Affinity;
+	m_frameGraph.Clear();
+
+	// The simulation runs next to audio and the camera, which only share the input polled
+	// in update(). Events, scripts and the game may touch GL, Lua or anything else, so they
+	// stay on the main thread and in their original order
+	TaskGraph::TaskId simulation = m_frameGraph.AddTask("Simulation", [this]()
+	{
+		const uint32_t steps = SERVICE_LOCATOR.GetTime()->GetStepCount();
+		for (uint32_t i = 0; i < steps; ++i)
+			step();
+	});
+
+	// The listener position comes from the camera, update it first like before
+	TaskGraph::TaskId audio = m_frameGraph.AddTask("Audio", []()
+	{
+		SERVICE_LOCATOR.GetAudioManager()->Update();
+	});
+	TaskGraph::TaskId camera = m_frameGraph.AddTask("Camera", []()
+	{
+		Camera::GetInstance()->Update();
+	}, { audio });
+
+	TaskGraph::TaskId events = m_frameGraph.AddTask("Events", []()
+	{
+		SERVICE_LOCATOR.GetEventHandler()->Update();
+	}, { simulation, camera }, Affinity::MAIN_THREAD);
+	TaskGraph::TaskId scripts = m_frameGraph.AddTask("Scripts", []()
+	{
+		SERVICE_LOCATOR.GetScriptManager()->Update(SERVICE_LOCATOR.GetTime()->GetDeltaTime());
+	}, { events }, Affinity::MAIN_THREAD);
+	m_frameGraph.AddTask("Game", [this]()
+	{
+#ifdef _DEBUG
+		if (SERVICE_LOCATOR.GetUI()->GetIsPaused())
+			return;
+#endif
+		m_pGame->Update();
+	}, { scripts }, Affinity::MAIN_THREAD);
+}
+
+void Engine::step()
+{
+	// Physics always advances by the fixed delta time, the frame time only decides how many steps run
+#ifdef _DEBUG
+	if (!SERVICE_LOCATOR.GetUI()->GetIsPaused())
+#endif
+		SERVICE_LOCATOR.GetPhysicsManager()->Update(SERVICE_LOCATOR.GetTime()->GetFixedDeltaTime());
+	SERVICE_LOCATOR.GetCollisionManager()->Update();
+	// Rebased once the step is done, so the next one starts with everything moved together
+	if (Scene* scene = SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene())
+		scene->UpdateOrigin();
+}
@@ -16,11 +16,23 @@ public:
 	//@brief Runs the engine
 	void Run();
 
+	//@brief Makes Run simulate a number of fixed steps back to back after initializing, without
+	// rendering, then shut down
+	//@param ticks : Number of fixed steps, 0 to run the game loop
+	inline void SetHeadless(uint32_t ticks) { m_headlessTicks = ticks; }
+
+	//@brief Runs fixed simulation steps back to back as fast as possible, without polling or
+	// rendering, and prints how long they took
+	//@param ticks : Number of fixed steps
+	void Simulate(uint32_t ticks);
+
 private:
 	unsigned int m_prevGameIndex = 0;
 	static std::unique_ptr<Engine> instance;
 	Game* m_pGame = nullptr;
 	std::vector<Game*> m_games;
+	TaskGraph m_frameGraph;		// Systems updated every frame, see buildFrameGraph
+	uint32_t m_headlessTicks = 0;
 
 	//@brief Initializes the engine
 	void init();
@@ -34,5 +46,9 @@ private:
 	void shutdown();
 	//@brief initializes all games
 	void initGames();
+	//@brief Declares the per-frame systems and the order they depend on
+	void buildFrameGraph();
+	//@brief Advances the simulation by one fixed step
+	void step();
 };
 
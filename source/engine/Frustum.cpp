@@ -0,0 +1,126 @@
+#include "pch.h"
+#include "Frustum.h"
+#include "FrustumKernels.h"
+
+namespace {
+
+	//@brief Returns the plane test for this processor, the AVX2 one if it has it and the SSE2 one otherwise
+	const FrustumKernels::Set& Kernels()
+	{
+		static const FrustumKernels::Set kernels = Utils::HasAvx2() ? FrustumKernels::Avx2() : CompiledKernels();
+		return kernels;
+	}
+}
+
+const uint32_t FrustumCuller::LANES = Kernels().lanes;
+
+// ****** BoundingVolume ****** //
+#pragma region BoundingVolume
+BoundingVolume BoundingVolume::FromBox(const glm::vec3& min, const glm::vec3& max)
+{
+	BoundingVolume volume;
+	volume.min = min;
+	volume.max = max;
+	volume.center = (min + max) * 0.5f;
+	volume.radius = glm::length(max - volume.center);
+	return volume;
+}
+
+BoundingVolume BoundingVolume::FromPoints(const glm::vec3* points, size_t count, size_t stride)
+{
+	if (count == 0)
+		return BoundingVolume();
+
+	auto point = [points, stride](size_t i) -> const glm::vec3& {
+		return *reinterpret_cast<const glm::vec3*>(reinterpret_cast<const char*>(points) + i * stride);
+	};
+	glm::vec3 min = point(0);
+	glm::vec3 max = point(0);
+	for (size_t i = 1; i < count; ++i)
+	{
+		min = glm::min(min, point(i));
+		max = glm::max(max, point(i));
+	}
+
+	// The sphere through the corners of the box is loose around most meshes, the farthest point is exact
+	BoundingVolume volume = FromBox(min, max);
+	float radius2 = 0.0f;
+	for (size_t i = 0; i < count; ++i)
+		radius2 = std::max(radius2, glm::length2(point(i) - volume.center));
+	volume.radius = std::sqrt(radius2);
+	return volume;
+}
+
+BoundingVolume BoundingVolume::Merge(const BoundingVolume& other) const
+{
+	BoundingVolume volume = FromBox(glm::min(min, other.min), glm::max(max, other.max));
+	// Around both spheres, never larger than the one through the corners of the merged box
+	volume.radius = std::min(volume.radius, std::max(glm::length(center - volume.center) + radius,
+		glm::length(other.center - volume.center) + other.radius));
+	return volume;
+}
+#pragma endregion
+
+// ****** Frustum ****** //
+#pragma region Frustum
+Frustum::Frustum(const glm::mat4& viewProjection)
+{
+	// A point is inside when -w <= x, y, z <= w in clip space, each bound is a plane of the rows of the matrix
+	const glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+	const glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+	const glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+	const glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+	planes = { row3 + row0, row3 - row0, row3 + row1, row3 - row1, row3 + row2, row3 - row2 };
+}
+#pragma endregion
+
+// ****** FrustumCuller ****** //
+#pragma region FrustumCuller
+void FrustumCuller::Clear()
+{
+	// The arrays keep their size, entries past the count are padding
+	m_count = 0;
+}
+
+uint32_t FrustumCuller::Add(const BoundingVolume& volume, const glm::mat4& world)
+{
+	// The world box around the turned local box: its center moves with the matrix, each half extent
+	// is the sum of the local ones scaled by the absolute matrix
+	const glm::vec3 center = glm::vec3(world * glm::vec4((volume.min + volume.max) * 0.5f, 1.0f));
+	const glm::vec3 extent = (volume.max - volume.min) * 0.5f;
+	const glm::mat3 absolute(glm::abs(glm::vec3(world[0])), glm::abs(glm::vec3(world[1])), glm::abs(glm::vec3(world[2])));
+	const glm::vec3 worldExtent = absolute * extent;
+
+	if (m_centerX.size() <= m_count)
+	{
+		for (std::vector<float>* field : { &m_centerX, &m_centerY, &m_centerZ, &m_extentX, &m_extentY, &m_extentZ })
+			field->resize(m_count + 1, 0.0f);
+	}
+	m_centerX[m_count] = center.x;
+	m_centerY[m_count] = center.y;
+	m_centerZ[m_count] = center.z;
+	m_extentX[m_count] = worldExtent.x;
+	m_extentY[m_count] = worldExtent.y;
+	m_extentZ[m_count] = worldExtent.z;
+	return m_count++;
+}
+
+uint32_t FrustumCuller::Cull(const Frustum& frustum, std::vector<uint8_t>& visible)
+{
+	visible.assign(m_count, 0);
+	if (m_count == 0)
+		return 0;
+
+	// Padding boxes are tested with the rest and their results dropped
+	const FrustumKernels::Set& kernels = Kernels();
+	const size_t padded = (m_count + kernels.lanes - 1) / kernels.lanes * kernels.lanes;
+	if (m_centerX.size() < padded)
+	{
+		for (std::vector<float>* field : { &m_centerX, &m_centerY, &m_centerZ, &m_extentX, &m_extentY, &m_extentZ })
+			field->resize(padded, 0.0f);
+	}
+
+	const FrustumKernels::Boxes boxes{ m_centerX.data(), m_centerY.data(), m_centerZ.data(), m_extentX.data(), m_extentY.data(), m_extentZ.data() };
+	return kernels.cull(boxes, m_count, reinterpret_cast<const float (*)[4]>(frustum.planes.data()), visible.data());
+}
+#pragma endregion
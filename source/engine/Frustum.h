@@ -0,0 +1,69 @@
+#pragma once
+
+// Box and sphere around the vertices of a mesh, in its local space
+struct BoundingVolume
+{
+	glm::vec3 min{ 0.0f };
+	glm::vec3 max{ 0.0f };
+	glm::vec3 center{ 0.0f };
+	float radius = 0.0f;
+
+	//@brief Builds the volume around a box
+	//@param min : Lowest corner
+	//@param max : Highest corner
+	//@return BoundingVolume : The box and the sphere through its corners
+	static BoundingVolume FromBox(const glm::vec3& min, const glm::vec3& max);
+
+	//@brief Builds the volume around points
+	//@param points : First point
+	//@param count : Points, none gives an empty volume at the origin
+	//@param stride : Bytes from one point to the next
+	//@return BoundingVolume : The box around the points and the sphere around its center
+	static BoundingVolume FromPoints(const glm::vec3* points, size_t count, size_t stride = sizeof(glm::vec3));
+
+	//@brief Returns the volume around this one and another
+	BoundingVolume Merge(const BoundingVolume& other) const;
+};
+
+// The six planes bounding what a view projection matrix sees, normals pointing inside
+struct Frustum
+{
+	std::array<glm::vec4, 6> planes;
+
+	//@brief Extracts the planes from the matrix
+	//@param viewProjection : Projection times view, into OpenGL clip space
+	explicit Frustum(const glm::mat4& viewProjection);
+};
+
+// Tests the world boxes of a batch of objects against frustums. The boxes are kept one array per field
+// so LANES of them are tested against a plane with one vector instruction per field
+class FrustumCuller
+{
+public:
+	// Boxes tested by one vector instruction: 8 on processors with AVX2, 4 on the others, 1 without SSE2
+	static const uint32_t LANES;
+
+	//@brief Drops the objects added since the last Clear
+	void Clear();
+
+	//@brief Adds the box of an object, turned into the world box around it
+	//@param volume : Local volume of the object
+	//@param world : World matrix of the object
+	//@return uint32_t : Index of the object in the visibility lists
+	uint32_t Add(const BoundingVolume& volume, const glm::mat4& world);
+
+	//@brief Tests every object against a frustum
+	//@param frustum : The frustum
+	//@param visible : Resized to the objects added, set to 1 for each object whose box touches the frustum
+	//@return uint32_t : Objects visible
+	uint32_t Cull(const Frustum& frustum, std::vector<uint8_t>& visible);
+
+	//@brief Returns the objects added since the last Clear
+	inline uint32_t GetCount() const { return m_count; }
+
+private:
+	// World boxes as center and half extent. The arrays only grow, entries past the count pad the last batch
+	std::vector<float> m_centerX, m_centerY, m_centerZ;
+	std::vector<float> m_extentX, m_extentY, m_extentZ;
+	uint32_t m_count = 0;
+};
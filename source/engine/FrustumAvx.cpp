@@ -0,0 +1,8 @@
+// Built with AVX2 and without the precompiled header, see FrustumKernels.h. Without the flag, as in
+// Win32 builds, this is the same test as Frustum.cpp's
+#include "FrustumKernels.h"
+
+FrustumKernels::Set FrustumKernels::Avx2()
+{
+	return CompiledKernels();
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// The plane test of FrustumCuller. Included by Frustum.cpp, built for SSE2, and by FrustumAvx.cpp, built
+// for AVX2, so the test is compiled once per instruction set. Only plain pointers cross into it, so the
+// AVX2 file instantiates no library code the linker could share
+namespace FrustumKernels {
+
+	// World boxes as center and half extent, one array per field padded to a whole number of lanes
+	struct Boxes
+	{
+		const float* centerX;
+		const float* centerY;
+		const float* centerZ;
+		const float* extentX;
+		const float* extentY;
+		const float* extentZ;
+	};
+
+	// Tests count boxes against the 6 planes, as x, y, z and w, and sets visible[i] to whether box i touches
+	// all of them. Returns the boxes visible
+	using Kernel = uint32_t (*)(const Boxes& boxes, uint32_t count, const float (*planes)[4], uint8_t* visible);
+
+	// The test for one instruction set, lanes being the boxes it tests at a time
+	struct Set
+	{
+		uint32_t lanes;
+		Kernel cull;
+	};
+
+	//@brief Returns the test built for AVX2, only to be run when Utils::HasAvx2
+	Set Avx2();
+}
+
+// Internal to each file that includes it, as each builds it for its own instruction set
+namespace {
+
+	// The operations the plane test needs, on as many floats as one register holds
+	struct Lanes
+	{
+#if defined(__AVX__)
+		using Type = __m256;
+		static constexpr uint32_t COUNT = 8;
+		static Type Load(const float* values) { return _mm256_loadu_ps(values); }
+		static Type Set(float value) { return _mm256_set1_ps(value); }
+		static Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+		static Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+		static uint32_t LessMask(Type a, Type b) { return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ))); }
+#elif defined(__SSE2__) || defined(_M_X64)
+		using Type = __m128;
+		static constexpr uint32_t COUNT = 4;
+		static Type Load(const float* values) { return _mm_loadu_ps(values); }
+		static Type Set(float value) { return _mm_set1_ps(value); }
+		static Type Add(Type a, Type b) { return _mm_add_ps(a, b); }
+		static Type Mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+		static uint32_t LessMask(Type a, Type b) { return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(a, b))); }
+#else
+		using Type = float;
+		static constexpr uint32_t COUNT = 1;
+		static Type Load(const float* values) { return *values; }
+		static Type Set(float value) { return value; }
+		static Type Add(Type a, Type b) { return a + b; }
+		static Type Mul(Type a, Type b) { return a * b; }
+		static uint32_t LessMask(Type a, Type b) { return a < b ? 1u : 0u; }
+#endif
+	};
+
+	uint32_t CullBoxes(const FrustumKernels::Boxes& boxes, uint32_t count, const float (*planes)[4], uint8_t* visible)
+	{
+		const Lanes::Type zero = Lanes::Set(0.0f);
+		uint32_t visibleCount = 0;
+		for (uint32_t first = 0; first < count; first += Lanes::COUNT)
+		{
+			const Lanes::Type centerX = Lanes::Load(&boxes.centerX[first]);
+			const Lanes::Type centerY = Lanes::Load(&boxes.centerY[first]);
+			const Lanes::Type centerZ = Lanes::Load(&boxes.centerZ[first]);
+			const Lanes::Type extentX = Lanes::Load(&boxes.extentX[first]);
+			const Lanes::Type extentY = Lanes::Load(&boxes.extentY[first]);
+			const Lanes::Type extentZ = Lanes::Load(&boxes.extentZ[first]);
+
+			// A box is outside when even its corner farthest along a plane's normal is behind the plane
+			uint32_t outside = 0;
+			for (uint32_t i = 0; i < 6; ++i)
+			{
+				const float* plane = planes[i];
+				const Lanes::Type distance = Lanes::Add(Lanes::Add(Lanes::Mul(centerX, Lanes::Set(plane[0])), Lanes::Mul(centerY, Lanes::Set(plane[1]))),
+					Lanes::Add(Lanes::Mul(centerZ, Lanes::Set(plane[2])), Lanes::Set(plane[3])));
+				const Lanes::Type reach = Lanes::Add(Lanes::Add(Lanes::Mul(extentX, Lanes::Set(plane[0] < 0.0f ? -plane[0] : plane[0])),
+					Lanes::Mul(extentY, Lanes::Set(plane[1] < 0.0f ? -plane[1] : plane[1]))), Lanes::Mul(extentZ, Lanes::Set(plane[2] < 0.0f ? -plane[2] : plane[2])));
+				outside |= Lanes::LessMask(Lanes::Add(distance, reach), zero);
+			}
+
+			const uint32_t lanes = count - first < Lanes::COUNT ? count - first : Lanes::COUNT;
+			for (uint32_t lane = 0; lane < lanes; ++lane)
+			{
+				const uint8_t inside = (outside >> lane) & 1u ? 0 : 1;
+				visible[first + lane] = inside;
+				visibleCount += inside;
+			}
+		}
+		return visibleCount;
+	}
+
+	// The test as built in the including file
+	FrustumKernels::Set CompiledKernels()
+	{
+		return { Lanes::COUNT, &CullBoxes };
+	}
+}
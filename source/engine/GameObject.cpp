@@ -2,19 +2,20 @@
 #include "RenderComponent.h"
 #include "Camera.h"
 #include "ServiceLocator.h"
+#include "objectmanager/GameObjectManager.h"
 
 GameObject::~GameObject()
 {
-    for (auto it = m_components.begin(); it != m_components.end();)
+    for (auto& component : m_components)
     {
-        if (it->second != nullptr)
+        if (component != nullptr)
         {
-            it->second->SetOwner(nullptr);
-            delete it->second;
-            it->second = nullptr;
+            component->SetOwner(nullptr);
+            delete component;
+            component = nullptr;
         }
-        it = m_components.erase(it);
     }
+    m_signature.reset();
 
 }
 
@@ -24,7 +25,8 @@ void GameObject::Update()
 
     for (auto component : m_components)
     {
-        component.second->Update();
+        if (component != nullptr)
+            component->Update();
     }
 }
 
@@ -64,6 +66,12 @@ void GameObject::Render(Shader* shader)
     }
 }
 
+void GameObject::onComponentsChanged()
+{
+    if (!m_handle.IsNull())
+        SERVICE_LOCATOR.GetGameObjectManager()->MarkStructureChanged();
+}
+
 void GameObject::SetDead(bool isDead)
 {
     m_isAlive = !isDead;
@@ -1,13 +1,13 @@
 #include "pch.h"
 #include "headers.h"
 
-Geometry::Geometry() : m_VAO(0), m_VBO(0), m_IBO(0), m_UV(0), m_NORMALBUFFER(0), m_uvType(PLANAR)
+Geometry::Geometry() : m_uvType(PLANAR), m_VAO(0), m_VBO(0), m_IBO(0), m_uploaded(false), m_uploadedUVType(PLANAR)
 {
 	glDisable(GL_DEBUG_OUTPUT);
 	genBuffers();
 }
 
-Geometry::Geometry(const char* path) : m_VAO(0), m_VBO(0), m_IBO(0), m_UV(0), m_NORMALBUFFER(0), m_uvType(PLANAR)
+Geometry::Geometry(const char* path) : m_uvType(PLANAR), m_VAO(0), m_VBO(0), m_IBO(0), m_uploaded(false), m_uploadedUVType(PLANAR)
 {
 	glDisable(GL_DEBUG_OUTPUT);
 	if (!LoadGeometry(path))
@@ -23,80 +23,18 @@ Geometry::~Geometry()
 
 bool Geometry::LoadGeometry(const char* path)
 {
-	return ObjLoader::LoadObj(path, m_vertexData, m_normalData, m_uvInfo);
+	m_uploaded = false;
+	const bool loaded = ObjLoader::LoadObj(path, m_vertexData, m_normalData, m_uvInfo);
+	m_bounds = BoundingVolume::FromBox(m_vertexData.bounds_min, m_vertexData.bounds_max);
+	return loaded;
 }
 
-void Geometry::Bind(Shader* shader)
+void Geometry::Bind(Shader* shader, GLuint instanceBuffer)
 {
-	glBindVertexArray(m_VAO);
-
-	// Bind vertex position buffer
-	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-	glBufferData(GL_ARRAY_BUFFER, m_vertexData.vertex_buffer.size() * sizeof(glm::vec3), &m_vertexData.vertex_buffer[0], GL_STATIC_DRAW);
-	GLint positionLocation = shader->GetAttributeLocation("aPos");
-	if (positionLocation == -1)
-		std::cerr << "Geometry::Bind() - Position attribute not found" << std::endl;
-	glEnableVertexAttribArray(positionLocation);
-	glVertexAttribPointer(
-		positionLocation,
-		3,
-		GL_FLOAT,
-		GL_FALSE,
-		0,
-		(void*)0);
-
-	// Bind normal buffer
-	glBindBuffer(GL_ARRAY_BUFFER, m_NORMALBUFFER);
-	glBufferData(GL_ARRAY_BUFFER, m_normalData.vertex_normal_buffer.size() * sizeof(glm::vec3), &m_normalData.vertex_normal_buffer[0], GL_STATIC_DRAW);
-	GLint normalLocation = shader->GetAttributeLocation("aNormal");
-	if (normalLocation != -1)
-	{
-		glEnableVertexAttribArray(normalLocation);
-		glVertexAttribPointer(
-			normalLocation,
-			3,
-			GL_FLOAT,
-			GL_FALSE,
-			0,
-			(void*)0);
-	}
-	
-
-	GLint texCoordLocation = shader->GetAttributeLocation("aTexCoords");
-	if (texCoordLocation != -1)
-	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_UV); // Bind the buffer for UV coordinates
-		// Set the correct UV buffer based on the mapping type
-		switch (m_uvType)
-		{
-		case CYLINDRICAL:
-			glBufferData(GL_ARRAY_BUFFER, m_uvInfo.Cylindrical.size() * sizeof(glm::vec2), &m_uvInfo.Cylindrical[0], GL_STATIC_DRAW);
-			break;
-		case SPHERICAL:
-			glBufferData(GL_ARRAY_BUFFER, m_uvInfo.Spherical.size() * sizeof(glm::vec2), &m_uvInfo.Spherical[0], GL_STATIC_DRAW);
-			break;
-		case PLANAR:
-			glBufferData(GL_ARRAY_BUFFER, m_uvInfo.Planar.size() * sizeof(glm::vec2), &m_uvInfo.Planar[0], GL_STATIC_DRAW);
-			break;
-		case CUBE:
-			glBufferData(GL_ARRAY_BUFFER, m_uvInfo.Cube.size() * sizeof(glm::vec2), &m_uvInfo.Cube[0], GL_STATIC_DRAW);
-			break;
-		}
-
-		glEnableVertexAttribArray(texCoordLocation);
-		glVertexAttribPointer(
-			texCoordLocation,
-			2,
-			GL_FLOAT,
-			GL_FALSE,
-			sizeof(glm::vec2),
-			(void*)0);
-	}
-
-	// Bind index buffer
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_vertexData.index_buffer.size() * sizeof(unsigned int), &m_vertexData.index_buffer[0], GL_STATIC_DRAW);
+	if (!m_uploaded || m_uploadedUVType != m_uvType)
+		upload();
 
+	glBindVertexArray(findLayout(shader->GetVertexLayout(), instanceBuffer));
 }
 
 void Geometry::Unbind()
@@ -115,9 +53,14 @@ void Geometry::CleanUpBuffers()
 {
 	glDeleteBuffers(1, &m_VBO);
 	glDeleteBuffers(1, &m_IBO);
-	glDeleteBuffers(1, &m_UV);
-	glDeleteBuffers(1, &m_NORMALBUFFER);
+	// The first layout's vertex array is m_VAO
+	for (const Layout& layout : m_layouts)
+	{
+		if (layout.vao != m_VAO)
+			glDeleteVertexArrays(1, &layout.vao);
+	}
 	glDeleteVertexArrays(1, &m_VAO);
+	m_layouts.clear();
 }
 
 void Geometry::Render()
@@ -125,6 +68,11 @@ void Geometry::Render()
 	glDrawElements(GL_TRIANGLES, (GLsizei)m_vertexData.index_buffer.size(), GL_UNSIGNED_INT, nullptr);
 }
 
+void Geometry::RenderInstanced(uint32_t first, uint32_t count)
+{
+	glDrawElementsInstancedBaseInstance(GL_TRIANGLES, (GLsizei)m_vertexData.index_buffer.size(), GL_UNSIGNED_INT, nullptr, (GLsizei)count, first);
+}
+
 void Geometry::SetUVType(UV_TYPE type)
 {
 	m_uvType = type;
@@ -135,7 +83,118 @@ void Geometry::genBuffers()
 	glGenVertexArrays(1, &m_VAO);
 	glGenBuffers(1, &m_VBO);
 	glGenBuffers(1, &m_IBO);
-	glGenBuffers(1, &m_UV);
-	glGenBuffers(1, &m_NORMALBUFFER);
+}
+
+void Geometry::upload()
+{
+	const std::vector<glm::vec2>* texCoords = &m_uvInfo.Planar;
+	switch (m_uvType)
+	{
+	case CYLINDRICAL:
+		texCoords = &m_uvInfo.Cylindrical;
+		break;
+	case SPHERICAL:
+		texCoords = &m_uvInfo.Spherical;
+		break;
+	case PLANAR:
+		texCoords = &m_uvInfo.Planar;
+		break;
+	case CUBE:
+		texCoords = &m_uvInfo.Cube;
+		break;
+	}
+
+	const std::vector<glm::vec3>& positions = m_vertexData.vertex_buffer;
+	const std::vector<glm::vec3>& normals = m_normalData.vertex_normal_buffer;
+	std::vector<Vertex> vertices(positions.size());
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		vertices[i].position = positions[i];
+		vertices[i].normal = i < normals.size() ? normals[i] : glm::vec3(0.0f);
+		vertices[i].texCoords = i < texCoords->size() ? (*texCoords)[i] : glm::vec2(0.0f);
+	}
 
+	Renderer* renderer = SERVICE_LOCATOR.GetRenderer();
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+	if (m_uploaded)
+		glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
+	else
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	renderer->CountUpload(vertices.size() * sizeof(Vertex));
+
+	if (!m_uploaded)
+	{
+		// The vertex arrays keep the index buffer binding, it is bound when they are set up
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_vertexData.index_buffer.size() * sizeof(unsigned int), m_vertexData.index_buffer.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		renderer->CountUpload(m_vertexData.index_buffer.size() * sizeof(unsigned int));
+	}
+
+	m_uploaded = true;
+	m_uploadedUVType = m_uvType;
+}
+
+GLuint Geometry::findLayout(const Shader::VertexLayout& attributes, GLuint instanceBuffer)
+{
+	// Shaders without instance attributes share a vertex array whatever buffer is passed
+	if (attributes.instanceModel == -1 && attributes.instanceColor == -1)
+		instanceBuffer = 0;
+	for (const Layout& layout : m_layouts)
+	{
+		if (layout.attributes == attributes && layout.instanceBuffer == instanceBuffer)
+			return layout.vao;
+	}
+
+	GLuint vao = m_VAO;
+	if (!m_layouts.empty())
+		glGenVertexArrays(1, &vao);
+	m_layouts.push_back({ attributes, instanceBuffer, vao });
+
+	if (attributes.position == -1)
+		std::cerr << "Geometry::Bind() - Position attribute not found" << std::endl;
+
+	glBindVertexArray(vao);
+	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+	if (attributes.position != -1)
+	{
+		glEnableVertexAttribArray(attributes.position);
+		glVertexAttribPointer(attributes.position, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+	}
+	if (attributes.normal != -1)
+	{
+		glEnableVertexAttribArray(attributes.normal);
+		glVertexAttribPointer(attributes.normal, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+	}
+	if (attributes.texCoords != -1)
+	{
+		glEnableVertexAttribArray(attributes.texCoords);
+		glVertexAttribPointer(attributes.texCoords, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+	}
+
+	// Instance attributes advance once per instance, a matrix takes a location per column
+	if (instanceBuffer != 0)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+		if (attributes.instanceModel != -1)
+		{
+			for (GLuint column = 0; column < 4; ++column)
+			{
+				const GLuint location = attributes.instanceModel + column;
+				glEnableVertexAttribArray(location);
+				glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(offsetof(Instance, model) + column * sizeof(glm::vec4)));
+				glVertexAttribDivisor(location, 1);
+			}
+		}
+		if (attributes.instanceColor != -1)
+		{
+			glEnableVertexAttribArray(attributes.instanceColor);
+			glVertexAttribPointer(attributes.instanceColor, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, color));
+			glVertexAttribDivisor(attributes.instanceColor, 1);
+		}
+	}
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IBO);
+	return vao;
 }
\ No newline at end of file
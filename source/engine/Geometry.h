@@ -4,6 +4,14 @@ class Material;
 class Geometry
 {
 public:
+    // Per object data of an instanced draw, one entry of the instance buffer
+    struct Instance
+    {
+        glm::mat4 model;
+        glm::vec3 color;
+        float padding;
+    };
+
     Geometry();
     Geometry(const char* path);
     ~Geometry();
@@ -11,9 +19,11 @@ public:
     //@brief Load the geometry data from the OBJ file
     bool LoadGeometry(const char* path);
 
-    //@brief Bind the vertex data to the buffer
-	//@param material : Material to fetch shader attribute locations
-    void Bind(Shader* shader);
+    //@brief Binds the vertex array of the geometry for the attribute layout of a shader. The vertices are
+    // uploaded on the first bind and again only when the UV type changes
+	//@param shader : Shader to fetch the attribute locations from
+	//@param instanceBuffer : Buffer of Instance entries the instance attributes of the shader read from, if it has them
+    void Bind(Shader* shader, GLuint instanceBuffer = 0);
 
     //@brief Unbind the vertex data from the buffer
     void Unbind();
@@ -24,12 +34,24 @@ public:
     //@brief Render the geometry
     void Render();
 
+    //@brief Render instances of the geometry with a shader that reads instance attributes
+    //@param first : Entry of the instance buffer the first instance reads
+    //@param count : Instances to draw
+    void RenderInstanced(uint32_t first, uint32_t count);
+
     void SetUVType(UV_TYPE type);
 
     //--------------------------------
     //Getters
     //--------------------------------
     
+	//@brief Returns an id of the geometry, unique among the live ones
+	//@return GLuint : Name of its vertex array
+	GLuint GetId() const { return m_VAO; }
+
+	//@brief Returns the box and sphere around the vertices, in local space
+	const BoundingVolume& GetBoundingVolume() const { return m_bounds; }
+
 	//@brief Returns uv type as int
 	//@return UV_TYPE : uv type
     UV_TYPE GetUVType()
@@ -38,17 +60,45 @@ public:
     }
 
 protected:
+    // One vertex of the interleaved buffer
+    struct Vertex
+    {
+        glm::vec3 position;
+        glm::vec3 normal;
+        glm::vec2 texCoords;
+    };
+
+    // Vertex array set up for the attribute locations of the shaders that share them
+    struct Layout
+    {
+        Shader::VertexLayout attributes;
+        GLuint instanceBuffer;
+        GLuint vao;
+    };
+
     UV_TYPE m_uvType;
-    GLuint m_VAO;
+    GLuint m_VAO;       // vertex array of the first layout bound
     GLuint m_VBO;
     GLuint m_IBO;
-    GLuint m_UV;
-    GLuint m_NORMALBUFFER;
+    bool m_uploaded;
+    UV_TYPE m_uploadedUVType;
+    std::vector<Layout> m_layouts;
 
     VERTEX_DATA m_vertexData;
 	NORMAL_DATA m_normalData;
     UV_INFO m_uvInfo;
+    BoundingVolume m_bounds;
 
 	//@brief Generate buffers for the geometry on creation
     void genBuffers();
+
+    //@brief Interleaves the vertices with the texture coordinates of the UV type and uploads them,
+    // along with the indices the first time
+    void upload();
+
+    //@brief Returns the vertex array for the attribute locations of a shader, setting it up the first time
+    //@param attributes : Attribute locations of the shader
+    //@param instanceBuffer : Buffer the instance attributes read from
+    //@return GLuint : The vertex array
+    GLuint findLayout(const Shader::VertexLayout& attributes, GLuint instanceBuffer);
 };
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "pch.h"
 #include "resourcemanager/ResourceManager.h"
 
-Material::Material() : m_pDiffuse(nullptr), m_pShader(nullptr), m_pSpecular(nullptr)
+Material::Material() : m_pDiffuse(nullptr), m_pShader(nullptr), m_pSpecular(nullptr), m_id(s_nextId++)
 {
 	//Set shader as default shader
 	ServiceLocator* serviceLocator = &SERVICE_LOCATOR;
@@ -10,7 +10,7 @@ Material::Material() : m_pDiffuse(nullptr), m_pShader(nullptr), m_pSpecular(null
 	m_data.shininess = 0.f;
 }
 
-Material::Material(Shader* pShader) : m_pDiffuse(nullptr), m_pShader(nullptr), m_pSpecular(nullptr)
+Material::Material(Shader* pShader) : m_pDiffuse(nullptr), m_pShader(nullptr), m_pSpecular(nullptr), m_id(s_nextId++)
 {
 	m_pShader = pShader;
 	m_data.color = glm::vec3(1.0f);
@@ -34,6 +34,7 @@ void Material::SetShader(const std::string name)
 void Material::SetTextureDiffuse(Texture* texture)
 {
 	m_pDiffuse = texture;
+	m_dirty = true;
 
 	glm::vec3* dataDiff;
 
@@ -55,6 +56,7 @@ void Material::SetTextureDiffuse(Texture* texture)
 void Material::SetTextureSpecular(Texture* texture)
 {
 	m_pSpecular = texture;
+	m_dirty = true;
 
 	glm::vec3* dataSpec;
 
@@ -76,26 +78,36 @@ void Material::SetTextureSpecular(Texture* texture)
 void Material::SetColor(glm::vec3 color)
 {
 	m_data.color = color;
+	m_dirty = true;
 }
 
 void Material::SetColor(float r, float g, float b)
 {
 	m_data.color = glm::vec3(r, g, b);
+	m_dirty = true;
 }
 
 
 void Material::SetShininess(float shininess)
 {
 	m_data.shininess = shininess;
+	m_dirty = true;
 }
 
 //This may be updated for general use of the custom shader
 void Material::SetupUniformData()
 {
-	m_pShader->SetUniform("material.color", m_data.color);
-	m_pShader->SetUniform("material.shininess", m_data.shininess);
-	m_pShader->SetUniform("hasDiffuse", m_pDiffuse != nullptr);
-	m_pShader->SetUniform("hasSpecular", m_pSpecular != nullptr);
+	if (m_dirty)
+	{
+		MaterialBlock block{};
+		block.color = m_data.color;
+		block.shininess = m_data.shininess;
+		block.hasDiffuse = m_pDiffuse != nullptr;
+		block.hasSpecular = m_pSpecular != nullptr;
+		m_uniformBuffer.Update(&block, sizeof(block));
+		m_dirty = false;
+	}
+	m_uniformBuffer.Bind(UniformBlock::MATERIAL);
 }
 
 void Material::Bind()
@@ -53,7 +53,7 @@ public:
 	//Render control
 	//--------------------------------
 
-	//@brief passes the material data to the shader
+	//@brief binds the material block, uploading it first if the material changed since the last upload
 	void SetupUniformData();
 
 	//@brief binds the texture set before
@@ -72,6 +72,10 @@ public:
 	//@brief returns the shininess of the current material
 	float GetShininess() const { return m_data.shininess; }
 
+	//@brief returns an id of the material, unique among the materials created
+	//@return uint32_t the id of the material
+	uint32_t GetId() const { return m_id; }
+
 	//@brief returns the shader of the current material
 	//@return Shader* the shader of the current material
 	Shader* GetShader() { return m_pShader; }
@@ -80,7 +84,12 @@ public:
 	//@return glm::vec3 the color of the current material
 	glm::vec3 GetColor() { return m_data.color; }
 private:
+	static inline std::atomic<uint32_t> s_nextId{ 1 };
+
 	MaterialData m_data;
+	uint32_t m_id;
+	UniformBuffer m_uniformBuffer;
+	bool m_dirty = true;		// the uniform buffer is behind m_data or the textures
 	Shader* m_pShader;
 
 	//TODO: Should be removed after Texture Manager integration
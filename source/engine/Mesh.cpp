@@ -11,6 +11,8 @@ Mesh::Mesh(std::vector<MeshVertex> _vertices, std::vector<unsigned int> _indices
     transform.rotation = glm::rotate(glm::mat4(1.0f), 0.0f, glm::vec3(1.0f, 1.0f, 1.0f));
     transform.scale = glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, 1.0f, 1.0f));
 
+    if (!vertices.empty())
+        bounds = BoundingVolume::FromPoints(&vertices[0].position, vertices.size(), sizeof(MeshVertex));
     setupMesh();
 }
 
@@ -59,6 +61,7 @@ void Mesh::setupMesh()
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
         &indices[0], GL_STATIC_DRAW);
+    SERVICE_LOCATOR.GetRenderer()->CountUpload(vertices.size() * sizeof(MeshVertex) + indices.size() * sizeof(unsigned int));
 
     // vertex positions
     glEnableVertexAttribArray(0);
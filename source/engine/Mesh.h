@@ -29,8 +29,12 @@ public:
 	Mesh(std::vector<MeshVertex> _vertices, std::vector<unsigned int> _indices, std::vector<MeshTexture> _textures);
 	void Draw(Shader& shader, glm::mat4 projection, glm::mat4 view, glm::vec3 lightPos);
 
+	//@brief Returns the box and sphere around the vertices, in local space
+	const BoundingVolume& GetBoundingVolume() const { return bounds; }
+
 private:
 	unsigned int VAO, VBO, EBO;
+	BoundingVolume bounds;
 	void setupMesh();
 	void SetUpUniforms(Shader target, glm::mat4 projection, glm::mat4 view, glm::vec3 lightPos);
 };
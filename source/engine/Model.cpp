@@ -109,6 +109,8 @@ import.SetPropertyBool(AI_CONFIG_IMPORT_FBX_PRESERVE_PIVOTS, false);
     // I'm assuming it's handling memory correctly.
     origin = new ModelNode;
     processNode(scene->mRootNode, scene, origin);
+    for (size_t i = 0; i < meshes.size(); ++i)
+        bounds = i == 0 ? meshes[i].GetBoundingVolume() : bounds.Merge(meshes[i].GetBoundingVolume());
 
     // Loop through all animations in the given file
     for (unsigned int i = 0; i < scene->mNumAnimations; i++)
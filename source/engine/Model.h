@@ -25,12 +25,16 @@ public:
 	void Draw(Shader& shader, glm::mat4 projection, glm::mat4 view, glm::vec3 lightPos);
 	void DrawSkeleton(glm::mat4 projection, glm::mat4 view, ModelNode* node, glm::mat4 parentTransform = glm::mat4(1.0f));
 	void Update(float deltaTime);
+
+	//@brief Returns the box and sphere around the vertices of every mesh, in local space
+	const BoundingVolume& GetBoundingVolume() const { return bounds; }
 	ModelNode* origin;
 	const aiScene* scene;
 	bool hasAnimation = false;
 	std::map<std::string, Bone> boneMap;
 private:
 	std::vector<Mesh> meshes;
+	BoundingVolume bounds;
 	std::string directory;
 	std::vector<MeshTexture> textures_loaded;
 	//RenderComponent* sphere;
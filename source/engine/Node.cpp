@@ -4,8 +4,8 @@
 
 Node::Node() : m_pParent(nullptr), m_needsDeletion(false), m_id(-1), m_name("")
 {
+	m_components.fill(nullptr);
 	m_pTransform = std::unique_ptr<Transform>(new Transform());
-	GetWorldTransform();
 	// Add a transform component to the node as a default component
 	AddComponent<TransformComponent>();
 }
@@ -28,10 +28,12 @@ void Node::AddChild(Node* node)
 	SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene()->RemoveNode(node);
 	node->m_pParent = this;
 	node->SetID(m_children.size());
+	TransformStorage& transforms = Transform::GetStorage();
+	transforms.dirty[transforms.Index(node->GetTransform()->GetHandle())] |= TransformStorage::STALE_WORLD;
 	m_children.push_back(node);
 
-	// Initialize the child node's transform to fit the parent node
-	node->GetWorldTransform();
+	// The child's world matrix is rebuilt from the parent's on the next world transform pass
+	SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene()->MarkHierarchyChanged();
 }
 
 void Node::RemoveChild(Node* node)
@@ -50,6 +52,7 @@ void Node::RemoveChild(Node* node)
 		m_children.pop_back();
 		m_children[index]->SetID(index);
 	}
+	SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene()->MarkHierarchyChanged();
 }
 
 void Node::SetID(size_t id)
@@ -68,11 +71,40 @@ void Node::Flush()
 		delete this;
 }
 
+const glm::mat4 Node::GetWorldTransform() const
+{
+	const TransformStorage& transforms = Transform::GetStorage();
+	const uint32_t index = transforms.Index(m_pTransform->GetHandle());
+	if (!isWorldStale())
+		return transforms.world[index];
+
+	// Scripts and physics read it before the frame's world transform pass
+	const glm::mat4 model = transforms.ReadModel(index);
+	return m_pParent ? m_pParent->GetWorldTransform() * model : model;
+}
+
+bool Node::isWorldStale() const
+{
+	const TransformStorage& transforms = Transform::GetStorage();
+	for (const Node* node = this; node; node = node->m_pParent)
+	{
+		if (transforms.dirty[transforms.Index(node->GetTransform()->GetHandle())] & TransformStorage::STALE_WORLD)
+			return true;
+	}
+	return false;
+}
+
 void Node::SetName(std::string name)
 {
 	m_name = name;
 }
 
+ScenePools* Node::currentPools()
+{
+	Scene* scene = SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene();
+	return scene ? &scene->GetPools() : nullptr;
+}
+
 void Node::setOwner(Component* sub)
 {
 	sub->SetOwner(this);
@@ -81,4 +113,38 @@ void Node::setOwner(Component* sub)
 void Node::initComponent(Component* sub)
 {
 	sub->Init();
+}
+
+Component* Node::attachComponent(size_t id, Component* sub)
+{
+	// replace the component of the same type instead of leaking it
+	delete detachComponent(id);
+
+	m_components[id] = sub;
+	m_signature.set(id);
+	setOwner(sub);
+	initComponent(sub);
+	onComponentsChanged();
+	return sub;
+}
+
+Component* Node::detachComponent(size_t id)
+{
+	Component* sub = m_components[id];
+	m_components[id] = nullptr;
+	m_signature.reset(id);
+	if (sub)
+		onComponentsChanged();
+	return sub;
+}
+
+const std::vector<std::pair<std::string_view, Component*>> Node::GetComponents() const
+{
+	std::vector<std::pair<std::string_view, Component*>> components;
+	for (size_t id = 0; id < ComponentRegistry::GetCount(); ++id)
+	{
+		if (m_signature.test(id))
+			components.emplace_back(ComponentRegistry::GetName(id), m_components[id]);
+	}
+	return components;
 }
\ No newline at end of file
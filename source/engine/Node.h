@@ -1,7 +1,7 @@
 #pragma once
 class Component;
 
-class Node
+class Node : public PooledObject
 {
 public:
 	Node();
@@ -42,35 +42,19 @@ public:
 	template <typename DataType>
 	typename std::enable_if_t<std::is_base_of<Component, DataType>::value, DataType*> AddComponent()
 	{
-		std::string dataType = Utils::GetClassName<DataType>();
-		// assign new component
-		m_components[dataType] = new DataType();
-		setOwner(m_components[dataType]);
-		initComponent(m_components[dataType]);
-		return static_cast<DataType*>(m_components[dataType]);
+		return static_cast<DataType*>(attachComponent(ComponentRegistry::GetID<DataType>(), createComponent<DataType>()));
 	}
 
 	template <typename DataType, typename... Args>
 	typename std::enable_if_t<std::is_base_of<Component, DataType>::value, DataType*> AddComponent(Args&&... args) {
-		std::string dataType = Utils::GetClassName<DataType>();
-		// assign new component
-		m_components[dataType] = new DataType(std::forward<Args>(args)...);
-		setOwner(m_components[dataType]);
-		initComponent(m_components[dataType]);
-		return static_cast<DataType*>(m_components[dataType]);
+		return static_cast<DataType*>(attachComponent(ComponentRegistry::GetID<DataType>(), createComponent<DataType>(std::forward<Args>(args)...)));
 	}
 
 	//@brief Remove a component from the current object
 	template <typename DataType>
 	typename std::enable_if_t<std::is_base_of<Component, DataType>::value, void*> RemoveComponent()
 	{
-		std::string dataType = Utils::GetClassName<DataType>();
-
-		auto del = m_components[dataType];
-		m_components.erase(dataType);
-		delete del;
-		del = nullptr;
-
+		delete detachComponent(ComponentRegistry::GetID<DataType>());
 		return nullptr;
 	}
 
@@ -78,20 +62,15 @@ public:
 	template <typename DataType>
 	inline const typename std::enable_if_t<std::is_base_of<Component, DataType>::value, DataType*> GetComponent()
 	{
-		std::string dataType = Utils::GetClassName<DataType>();
-		// check if the current GameObject has the component of DataType
-		if (m_components.find(dataType) != m_components.end())
-			return static_cast<DataType*>(m_components[dataType]);
-
-		return nullptr;
+		// empty slots hold nullptr, so a missing component needs no extra check
+		return static_cast<DataType*>(m_components[ComponentRegistry::GetID<DataType>()]);
 	}
 
 	//@brief Check if the current object has a component
 	template <typename DataType>
 	inline const typename std::enable_if_t<std::is_base_of<Component, DataType>::value, bool> HasComponent()
 	{
-		std::string dataType = Utils::GetClassName<DataType>();
-		return m_components.find(dataType) != m_components.end();
+		return m_signature.test(ComponentRegistry::GetID<DataType>());
 	}
 
 	//--------------------------------
@@ -106,14 +85,10 @@ public:
 	//@return Transform* : Transform component
 	inline Transform* GetTransform() const { return m_pTransform.get(); }
 
-	//@brief Returns the world transform matrix
+	//@brief Returns the world transform matrix. The one cached by the scene's world transform pass is
+	// returned unless the node or one of its parents moved since, then it is composed up the parent chain
 	//@return glm::mat4 : World transform matrix
-	inline const glm::mat4 GetWorldTransform()
-	{
-		glm::mat4 parentTransform = (m_pParent == nullptr) ? glm::mat4(1.f) : m_pParent->GetWorldTransform();
-		m_worldTransform = parentTransform * m_pTransform->GetModel();
-		return m_worldTransform;
-	}
+	const glm::mat4 GetWorldTransform() const;
 
 
 	//@brief Returns the parent node
@@ -121,8 +96,8 @@ public:
 	inline Node* GetParent() const { return m_pParent; }
 
 	//@brief Returns the children nodes
-	//@return std::unordered_map<int, Node*> : Children nodes
-	inline std::vector<Node*> GetChildren() const { return m_children; }
+	//@return std::vector<Node*> : Children nodes
+	inline const std::vector<Node*>& GetChildren() const { return m_children; }
 
 	//@brief Returns whether the node needs to be deleted
 	const bool NeedsDeletion() const { return m_needsDeletion; }
@@ -131,24 +106,50 @@ public:
 	//@return std::string : object name
 	const std::string GetName() const { return m_name; }
 
-	//@brief Get the current object components
-	//@return std::unordered_map<std::string, Component*> : object components
-	const std::unordered_map<std::string, Component*> GetComponents() const { return m_components; }
+	//@brief Get the current object components paired with their class names (serialization only)
+	//@return std::vector<std::pair<std::string_view, Component*>> : object components
+	const std::vector<std::pair<std::string_view, Component*>> GetComponents() const;
+
+	//@brief Get the set of component types attached to the current object
+	//@return ComponentRegistry::Signature : one bit per attached component type
+	inline const ComponentRegistry::Signature& GetSignature() const { return m_signature; }
 protected:
 	//ID for node entity control
 	size_t m_id;
 	std::string m_name;
 	std::unique_ptr<Transform> m_pTransform;
 	Node* m_pParent;
-	glm::mat4 m_worldTransform;
-	std::unordered_map<std::string, Component*> m_components;
+	// One slot per registered component type, indexed by ComponentRegistry ID
+	std::array<Component*, ComponentRegistry::MAX_COMPONENTS> m_components;
+	ComponentRegistry::Signature m_signature;
 	std::vector<Node*> m_children;
 	bool m_needsDeletion;
+
+	// @brief Called after a component was attached or detached
+	virtual void onComponentsChanged() {}
+
+	// @brief Returns whether the cached world matrix is out of date, the node or a parent having moved
+	bool isWorldStale() const;
 	
 private:
+	// @brief Create the component in the current scene's pool, or on the heap when no scene is loaded
+	template <typename DataType, typename... Args>
+	static DataType* createComponent(Args&&... args)
+	{
+		ScenePools* pools = currentPools();
+		if (pools)
+			return new (pools->Get<DataType>()) DataType(std::forward<Args>(args)...);
+		return new DataType(std::forward<Args>(args)...);
+	}
+	// @brief Returns the pools of the current scene, nullptr when no scene is loaded
+	static ScenePools* currentPools();
 	// @brief Set the owner of the component when added
 	void setOwner(Component* sub);
 	// @brief Initialize the component when added
 	void initComponent(Component* sub);
+	// @brief Store the component in its slot, replacing any previous component of the same type
+	Component* attachComponent(size_t id, Component* sub);
+	// @brief Clear the component slot and return the component that was stored there
+	Component* detachComponent(size_t id);
 };
 
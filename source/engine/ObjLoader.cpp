@@ -53,11 +53,11 @@ bool ObjLoader::LoadObj(const char* path, VERTEX_DATA& vertexData, NORMAL_DATA&
     }
 
     // Center the model and normalize its size
-    pos_max = (pos_max + pos_min) / 2.f;
+    glm::vec3 pos_center = (pos_max + pos_min) / 2.f;
     float ABSMax = -std::numeric_limits<float>::max();
     for (glm::vec3& vertex : vertexData.vertex_buffer) 
     {
-        vertex -= pos_max;  // Centering the model
+        vertex -= pos_center;  // Centering the model
         ABSMax = std::max(ABSMax, std::max({ std::abs(vertex.x), std::abs(vertex.y), std::abs(vertex.z) }));
     }
 
@@ -65,6 +65,19 @@ bool ObjLoader::LoadObj(const char* path, VERTEX_DATA& vertexData, NORMAL_DATA&
         for (glm::vec3& vertex : vertexData.vertex_buffer)
             vertex /= ABSMax;  // Normalizing the size
 
+    // The bounds go through the same centering and scaling as the vertices
+    if (vertexData.vertex_buffer.empty())
+    {
+        vertexData.bounds_min = glm::vec3(0.f);
+        vertexData.bounds_max = glm::vec3(0.f);
+    }
+    else
+    {
+        const float scale = ABSMax != 0 ? 1.f / ABSMax : 1.f;
+        vertexData.bounds_min = (pos_min - pos_center) * scale;
+        vertexData.bounds_max = (pos_max - pos_center) * scale;
+    }
+
     // Compute vertex normals
 	findFaceNormal(vertexData, normalData);
     findVertexNormal(vertexData, normalData);
@@ -2,6 +2,7 @@
 #include "headers.h"
 #include "RenderComponent.h"
 #include "Model.h"
+#include "Camera.h"
 #include "scenemanager/SceneManager.h"
 
 static void PrintMatrix(const glm::mat4& mat) {
@@ -81,42 +82,38 @@ void RenderComponent::Render()
 
     Transform* transform = GetOwner()->GetTransform();
     Scene* scene = SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene();
-    glm::mat4 shadowMatrix = SERVICE_LOCATOR.GetGameObjectManager()->GetShadowMatrix(transform->GetProjection());
-    m_pMaterial->GetShader()->Use();
-    m_pGeometry->Bind(m_pMaterial->GetShader());
 
-    if (SERVICE_LOCATOR.GetUI()->GetState("Debug Options", "Normals", IMGUI_ELEMENT_TYPE::DROPDOWN_TOGGLE))
-        m_pMaterial->GetShader()->SetUniform("DebugNormal", 1);
-    else
-        m_pMaterial->GetShader()->SetUniform("DebugNormal", 0);
-
-    m_pMaterial->GetShader()->SetUniform("model", GetOwner()->GetWorldTransform());
-    m_pMaterial->GetShader()->SetUniform("view", transform->GetView());
-    m_pMaterial->GetShader()->SetUniform("projection", transform->GetProjection());
-    m_pMaterial->GetShader()->SetUniform("localModel", transform->GetModel());
-    m_pMaterial->GetShader()->SetUniform("light.position", scene->lightPosition);
-    m_pMaterial->GetShader()->SetUniform("light.ambient", scene->lightAmbient);
-    m_pMaterial->GetShader()->SetUniform("light.diffuse", scene->lightDiffuse);
-    m_pMaterial->GetShader()->SetUniform("light.specular", scene->lightSpecular);
-    m_pMaterial->GetShader()->SetUniform("textureType", m_pGeometry->GetUVType());
-    m_pMaterial->GetShader()->SetUniform("shadowMatrix", shadowMatrix);
-    m_pMaterial->GetShader()->SetUniform("lightSpaceMatrix", scene->lightSpaceMatrix);
+    // Uploaded only when it differs from what the last object set, so every object of a frame after the first costs a compare
+    FrameUniforms frame;
+    frame.view = transform->GetView();
+    frame.projection = transform->GetProjection();
+    frame.shadowMatrix = SERVICE_LOCATOR.GetGameObjectManager()->GetShadowMatrix(transform->GetProjection());
+    frame.lightSpaceMatrix = scene->lightSpaceMatrix;
+    frame.lightPosition = scene->lightPosition;
+    frame.lightAmbient = scene->lightAmbient;
+    frame.lightDiffuse = scene->lightDiffuse;
+    frame.lightSpecular = scene->lightSpecular;
+    frame.debugNormals = SERVICE_LOCATOR.GetUI()->GetState("Debug Options", "Normals", IMGUI_ELEMENT_TYPE::DROPDOWN_TOGGLE);
+    SERVICE_LOCATOR.GetRenderer()->GetBackend().BeginFrame(frame);
+
+    Shader* shader = m_pMaterial->GetShader();
+    shader->Use();
+    m_pGeometry->Bind(shader);
+    shader->SetUniform(shader->GetDrawUniforms().model, GetOwner()->GetWorldTransform());
+    shader->SetUniform(shader->GetDrawUniforms().localModel, transform->GetModel());
 
     m_pMaterial->SetupUniformData();
 
 
     m_pMaterial->Bind();
-    glActiveTexture(GL_TEXTURE2);
+    glActiveTexture(GL_TEXTURE0 + static_cast<GLint>(TextureUnit::SHADOW));
     glBindTexture(GL_TEXTURE_2D, scene->depthMap);
 	m_pGeometry->Render();
     m_pGeometry->Unbind();
     m_pMaterial->Unbind();
     m_pMaterial->GetShader()->Unuse();
 
-    if (SERVICE_LOCATOR.GetUI()->GetState("Debug Options", "Colliders", IMGUI_ELEMENT_TYPE::DROPDOWN_TOGGLE))
-        DrawCollider();
-    if (SERVICE_LOCATOR.GetUI()->GetState("Debug Options", "Velocities", IMGUI_ELEMENT_TYPE::DROPDOWN_TOGGLE))
-        DrawVelocity();
+    DrawDebug();
 }
 
 void RenderComponent::Render(Shader* shader)
@@ -127,7 +124,7 @@ void RenderComponent::Render(Shader* shader)
     //shader->Use();
     m_pGeometry->Bind(shader);
 
-    shader->SetUniform("model", GetOwner()->GetWorldTransform());
+    shader->SetUniform(shader->GetDrawUniforms().model, GetOwner()->GetWorldTransform());
 
     //m_pMaterial->Bind();
     m_pGeometry->Render();
@@ -137,6 +134,43 @@ void RenderComponent::Render(Shader* shader)
 
 }
 
+void RenderComponent::Queue(RenderQueue& queue, Shader* shadowShader, const glm::mat4& view, bool inShadow, bool inView)
+{
+    if (!m_pMaterial || !m_pGeometry)
+    {
+        std::cerr << "RenderComponent::Queue() - Material or Geometry not set" << std::endl;
+        return;
+    }
+
+    // Scripts and the debug draws still read the camera from the transform
+    Transform* transform = GetOwner()->GetTransform();
+    transform->SetProjection(Camera::GetInstance()->m_worldProjection);
+    transform->SetView(Camera::GetInstance()->m_worldView);
+
+    const uint32_t handle = transform->GetHandle();
+    const GLuint geometry = m_pGeometry->GetId();
+    if (inShadow)
+    {
+        queue.Add({ RenderQueue::MakeKey(RenderPass::SHADOW, shadowShader->GetId(), 0, geometry, 0.0f),
+            shadowShader, nullptr, m_pGeometry, handle });
+    }
+    if (inView)
+    {
+        Shader* shader = m_pMaterial->GetShader();
+        const float depth = -(view * GetOwner()->GetWorldTransform()[3]).z;
+        queue.Add({ RenderQueue::MakeKey(RenderPass::MAIN, shader->GetId(), m_pMaterial->GetId(), geometry, depth),
+            shader, m_pMaterial, m_pGeometry, handle });
+    }
+}
+
+void RenderComponent::DrawDebug()
+{
+    if (SERVICE_LOCATOR.GetUI()->GetState("Debug Options", "Colliders", IMGUI_ELEMENT_TYPE::DROPDOWN_TOGGLE))
+        DrawCollider();
+    if (SERVICE_LOCATOR.GetUI()->GetState("Debug Options", "Velocities", IMGUI_ELEMENT_TYPE::DROPDOWN_TOGGLE))
+        DrawVelocity();
+}
+
 void RenderComponent::DrawCollider()
 {
     CollisionComponent* collision = GetOwner()->GetComponent<CollisionComponent>();
@@ -145,7 +179,7 @@ void RenderComponent::DrawCollider()
         CollisionShape* shape = collision->GetCollisionShape();
         ResourceManager* manager = SERVICE_LOCATOR.GetResourceManager();
         Shader* shader = manager->GetShader("Debug");
-        Geometry* geometry = manager->GetGeometry("Sphere");
+        Geometry* geometry = manager->GetGeometry(shape->GetType() == ShapeType::CUBOID ? "Cube" : "Sphere");
 
         glm::mat4 model = glm::mat4(1.0f);
 
@@ -157,15 +191,16 @@ void RenderComponent::DrawCollider()
         model = glm::rotate(model, rotation.y, glm::vec3(0.0f, 1.0f, 0.0f));
         model = glm::rotate(model, rotation.z, glm::vec3(0.0f, 0.0f, 1.0f));
 
-        if (dynamic_cast<CollisionShape_Cuboid*>(shape))
-        {
-            Geometry* geometry = manager->GetGeometry("Cube");
-            model = glm::scale(model, glm::vec3(dynamic_cast<CollisionShape_Cuboid*>(shape)->GetHalfWidth()));
-        }
-        if (dynamic_cast<CollisionShape_Sphere*>(shape))
+        switch (shape->GetType())
         {
-            glm::dvec3 scale = dynamic_cast<CollisionShape_Sphere*>(shape)->GetRadius();
-            model = glm::scale(model, glm::vec3(scale));
+        case ShapeType::CUBOID:
+            model = glm::scale(model, glm::vec3(static_cast<CollisionShape_Cuboid*>(shape)->GetHalfWidth()));
+            break;
+        case ShapeType::SPHERE:
+            model = glm::scale(model, glm::vec3(static_cast<CollisionShape_Sphere*>(shape)->GetRadius()));
+            break;
+        default:
+            break;
         }
 
         shader->Use();
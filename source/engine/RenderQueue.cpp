@@ -0,0 +1,436 @@
+#include "pch.h"
+#include "RenderQueue.h"
+#include "resourcemanager/ResourceManager.h"
+
+// ****** GLRenderBackend ****** //
+#pragma region GLRenderBackend
+GLRenderBackend::~GLRenderBackend()
+{
+	if (m_instanceBuffer != 0)
+		glDeleteBuffers(1, &m_instanceBuffer);
+}
+
+void GLRenderBackend::BeginFrame(const FrameUniforms& frame)
+{
+	FrameBlock frameBlock{};
+	frameBlock.view = frame.view;
+	frameBlock.projection = frame.projection;
+	frameBlock.shadowMatrix = frame.shadowMatrix;
+	frameBlock.lightSpaceMatrix = frame.lightSpaceMatrix;
+	frameBlock.flags = glm::ivec4(frame.debugNormals ? 1 : 0, 0, 0, 0);
+
+	LightBlock lightBlock{};
+	lightBlock.position = glm::vec4(frame.lightPosition, 1.0f);
+	lightBlock.ambient = glm::vec4(frame.lightAmbient, 0.0f);
+	lightBlock.diffuse = glm::vec4(frame.lightDiffuse, 0.0f);
+	lightBlock.specular = glm::vec4(frame.lightSpecular, 0.0f);
+
+	// Both blocks are plain bytes, a frame that sets what is already uploaded skips the upload
+	if (!m_uploaded || std::memcmp(&frameBlock, &m_frameBlock, sizeof(FrameBlock)) != 0)
+	{
+		m_frameBlock = frameBlock;
+		m_frameBuffer.Update(&m_frameBlock, sizeof(FrameBlock));
+	}
+	if (!m_uploaded || std::memcmp(&lightBlock, &m_lightBlock, sizeof(LightBlock)) != 0)
+	{
+		m_lightBlock = lightBlock;
+		m_lightBuffer.Update(&m_lightBlock, sizeof(LightBlock));
+	}
+	m_uploaded = true;
+	m_frameBuffer.Bind(UniformBlock::FRAME);
+	m_lightBuffer.Bind(UniformBlock::LIGHT);
+	m_shadowMap = frame.shadowMap;
+}
+
+void GLRenderBackend::BeginPass(RenderPass pass, std::span<const Geometry::Instance> instances)
+{
+	m_pass = pass;
+	m_instances = instances;
+	m_pShader = nullptr;
+	m_pMaterial = nullptr;
+	m_pGeometry = nullptr;
+
+	// The unit is the same for every shader, the map stays bound for the whole pass
+	if (pass == RenderPass::MAIN)
+	{
+		glActiveTexture(GL_TEXTURE0 + static_cast<GLint>(TextureUnit::SHADOW));
+		glBindTexture(GL_TEXTURE_2D, m_shadowMap);
+	}
+
+	// Every instance of the pass goes up at once, the instanced draws pick theirs with a base instance
+	if (instances.empty())
+		return;
+	if (m_instanceBuffer == 0)
+		glGenBuffers(1, &m_instanceBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+	glBufferData(GL_ARRAY_BUFFER, instances.size_bytes(), instances.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	SERVICE_LOCATOR.GetRenderer()->CountUpload(instances.size_bytes());
+}
+
+void GLRenderBackend::UseShader(Shader* shader, bool instanced)
+{
+	m_drawInstances = false;
+	if (instanced)
+	{
+		Shader* variant = shader->GetInstanced();
+		if (variant->IsInstanced())
+			shader = variant;
+		else
+			m_drawInstances = true;
+	}
+
+	// The frame and light uniforms are read from their blocks, nothing to set
+	m_pShader = shader;
+	m_pMaterial = nullptr;
+	m_pGeometry = nullptr;
+	shader->Use();
+}
+
+void GLRenderBackend::BindMaterial(Material* material)
+{
+	m_pMaterial = material;
+	material->SetupUniformData();
+	material->Bind();
+}
+
+void GLRenderBackend::BindGeometry(Geometry* geometry)
+{
+	m_pGeometry = geometry;
+	geometry->Bind(m_pShader, m_instanceBuffer);
+}
+
+void GLRenderBackend::Draw(const glm::mat4& world, const glm::mat4& model)
+{
+	const Shader::DrawUniforms& uniforms = m_pShader->GetDrawUniforms();
+	m_pShader->SetUniform(uniforms.model, world);
+	if (m_pass == RenderPass::MAIN)
+		m_pShader->SetUniform(uniforms.localModel, model);
+	m_pGeometry->Render();
+}
+
+void GLRenderBackend::DrawInstanced(uint32_t first, uint32_t count)
+{
+	if (!m_drawInstances)
+	{
+		m_pGeometry->RenderInstanced(first, count);
+		return;
+	}
+
+	const GLint modelUniform = m_pShader->GetDrawUniforms().model;
+	for (uint32_t i = first; i < first + count; ++i)
+	{
+		m_pShader->SetUniform(modelUniform, m_instances[i].model);
+		m_pGeometry->Render();
+	}
+}
+
+void GLRenderBackend::EndPass()
+{
+	if (m_pGeometry)
+		m_pGeometry->Unbind();
+	if (m_pMaterial)
+		m_pMaterial->Unbind();
+	if (m_pShader)
+		m_pShader->Unuse();
+	m_pShader = nullptr;
+	m_pMaterial = nullptr;
+	m_pGeometry = nullptr;
+	m_instances = {};
+}
+#pragma endregion
+
+// ****** RecordingRenderBackend ****** //
+#pragma region RecordingRenderBackend
+void RecordingRenderBackend::BeginFrame(const FrameUniforms& frame)
+{
+	m_commands.push_back({ CommandType::BEGIN_FRAME, m_pass, nullptr, glm::mat4(1.0f), 0 });
+	if (m_pForward)
+		m_pForward->BeginFrame(frame);
+}
+
+void RecordingRenderBackend::BeginPass(RenderPass pass, std::span<const Geometry::Instance> instances)
+{
+	m_pass = pass;
+	m_instances = instances;
+	m_commands.push_back({ CommandType::BEGIN_PASS, pass, nullptr, glm::mat4(1.0f), 0 });
+	if (m_pForward)
+		m_pForward->BeginPass(pass, instances);
+}
+
+void RecordingRenderBackend::UseShader(Shader* shader, bool instanced)
+{
+	m_commands.push_back({ CommandType::USE_SHADER, m_pass, shader, glm::mat4(1.0f), instanced ? 1u : 0u });
+	if (m_pForward)
+		m_pForward->UseShader(shader, instanced);
+}
+
+void RecordingRenderBackend::BindMaterial(Material* material)
+{
+	m_commands.push_back({ CommandType::BIND_MATERIAL, m_pass, material, glm::mat4(1.0f), 0 });
+	if (m_pForward)
+		m_pForward->BindMaterial(material);
+}
+
+void RecordingRenderBackend::BindGeometry(Geometry* geometry)
+{
+	m_commands.push_back({ CommandType::BIND_GEOMETRY, m_pass, geometry, glm::mat4(1.0f), 0 });
+	if (m_pForward)
+		m_pForward->BindGeometry(geometry);
+}
+
+void RecordingRenderBackend::Draw(const glm::mat4& world, const glm::mat4& model)
+{
+	m_commands.push_back({ CommandType::DRAW, m_pass, nullptr, world, 1 });
+	if (m_pForward)
+		m_pForward->Draw(world, model);
+}
+
+void RecordingRenderBackend::DrawInstanced(uint32_t first, uint32_t count)
+{
+	m_commands.push_back({ CommandType::DRAW_INSTANCED, m_pass, nullptr, m_instances[first].model, count });
+	if (m_pForward)
+		m_pForward->DrawInstanced(first, count);
+}
+
+void RecordingRenderBackend::EndPass()
+{
+	m_commands.push_back({ CommandType::END_PASS, m_pass, nullptr, glm::mat4(1.0f), 0 });
+	if (m_pForward)
+		m_pForward->EndPass();
+	m_instances = {};
+}
+#pragma endregion
+
+// ****** RenderQueue ****** //
+#pragma region RenderQueue
+uint64_t RenderQueue::MakeKey(RenderPass pass, uint32_t shader, uint32_t material, uint32_t geometry, float depth)
+{
+	// The bits of a positive float grow with its value, the top ones are enough to order by distance
+	uint32_t depthBits = 0;
+	if (depth > 0.0f)
+	{
+		std::memcpy(&depthBits, &depth, sizeof(depthBits));
+		depthBits >>= 31 - DEPTH_BITS;
+	}
+
+	// Ids past their field would share a key with another object's state and split its runs. Runs
+	// compare the pointers, so that only costs batching, but the fields are sized for every id in use
+	assert(shader < (1u << SHADER_BITS) && "Shader id does not fit the sort key, raise RenderQueue::SHADER_BITS");
+	assert(material < (1u << MATERIAL_BITS) && "Material id does not fit the sort key, raise RenderQueue::MATERIAL_BITS");
+	assert(geometry < (1u << GEOMETRY_BITS) && "Geometry id does not fit the sort key, raise RenderQueue::GEOMETRY_BITS");
+
+	uint64_t key = static_cast<uint64_t>(pass);
+	key = (key << SHADER_BITS) | (shader & ((1u << SHADER_BITS) - 1));
+	key = (key << MATERIAL_BITS) | (material & ((1u << MATERIAL_BITS) - 1));
+	key = (key << GEOMETRY_BITS) | (geometry & ((1u << GEOMETRY_BITS) - 1));
+	key = (key << DEPTH_BITS) | depthBits;
+	return key;
+}
+
+void RenderQueue::Clear()
+{
+	m_packets.clear();
+	m_stats = {};
+}
+
+void RenderQueue::Sort()
+{
+	m_stats.packets = static_cast<uint32_t>(m_packets.size());
+	if (m_packets.empty())
+		return;
+
+	// Least significant digit first, each pass stable. Digits every key shares are skipped, which
+	// in most frames leaves the depth and the geometry
+	constexpr uint64_t mask = (1u << RADIX_BITS) - 1;
+	uint64_t differing = 0;
+	for (const DrawPacket& packet : m_packets)
+		differing |= packet.key ^ m_packets[0].key;
+
+	m_sortBuffer.resize(m_packets.size());
+	for (uint32_t shift = 0; shift < 64; shift += RADIX_BITS)
+	{
+		if (((differing >> shift) & mask) == 0)
+			continue;
+
+		std::array<uint32_t, 1 << RADIX_BITS> offsets{};
+		for (const DrawPacket& packet : m_packets)
+			offsets[(packet.key >> shift) & mask]++;
+		uint32_t offset = 0;
+		for (uint32_t& count : offsets)
+		{
+			const uint32_t digitCount = count;
+			count = offset;
+			offset += digitCount;
+		}
+		for (const DrawPacket& packet : m_packets)
+			m_sortBuffer[offsets[(packet.key >> shift) & mask]++] = packet;
+		m_packets.swap(m_sortBuffer);
+	}
+}
+
+void RenderQueue::Submit(RenderPass pass, RenderBackend& backend)
+{
+	// Packets are sorted by pass first, the pass is one run of them
+	const uint64_t passKey = static_cast<uint64_t>(pass) << (SHADER_BITS + MATERIAL_BITS + GEOMETRY_BITS + DEPTH_BITS);
+	const uint64_t nextPassKey = (static_cast<uint64_t>(pass) + 1) << (SHADER_BITS + MATERIAL_BITS + GEOMETRY_BITS + DEPTH_BITS);
+	auto first = std::lower_bound(m_packets.begin(), m_packets.end(), passKey, [](const DrawPacket& packet, uint64_t key) { return packet.key < key; });
+	auto last = nextPassKey == 0 ? m_packets.end() :
+		std::lower_bound(first, m_packets.end(), nextPassKey, [](const DrawPacket& packet, uint64_t key) { return packet.key < key; });
+
+	// Packets sharing their state are next to each other in key order
+	auto runEnd = [last](std::vector<DrawPacket>::iterator run)
+	{
+		auto end = run + 1;
+		while (end != last && end->shader == run->shader && end->material == run->material && end->geometry == run->geometry)
+			++end;
+		return end;
+	};
+
+	// Only the runs drawn instanced go into the instances, in the order they are drawn
+	TransformStorage& transforms = Transform::GetStorage();
+	m_instances.clear();
+	for (auto run = first; run != last;)
+	{
+		auto end = runEnd(run);
+		const bool instancing = m_instancing && static_cast<uint32_t>(end - run) >= MIN_INSTANCES;
+		for (auto packet = run; packet != end; ++packet)
+		{
+			uint32_t t = transforms.Index(packet->transform);
+			transforms.Resolve(t);
+			if (instancing)
+				m_instances.push_back({ transforms.world[t], packet->material ? packet->material->GetColor() : glm::vec3(1.0f), 0.0f });
+		}
+		run = end;
+	}
+
+	backend.BeginPass(pass, m_instances);
+	uint32_t instance = 0;
+	Shader* shader = nullptr;
+	bool instanced = false;
+	Material* material = nullptr;
+	Geometry* geometry = nullptr;
+	uint32_t binds = 0;
+	uint32_t changes = 0;
+	for (auto run = first; run != last;)
+	{
+		auto end = runEnd(run);
+		const uint32_t count = static_cast<uint32_t>(end - run);
+		const bool instancing = m_instancing && count >= MIN_INSTANCES;
+
+		// Uniforms and attribute bindings belong to the program, so a new shader needs everything again.
+		// The instanced variant is a program of its own
+		if (run->shader != shader || instancing != instanced)
+		{
+			shader = run->shader;
+			instanced = instancing;
+			material = nullptr;
+			geometry = nullptr;
+			backend.UseShader(shader, instanced);
+			m_stats.shaderChanges++;
+			changes++;
+		}
+		if (run->material && run->material != material)
+		{
+			material = run->material;
+			backend.BindMaterial(material);
+			m_stats.materialChanges++;
+			changes++;
+		}
+		if (run->geometry != geometry)
+		{
+			geometry = run->geometry;
+			backend.BindGeometry(geometry);
+			m_stats.geometryChanges++;
+			changes++;
+		}
+
+		if (instancing)
+		{
+			backend.DrawInstanced(instance, count);
+			instance += count;
+			m_stats.draws++;
+			m_stats.instancedDraws++;
+			m_stats.instances += count;
+		}
+		else
+		{
+			for (auto packet = run; packet != end; ++packet)
+			{
+				uint32_t t = transforms.Index(packet->transform);
+				backend.Draw(transforms.world[t], transforms.model[t]);
+				m_stats.draws++;
+			}
+		}
+		// Drawn one at a time, every object binds its shader, material and geometry
+		binds += count * (run->material ? 3 : 2);
+		run = end;
+	}
+	backend.EndPass();
+
+	m_stats.changesAvoided += binds - changes;
+}
+
+void RenderQueue::BenchmarkInstancing(std::span<const uint32_t> counts)
+{
+	static constexpr uint32_t REPEATS = 20;
+	static constexpr uint32_t MATERIALS = 4;
+
+	// A stress scene: a few geometries, a few materials differing only in color, objects spread in front of the camera
+	ResourceManager* resources = SERVICE_LOCATOR.GetResourceManager();
+	Shader* shader = resources->GetShader("Default");
+	Shader* shadow = resources->GetShader("Shadow");
+	const std::array<Geometry*, 2> geometries = { resources->GetGeometry("Cube"), resources->GetGeometry("Sphere") };
+	std::vector<std::unique_ptr<Material>> materials;
+	for (uint32_t i = 0; i < MATERIALS; ++i)
+	{
+		materials.push_back(std::make_unique<Material>(shader));
+		materials.back()->SetColor(glm::vec3(static_cast<float>(i + 1) / MATERIALS, 0.5f, 0.5f));
+	}
+
+	printf("render queue instancing: %u materials, %zu geometries, both passes\n", MATERIALS, geometries.size());
+	printf("%10s %12s %12s %12s %12s %14s %14s\n", "objects", "draws", "inst. draws", "changes", "inst. changes", "submit us", "inst. submit us");
+	for (uint32_t count : counts)
+	{
+		std::mt19937 random(count);
+		std::uniform_real_distribution<float> place(-50.0f, 50.0f);
+		std::uniform_real_distribution<float> depth(1.0f, 100.0f);
+		std::vector<std::unique_ptr<Transform>> transforms;
+		RenderQueue queue;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			transforms.push_back(std::make_unique<Transform>());
+			transforms.back()->SetPosition(glm::vec3(place(random), place(random), -depth(random)));
+			Material* material = materials[i % MATERIALS].get();
+			Geometry* geometry = geometries[(i / MATERIALS) % geometries.size()];
+			const uint32_t handle = transforms.back()->GetHandle();
+			queue.Add({ MakeKey(RenderPass::SHADOW, shadow->GetId(), 0, geometry->GetId(), 0.0f), shadow, nullptr, geometry, handle });
+			queue.Add({ MakeKey(RenderPass::MAIN, shader->GetId(), material->GetId(), geometry->GetId(), depth(random)), shader, material, geometry, handle });
+		}
+		queue.Sort();
+
+		auto run = [&](bool instancing, Stats& stats)
+		{
+			RecordingRenderBackend backend;
+			queue.SetInstancing(instancing);
+			auto begin = std::chrono::high_resolution_clock::now();
+			for (uint32_t repeat = 0; repeat < REPEATS; ++repeat)
+			{
+				backend.Clear();
+				queue.m_stats = {};
+				backend.BeginFrame(FrameUniforms());
+				queue.Submit(RenderPass::SHADOW, backend);
+				queue.Submit(RenderPass::MAIN, backend);
+			}
+			const double us = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - begin).count();
+			stats = queue.m_stats;
+			return us / REPEATS;
+		};
+		Stats plain, instanced;
+		const double plainUs = run(false, plain);
+		const double instancedUs = run(true, instanced);
+		auto changes = [](const Stats& stats) { return stats.shaderChanges + stats.materialChanges + stats.geometryChanges; };
+		printf("%10u %12u %12u %12u %12u %14.1f %14.1f\n", count, plain.draws, instanced.draws, changes(plain), changes(instanced), plainUs, instancedUs);
+	}
+}
+#pragma endregion
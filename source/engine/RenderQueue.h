@@ -0,0 +1,227 @@
+#pragma once
+
+// Passes of a frame, in the order they are drawn
+enum class RenderPass : uint8_t
+{
+	SHADOW,		// Depth of every object from the light, into the shadow map
+	MAIN		// Lit objects from the camera
+};
+
+// Uniforms that are the same for every object of a frame, uploaded once per frame into the frame and light blocks
+struct FrameUniforms
+{
+	glm::mat4 view{ 1.0f };
+	glm::mat4 projection{ 1.0f };
+	glm::mat4 shadowMatrix{ 1.0f };
+	glm::mat4 lightSpaceMatrix{ 1.0f };
+	glm::vec3 lightPosition{ 0.0f };
+	glm::vec3 lightAmbient{ 0.0f };
+	glm::vec3 lightDiffuse{ 0.0f };
+	glm::vec3 lightSpecular{ 0.0f };
+	GLuint shadowMap = 0;
+	bool debugNormals = false;
+};
+
+// One object in one pass. Everything the submission needs is in the packet, the matrices are read
+// from the transform storage when it is drawn
+struct DrawPacket
+{
+	uint64_t key;				// see RenderQueue::MakeKey
+	Shader* shader;
+	Material* material;			// nullptr in the shadow pass, which only writes depth
+	Geometry* geometry;
+	uint32_t transform;			// Transform handle of the object
+};
+
+// Where the queue sends its state changes and draws. The GL backend issues them, the recording
+// backend keeps them so the stream can be checked
+class RenderBackend
+{
+public:
+	virtual ~RenderBackend() = default;
+
+	//@brief Sets the uniforms shared by every shader for the passes that follow
+	//@param frame : Uniforms shared by every object of the frame
+	virtual void BeginFrame(const FrameUniforms& frame) = 0;
+	//@brief Starts a pass, no shader, material or geometry is bound yet
+	//@param pass : The pass
+	//@param instances : Model matrix and color of every object the pass draws instanced, in the order of its instanced draws, valid until EndPass
+	virtual void BeginPass(RenderPass pass, std::span<const Geometry::Instance> instances) = 0;
+	//@brief Switches to a shader, which reads the frame uniforms from their blocks
+	//@param instanced : Whether to switch to its instanced variant
+	virtual void UseShader(Shader* shader, bool instanced) = 0;
+	//@brief Uploads the uniforms of a material and binds its textures to the current shader
+	virtual void BindMaterial(Material* material) = 0;
+	//@brief Binds the vertex data of a geometry to the current shader
+	virtual void BindGeometry(Geometry* geometry) = 0;
+	//@brief Draws the bound geometry
+	//@param world : World matrix of the object
+	//@param model : Local matrix of the object
+	virtual void Draw(const glm::mat4& world, const glm::mat4& model) = 0;
+	//@brief Draws the bound geometry once per instance, with the instanced variant of the shader
+	//@param first : First instance, indexing the instances of the pass
+	//@param count : Instances to draw
+	virtual void DrawInstanced(uint32_t first, uint32_t count) = 0;
+	//@brief Unbinds what the pass left bound
+	virtual void EndPass() = 0;
+};
+
+// Issues the stream through OpenGL
+class GLRenderBackend : public RenderBackend
+{
+public:
+	~GLRenderBackend();
+
+	void BeginFrame(const FrameUniforms& frame) override;
+	void BeginPass(RenderPass pass, std::span<const Geometry::Instance> instances) override;
+	void UseShader(Shader* shader, bool instanced) override;
+	void BindMaterial(Material* material) override;
+	void BindGeometry(Geometry* geometry) override;
+	void Draw(const glm::mat4& world, const glm::mat4& model) override;
+	void DrawInstanced(uint32_t first, uint32_t count) override;
+	void EndPass() override;
+
+private:
+	RenderPass m_pass = RenderPass::MAIN;
+	// The blocks last uploaded, a frame that sets the same values uploads nothing
+	UniformBuffer m_frameBuffer;
+	UniformBuffer m_lightBuffer;
+	FrameBlock m_frameBlock{};
+	LightBlock m_lightBlock{};
+	bool m_uploaded = false;
+	GLuint m_shadowMap = 0;
+	std::span<const Geometry::Instance> m_instances;
+	GLuint m_instanceBuffer = 0;
+	// A shader without an instanced variant draws its instances one at a time
+	bool m_drawInstances = false;
+	Shader* m_pShader = nullptr;
+	Material* m_pMaterial = nullptr;
+	Geometry* m_pGeometry = nullptr;
+};
+
+// Keeps the stream, to check what a frame submits. Without a backend to forward to it needs no GL context
+class RecordingRenderBackend : public RenderBackend
+{
+public:
+	//@brief Creates the backend
+	//@param forward : Backend that still draws the stream, nullptr to only record it
+	explicit RecordingRenderBackend(RenderBackend* forward = nullptr) : m_pForward(forward) {}
+
+	enum class CommandType : uint8_t
+	{
+		BEGIN_FRAME,
+		BEGIN_PASS,
+		USE_SHADER,
+		BIND_MATERIAL,
+		BIND_GEOMETRY,
+		DRAW,
+		DRAW_INSTANCED,
+		END_PASS,
+		COUNT
+	};
+
+	struct Command
+	{
+		CommandType type;
+		RenderPass pass;
+		const void* resource;		// shader, material or geometry bound, nullptr otherwise
+		glm::mat4 world;			// of DRAW commands, of the first instance for DRAW_INSTANCED
+		uint32_t count;				// instances drawn, 1 for USE_SHADER of an instanced variant
+	};
+
+	void BeginFrame(const FrameUniforms& frame) override;
+	void BeginPass(RenderPass pass, std::span<const Geometry::Instance> instances) override;
+	void UseShader(Shader* shader, bool instanced) override;
+	void BindMaterial(Material* material) override;
+	void BindGeometry(Geometry* geometry) override;
+	void Draw(const glm::mat4& world, const glm::mat4& model) override;
+	void DrawInstanced(uint32_t first, uint32_t count) override;
+	void EndPass() override;
+
+	//@brief Returns the commands recorded since the last Clear
+	inline const std::vector<Command>& GetCommands() const { return m_commands; }
+	//@brief Drops the recorded commands
+	inline void Clear() { m_commands.clear(); }
+
+private:
+	RenderBackend* m_pForward;
+	RenderPass m_pass = RenderPass::MAIN;
+	std::span<const Geometry::Instance> m_instances;
+	std::vector<Command> m_commands;
+};
+
+// Draw packets of a frame, sorted by a key that puts the pass first, then the shader, material and
+// geometry, then the depth, so objects sharing state are drawn together and front to back. Submitting
+// only binds what differs from the packet before, and a run of packets sharing all three is drawn
+// as one instanced draw
+class RenderQueue
+{
+public:
+	// Work done since the last Clear
+	struct Stats
+	{
+		uint32_t packets = 0;			// sorted, in every pass
+		uint32_t draws = 0;				// draw calls, an instanced one counts once
+		uint32_t instancedDraws = 0;
+		uint32_t instances = 0;			// objects drawn by the instanced draws
+		uint32_t shaderChanges = 0;
+		uint32_t materialChanges = 0;
+		uint32_t geometryChanges = 0;
+		uint32_t changesAvoided = 0;	// binds an object at a time would have made on top of these
+	};
+
+	//@brief Builds the sort key of a packet
+	//@param pass : Pass, the highest bits
+	//@param shader : Id of the shader, asserted to fit in 12 bits
+	//@param material : Id of the material, asserted to fit in 14 bits
+	//@param geometry : Id of the geometry, asserted to fit in 14 bits
+	//@param depth : Distance from the viewer, nearer first. Negative distances sort as 0
+	//@return uint64_t : The key
+	static uint64_t MakeKey(RenderPass pass, uint32_t shader, uint32_t material, uint32_t geometry, float depth);
+
+	//@brief Drops the packets and stats of the last frame
+	void Clear();
+
+	//@brief Queues a packet
+	inline void Add(const DrawPacket& packet) { m_packets.push_back(packet); }
+
+	//@brief Sorts the packets by key with a radix sort
+	void Sort();
+
+	//@brief Sends the sorted packets of a pass to a backend
+	//@param pass : Pass to submit
+	//@param backend : Backend to send the stream to, after its BeginFrame
+	void Submit(RenderPass pass, RenderBackend& backend);
+
+	//@brief Returns the work done since the last Clear
+	inline const Stats& GetStats() const { return m_stats; }
+
+	//@brief Sets whether runs of packets sharing their shader, material and geometry are drawn instanced
+	inline void SetInstancing(bool instancing) { m_instancing = instancing; }
+	//@brief Returns whether runs of packets are drawn instanced
+	inline bool GetInstancing() const { return m_instancing; }
+
+	//@brief Queues objects sharing a few geometries and materials, submits both passes to a recording backend
+	// with and without instancing, and prints the draw calls and state changes of each against the object count
+	//@param counts : Numbers of objects to queue
+	static void BenchmarkInstancing(std::span<const uint32_t> counts);
+
+	//@brief Returns the packets, sorted after Sort
+	inline std::span<const DrawPacket> GetPackets() const { return m_packets; }
+
+private:
+	static constexpr uint32_t DEPTH_BITS = 22;
+	static constexpr uint32_t GEOMETRY_BITS = 14;
+	static constexpr uint32_t MATERIAL_BITS = 14;
+	static constexpr uint32_t SHADER_BITS = 12;
+	// Bits sorted per radix pass
+	static constexpr uint32_t RADIX_BITS = 8;
+	// Shortest run of packets drawn instanced, a single object costs less as a plain draw
+	static constexpr uint32_t MIN_INSTANCES = 2;
+
+	std::vector<DrawPacket> m_packets;
+	std::vector<DrawPacket> m_sortBuffer;
+	std::vector<Geometry::Instance> m_instances;
+	bool m_instancing = true;
+	Stats m_stats;
+};
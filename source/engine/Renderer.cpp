@@ -23,6 +23,48 @@ void Renderer::Render()
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);  // Clear both color and depth buffers before rendering
 }
 
+uint32_t Renderer::Cull(RenderPass pass, const glm::mat4& viewProjection)
+{
+	const size_t index = static_cast<size_t>(pass);
+	const uint32_t visible = m_culler.Cull(Frustum(viewProjection), m_visible[index]);
+	m_cullStats[index] = { visible, m_culler.GetCount() - visible };
+	return visible;
+}
+
+RenderBackend& Renderer::GetBackend()
+{
+	if (m_capture)
+		return m_recording;
+	return m_backend;
+}
+
+void Renderer::EndFrame()
+{
+	m_lastBytesUploaded = m_bytesUploaded;
+	m_bytesUploaded = 0;
+	if (!m_capture)
+		return;
+	m_capture = false;
+
+	std::array<uint32_t, static_cast<size_t>(RecordingRenderBackend::CommandType::COUNT)> counts{};
+	for (const RecordingRenderBackend::Command& command : m_recording.GetCommands())
+		counts[static_cast<size_t>(command.type)]++;
+	const RenderQueue::Stats& stats = m_renderQueue.GetStats();
+	std::cout << "Captured frame: " << m_recording.GetCommands().size() << " commands, "
+		<< counts[static_cast<size_t>(RecordingRenderBackend::CommandType::BEGIN_PASS)] << " passes, "
+		<< counts[static_cast<size_t>(RecordingRenderBackend::CommandType::USE_SHADER)] << " shader binds, "
+		<< counts[static_cast<size_t>(RecordingRenderBackend::CommandType::BIND_MATERIAL)] << " material binds, "
+		<< counts[static_cast<size_t>(RecordingRenderBackend::CommandType::BIND_GEOMETRY)] << " geometry binds, "
+		<< counts[static_cast<size_t>(RecordingRenderBackend::CommandType::DRAW)] << " draws, "
+		<< counts[static_cast<size_t>(RecordingRenderBackend::CommandType::DRAW_INSTANCED)] << " instanced draws" << std::endl;
+	std::cout << "Render queue: " << stats.packets << " packets, " << stats.instances << " drawn instanced, "
+		<< stats.changesAvoided << " state changes avoided" << std::endl;
+	std::cout << "Uploaded: " << m_lastBytesUploaded << " bytes" << std::endl;
+	std::cout << "Culled: " << GetCullStats(RenderPass::SHADOW).culled << " of " << m_culler.GetCount() << " from the shadow map, "
+		<< GetCullStats(RenderPass::MAIN).culled << " of " << m_culler.GetCount() << " from the camera" << std::endl;
+	m_recording.Clear();
+}
+
 void Renderer::Shutdown()
 {
 	glDisable(GL_DEPTH_TEST);
@@ -13,7 +13,52 @@ public:
 	//@brief Shuts down the renderer
 	void Shutdown();
 
+	// Objects of the last frame a pass drew and skipped
+	struct CullStats
+	{
+		uint32_t visible = 0;
+		uint32_t culled = 0;
+	};
+
+	//@brief Returns the culler the scene adds the bounds of its objects to
+	inline FrustumCuller& GetCuller() { return m_culler; }
+	//@brief Tests the objects added to the culler against the frustum a pass draws
+	//@param pass : The pass
+	//@param viewProjection : Matrix of the pass into clip space
+	//@return uint32_t : Objects visible
+	uint32_t Cull(RenderPass pass, const glm::mat4& viewProjection);
+	//@brief Returns whether an object touches the frustum of a pass, as of its last Cull
+	//@param object : Index the culler returned for the object
+	inline bool IsVisible(RenderPass pass, uint32_t object) const { return m_visible[static_cast<size_t>(pass)][object] != 0; }
+	//@brief Returns the objects a pass drew and skipped
+	inline const CullStats& GetCullStats(RenderPass pass) const { return m_cullStats[static_cast<size_t>(pass)]; }
+
+	//@brief Returns the queue the scene sorts its draws into
+	inline RenderQueue& GetRenderQueue() { return m_renderQueue; }
+	//@brief Returns the backend the queue submits to, the recording one while a frame is captured
+	RenderBackend& GetBackend();
+	//@brief Records the commands of the next frame and prints them once it is drawn
+	inline void CaptureFrame() { m_capture = true; }
+	//@brief Adds to the bytes uploaded to the GPU this frame
+	//@param bytes : Size of the upload
+	inline void CountUpload(size_t bytes) { m_bytesUploaded += bytes; }
+	//@brief Returns the bytes uploaded to the GPU in the last frame
+	inline uint64_t GetBytesUploaded() const { return m_lastBytesUploaded; }
+
+	//@brief Ends the frame, printing the captured commands if it was captured
+	void EndFrame();
+
 private:
+	RenderQueue m_renderQueue;
+	FrustumCuller m_culler;
+	std::array<std::vector<uint8_t>, 2> m_visible;
+	std::array<CullStats, 2> m_cullStats;
+	GLRenderBackend m_backend;
+	RecordingRenderBackend m_recording{ &m_backend };
+	bool m_capture = false;
+	uint64_t m_bytesUploaded = 0;
+	uint64_t m_lastBytesUploaded = 0;
+
 	static Renderer* GetInstance();
 	static std::unique_ptr<Renderer> instance;
 
@@ -24,6 +24,10 @@ void sample::Init()
 	// Add more scenes here in order...
 	// Adding empty scene for testing
 	SERVICE_LOCATOR.GetSceneManager()->AddScene();
+	// Scene 2 is mostly static colliders, which sorted bounds handle better than the default tree
+	SERVICE_LOCATOR.GetSceneManager()->GetScene("scene_02")->SetBroadphase(BroadphaseType::SWEEP_AND_PRUNE);
+	// Scenes load from their compiled binaries, rebuilt here whenever a json changed
+	SERVICE_LOCATOR.GetSceneManager()->CompileScenes();
 	SERVICE_LOCATOR.GetAudioManager()->PlaySound("music\\dragon_soul.mp3");
 
 	Camera* cam = Camera::GetInstance();
@@ -70,17 +74,41 @@ void sample::Update()
 	const float speed = 19.0f;      // Controls the speed of wave propagation
 	if (SERVICE_LOCATOR.GetInput()->IsKeyJustPressed(GLFW_KEY_B))
 	{
-		glm::vec3 objPos = SERVICE_LOCATOR.GetGameObjectManager()->GetGameObject("GreenBunny")->GetComponent<TransformComponent>()->GetPosition();
-		SERVICE_LOCATOR.GetAudioManager()->PlaySound("sound_effects\\banana_bread.mp3", &objPos);
+		if (GameObject* bunny = SERVICE_LOCATOR.GetGameObjectManager()->GetGameObject("GreenBunny"))
+		{
+			glm::vec3 objPos = bunny->GetComponent<TransformComponent>()->GetPosition();
+			SERVICE_LOCATOR.GetAudioManager()->PlaySound("sound_effects\\banana_bread.mp3", &objPos);
+		}
+	}
+	// The load benchmark empties the current scene, so it only runs from the empty one
+	if (SERVICE_LOCATOR.GetInput()->IsKeyJustPressed(GLFW_KEY_L) &&
+		SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene()->GetName() == "EmptyScene")
+	{
+		static constexpr std::array<uint32_t, 4> counts = { 100, 1000, 5000, 10000 };
+		SERVICE_LOCATOR.GetGameObjectFactory()->BenchmarkLoad("SampleGame/scene_02.json", counts);
+	}
+	if (SERVICE_LOCATOR.GetInput()->IsKeyJustPressed(GLFW_KEY_K))
+	{
+		static constexpr std::array<uint32_t, 4> counts = { 100, 1000, 10000, 100000 };
+		SERVICE_LOCATOR.GetCollisionManager()->PrintFilterGroups();
+		SERVICE_LOCATOR.GetCollisionManager()->BenchmarkBroadphase(counts);
+		SERVICE_LOCATOR.GetCollisionManager()->BenchmarkNarrowphase(counts);
+		Narrowphase::BenchmarkPrecision(counts);
+		RenderQueue::BenchmarkInstancing(counts);
+		ContactSolver::TestImmovableBody();
 	}
+	// Prints the state changes and draws the next frame submits
+	if (SERVICE_LOCATOR.GetInput()->IsKeyJustPressed(GLFW_KEY_R))
+		SERVICE_LOCATOR.GetRenderer()->CaptureFrame();
 	if (SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene()->GetName() == "scene_03")
 	{
+		auto gameObjects = SERVICE_LOCATOR.GetGameObjectManager()->GetGameObjects();
 		for (unsigned int i = 0; i < 10; ++i)
 		{
 			for (unsigned int j = 0; j < 10; ++j)
 			{
 				float waveHeight = amplitude * std::sin(frequency * glfwGetTime() + speed * (i + j));
-				auto transform = SERVICE_LOCATOR.GetGameObjectManager()->GetGameObjects()[i * 10 + j]->GetComponent<TransformComponent>();
+				auto transform = gameObjects[i * 10 + j]->GetComponent<TransformComponent>();
 				transform->SetPosition(glm::vec3(i, waveHeight, j));
 			}
 		}
@@ -182,12 +182,19 @@ void ScriptComponent::ExposeClasses() {
 		"SetMass", &PhysicsComponent::SetMass,
 		"SetDrag", &PhysicsComponent::SetDrag,
 		"SetGravityMultiplyer", &PhysicsComponent::SetGravityMultiplyer,
+		"SetBounciness", &PhysicsComponent::SetBounciness,
+		"SetFriction", &PhysicsComponent::SetFriction,
 		"GetGrounded", &PhysicsComponent::Grounded,
+		"GetGroundNormal", &PhysicsComponent::GetGroundNormal,
+		"GetGroundVelocity", &PhysicsComponent::GetGroundVelocity,
+		"GetGroundSupport", &PhysicsComponent::GetGroundSupport,
 		"GetVelocity", &PhysicsComponent::GetVelocity,
 		"GetMass", &PhysicsComponent::GetMass,
 		"GetInverseMass", &PhysicsComponent::GetInverseMass,
 		"GetDrag", &PhysicsComponent::GetDrag,
-		"GetGravityMultiplyer", &PhysicsComponent::GetGravityMultiplyer
+		"GetGravityMultiplyer", &PhysicsComponent::GetGravityMultiplyer,
+		"GetBounciness", &PhysicsComponent::GetBounciness,
+		"GetFriction", &PhysicsComponent::GetFriction
 	);
 
 	// ControllerComponent
@@ -15,7 +15,8 @@ public:
 
 	void Init() override;
 	void Update(double deltaTime);
-	void Update() override { Update(1 / 60.0); }
+	// Scripts are ticked once a frame with the frame time by the ScriptManager
+	void Update() override {}
 	void Shutdown() override;
 
 	void LoadScript(std::string filepath);
@@ -72,7 +72,8 @@ ServiceLocator::ServiceLocator() :
 	mp_EventHandler(EventHandler::GetInstance()),
 	mp_CollisionManager(CollisionManager::GetInstance()),
 	mp_ScriptManager(ScriptManager::GetInstance()),
-	mp_AudioManager(AudioManager::GetInstance())
+	mp_AudioManager(AudioManager::GetInstance()),
+	mp_JobSystem(JobSystem::GetInstance())
 {}
 
 WindowHandler* ServiceLocator::GetWindowHandler() const
@@ -124,3 +125,8 @@ AudioManager* ServiceLocator::GetAudioManager() const
 {
 	return mp_AudioManager;
 }
+
+JobSystem* ServiceLocator::GetJobSystem() const
+{
+	return mp_JobSystem;
+}
@@ -1,9 +1,58 @@
 #include "pch.h"
 #include "ShaderLoader.h"
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath)
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath) :
+	Shader(vertexPath, fragmentPath, geometryPath, nullptr)
 {
-	m_id = ShaderLoader::Load(vertexPath, fragmentPath, geometryPath);
+}
+
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath, const char* defines) :
+	m_vertexPath(vertexPath), m_fragmentPath(fragmentPath), m_geometryPath(geometryPath ? geometryPath : "")
+{
+	m_id = ShaderLoader::Load(vertexPath, fragmentPath, geometryPath, defines);
+	m_vertexLayout.position = GetAttributeLocation("aPos");
+	m_vertexLayout.normal = GetAttributeLocation("aNormal");
+	m_vertexLayout.texCoords = GetAttributeLocation("aTexCoords");
+	m_vertexLayout.instanceModel = GetAttributeLocation("aInstanceModel");
+	m_vertexLayout.instanceColor = GetAttributeLocation("aInstanceColor");
+	m_drawUniforms.model = glGetUniformLocation(m_id, "model");
+	m_drawUniforms.localModel = glGetUniformLocation(m_id, "localModel");
+	bindSharedInputs();
+}
+
+Shader* Shader::GetInstanced()
+{
+	if (IsInstanced())
+		return this;
+	if (!m_pInstanced)
+		m_pInstanced.reset(new Shader(m_vertexPath.c_str(), m_fragmentPath.c_str(),
+			m_geometryPath.empty() ? nullptr : m_geometryPath.c_str(), "#define INSTANCED"));
+	return m_pInstanced.get();
+}
+
+void Shader::bindSharedInputs()
+{
+	static constexpr std::pair<const char*, UniformBlock> blocks[] = {
+		{ "Frame", UniformBlock::FRAME }, { "LightBlock", UniformBlock::LIGHT }, { "MaterialBlock", UniformBlock::MATERIAL } };
+	for (const auto& [name, block] : blocks)
+	{
+		const GLuint index = glGetUniformBlockIndex(m_id, name);
+		if (index != GL_INVALID_INDEX)
+			glUniformBlockBinding(m_id, index, static_cast<GLuint>(block));
+	}
+
+	// Samplers keep their unit in the program, so they are set once
+	static constexpr std::pair<const char*, TextureUnit> samplers[] = {
+		{ "diffuseMap", TextureUnit::DIFFUSE }, { "specularMap", TextureUnit::SPECULAR }, { "shadowMap", TextureUnit::SHADOW } };
+	glUseProgram(m_id);
+	for (const auto& [name, unit] : samplers)
+	{
+		const GLint location = glGetUniformLocation(m_id, name);
+		if (location != -1)
+			glUniform1i(location, static_cast<GLint>(unit));
+	}
+	glUseProgram(0);
+	Utils::GetGLError();
 }
 
 void Shader::Use()
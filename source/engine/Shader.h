@@ -4,6 +4,25 @@ class Shader
 {
 public:
 
+	// Locations of the vertex attributes, -1 for the ones the shader does not use
+	struct VertexLayout
+	{
+		GLint position = -1;		// aPos
+		GLint normal = -1;			// aNormal
+		GLint texCoords = -1;		// aTexCoords
+		GLint instanceModel = -1;	// aInstanceModel, four locations from this one
+		GLint instanceColor = -1;	// aInstanceColor
+
+		bool operator==(const VertexLayout&) const = default;
+	};
+
+	// Locations of the uniforms set for every draw, -1 for the ones the shader does not use
+	struct DrawUniforms
+	{
+		GLint model = -1;
+		GLint localModel = -1;
+	};
+
 	//@brief Load the shader from the file
 	//@param vertexPath : Path to the vertex shader file
 	//@param fragmentPath : Path to the fragment shader file
@@ -26,6 +45,20 @@ public:
 	//@return GLint Location id of the attribute
 	GLint GetAttributeLocation(const std::string& name);
 
+	//@brief Returns the variant of the shader compiled with INSTANCED defined, which reads the model
+	// matrix and color of each object from instance attributes. Compiled on first use
+	//@return Shader* : The variant, owned by this shader
+	Shader* GetInstanced();
+
+	//@brief Returns whether the shader reads its objects from instance attributes
+	bool IsInstanced() const { return m_vertexLayout.instanceModel != -1; }
+
+	//@brief Returns the locations of the vertex attributes, looked up once the program is linked
+	const VertexLayout& GetVertexLayout() const { return m_vertexLayout; }
+
+	//@brief Returns the locations of the uniforms set for every draw, looked up once the program is linked
+	const DrawUniforms& GetDrawUniforms() const { return m_drawUniforms; }
+
 	//@brief Clear the uniform cache
     void ClearUniformCache();
 
@@ -58,7 +91,15 @@ public:
     template <typename T>
     void SetUniform(const std::string& name, const T& value)
     {
-        GLint location = GetUniformLocation(name);
+        SetUniform(GetUniformLocation(name), value);
+    }
+
+	//@brief Assign value to uniform in shader, by a location looked up before
+	//@param location : Location of the uniform, -1 to skip
+	//@param value : Value to assign
+    template <typename T>
+    void SetUniform(GLint location, const T& value)
+    {
         if (location == -1) return;  // Skip if uniform not found
 
         // Using constexpr to differentiate between types
@@ -97,6 +138,19 @@ public:
     }
 
 private:
+	//@brief Compiles a variant of the shader
+	//@param defines : Lines added after the #version line of every stage
+	Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath, const char* defines);
+
+	//@brief Binds the uniform blocks and samplers the shaders share to their binding points and texture units
+	void bindSharedInputs();
+
 	GLuint m_id;
+	VertexLayout m_vertexLayout;
+	DrawUniforms m_drawUniforms;
+	std::string m_vertexPath;
+	std::string m_fragmentPath;
+	std::string m_geometryPath;
+	std::shared_ptr<Shader> m_pInstanced;	// shared by copies of the shader
     std::unordered_map<std::string, GLint> m_uniformCache;
 };
\ No newline at end of file
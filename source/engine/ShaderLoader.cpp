@@ -1,7 +1,7 @@
 #include "pch.h"
 #include "ShaderLoader.h"
 
-GLuint ShaderLoader::Load(const char* vertexPath, const char* fragmentPath, const char* geometryPath)
+GLuint ShaderLoader::Load(const char* vertexPath, const char* fragmentPath, const char* geometryPath, const char* defines)
 {
 	std::string vertexCode;
 	std::string fragmentCode;
@@ -46,6 +46,10 @@ GLuint ShaderLoader::Load(const char* vertexPath, const char* fragmentPath, cons
 		throw "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ";
 	}
 
+	addDefines(vertexCode, defines);
+	addDefines(fragmentCode, defines);
+	addDefines(geometryCode, defines);
+
 	const char* vShaderCode = vertexCode.c_str();
 	const char* fShaderCode = fragmentCode.c_str();
 
@@ -93,6 +97,21 @@ GLuint ShaderLoader::Load(const char* vertexPath, const char* fragmentPath, cons
 	return id;
 }
 
+void ShaderLoader::addDefines(std::string& code, const char* defines)
+{
+	if (defines == nullptr || code.empty())
+		return;
+
+	// GLSL wants #version first, a source without one gets the defines on top
+	size_t position = 0;
+	if (code.compare(0, 8, "#version") == 0)
+	{
+		position = code.find('\n');
+		position = position == std::string::npos ? code.size() : position + 1;
+	}
+	code.insert(position, std::string(defines) + "\n");
+}
+
 void ShaderLoader::checkCompileErrors(GLuint shader, std::string type)
 {
 	GLint success;
@@ -4,8 +4,12 @@ class ShaderLoader
 {
 public:
 	//@brief Load the shader from the path provided
-	static GLuint Load(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr);
+	//@param defines : Lines inserted after the #version line of every stage, to compile a variant of the shader
+	static GLuint Load(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr, const char* defines = nullptr);
 private:
+	//@brief Inserts the defines after the #version line of the source
+	static void addDefines(std::string& code, const char* defines);
+
 	//@brief Check the shader compile errors
 	static void checkCompileErrors(GLuint shader, std::string type);
 
@@ -1,10 +1,17 @@
 #include "pch.h"
 #include "headers.h"
 
-int main()
+int main(int argc, char* argv[])
 {
 	Engine* engine = Engine::GetInstance();
 
+	// --headless <ticks> simulates that many fixed steps without rendering and exits
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (strcmp(argv[i], "--headless") == 0)
+			engine->SetHeadless(static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 10)));
+	}
+
 	std::unique_ptr<Game> game = nullptr;
 	std::unique_ptr<Game> anim = nullptr;
 	game = std::unique_ptr<Game>(new sample(1080, 1080, "Sample"));
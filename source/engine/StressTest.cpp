@@ -2,7 +2,6 @@
 #include "StressTest.h"
 #include "Camera.h"
 #include "DeserializeJSON.h"
-#include "VectorCalculations.h"
 #include "TransformComponent.h"
 #include "resourcemanager/ResourceFactory.h"
 #include "objectmanager/GameObjectManager.h"
@@ -34,27 +33,16 @@ void StressTest::Update()
 {
 	SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene()->Update();
 
-	// Checking the dt and vector calculation functions
+	// Checking the dt
+	auto gameObjects = SERVICE_LOCATOR.GetGameObjectManager()->GetGameObjects();
 	for (int i = 0; i < 100; i++)
 	{
-		auto objTransform = SERVICE_LOCATOR.GetGameObjectManager()->GetGameObjects()[i]->GetComponent<TransformComponent>();
+		auto objTransform = gameObjects[i]->GetComponent<TransformComponent>();
 		objTransform->SetPosition(glm::vec3(5 * sin(i) + i / 2.0f, 5 * cos(i), 5 * sin(i) * cos(i)));
 		float dt = static_cast<float>(SERVICE_LOCATOR.GetTime()->GetDeltaTime());
 		auto rot = objTransform->GetRotation();
 		objTransform->SetRotation(rot + glm::vec3(8.0f * dt, 8.0f * dt, 0.0f));
 	}
-	auto objTransform = SERVICE_LOCATOR.GetGameObjectManager()->GetGameObjects()[0]->GetComponent<TransformComponent>();
-	auto rot = objTransform->GetRotation();
-	auto forward = VectorCalculation::GetForwardVec(rot);
-	auto right = VectorCalculation::GetRightVec(rot);
-	auto up = VectorCalculation::GetUpVec(rot);
-
-	float dt = static_cast<float>(SERVICE_LOCATOR.GetTime()->GetDeltaTime());
-	//objTransform->SetRotation(rot + glm::vec3(0.0f, 0.0f, 5.f * dt));
-
-	//std::cout << "Forward: " << forward.x << " " << forward.y << " " << forward.z << std::endl;
-	//std::cout << "Right: " << right.x << " " << right.y << " " << right.z << std::endl;
-	//std::cout << "Up: " << up.x << " " << up.y << " " << up.z << std::endl;
 }
 
 void StressTest::Render()
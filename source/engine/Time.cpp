@@ -14,6 +14,8 @@ void Time::Init(double fixedDT)
 {
 	m_fixedDeltaTime = fixedDT;
 	m_deltaTime = 0.0f;
+	m_accumulator = 0.0;
+	m_stepCount = 0;
 	m_lastTime = std::chrono::high_resolution_clock::now();
 }
 
@@ -22,4 +24,15 @@ void Time::Update()
 	auto currTime = std::chrono::high_resolution_clock::now();
 	m_deltaTime = std::chrono::duration<double>(currTime - m_lastTime).count();
 	m_lastTime = currTime;
+
+	m_accumulator += std::min(m_deltaTime, MAX_FRAME_TIME);
+	m_stepCount = static_cast<uint32_t>(m_accumulator / m_fixedDeltaTime);
+	if (m_stepCount > MAX_STEPS_PER_FRAME)
+	{
+		// Falling behind, the whole steps that do not fit are dropped
+		m_stepCount = MAX_STEPS_PER_FRAME;
+		m_accumulator = std::fmod(m_accumulator, m_fixedDeltaTime);
+	}
+	else
+		m_accumulator -= m_stepCount * m_fixedDeltaTime;
 }
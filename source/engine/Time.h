@@ -3,9 +3,15 @@
 class Time
 {
 public:
+	// Most fixed steps run in one frame. Time beyond that is dropped so a slow frame cannot
+	// make the next one slower by queuing ever more steps
+	static constexpr uint32_t MAX_STEPS_PER_FRAME = 8;
+	// Longest frame accounted for, longer ones (breakpoints, loading) are clamped
+	static constexpr double MAX_FRAME_TIME = 0.25;
+
 	//@brief Initializes the time
 	void Init(double fixedDT);
-	//@brief Updates the time
+	//@brief Updates the time and works out how many fixed steps the frame has to run
 	void Update();
 
 	//@brief Returns the fixed delta time
@@ -14,6 +20,12 @@ public:
 	//@brief Returns the delta time
 	//@return double : Delta time
 	inline const double GetDeltaTime() const { return m_deltaTime; }
+	//@brief Returns the number of fixed steps to simulate this frame
+	//@return uint32_t : Step count, 0 when the frame was shorter than the time left to the next step
+	inline uint32_t GetStepCount() const { return m_stepCount; }
+	//@brief Returns how far the frame is between the last simulated step and the next one
+	//@return double : Fraction of a fixed step in [0, 1), used to interpolate what is rendered
+	inline double GetInterpolationAlpha() const { return m_accumulator / m_fixedDeltaTime; }
 
 private:
 	static Time* GetInstance();
@@ -21,7 +33,9 @@ private:
 
 	double m_fixedDeltaTime;
 	double m_deltaTime;
+	double m_accumulator;	// Frame time not simulated yet, less than one fixed step after Update
+	uint32_t m_stepCount;
 	std::chrono::time_point<std::chrono::high_resolution_clock> m_lastTime;
 
 	friend class ServiceLocator;
-};
\ No newline at end of file
+};
@@ -1,22 +1,32 @@
 #include "pch.h"
 
+TransformStorage& Transform::GetStorage()
+{
+	// Never destroyed: singletons release their nodes during static destruction
+	static TransformStorage* storage = new TransformStorage();
+	return *storage;
+}
+
 void Transform::SetPosition(const glm::vec3 newPos)
 {
-	m_position = newPos;
-	updateModelMatrix();
+	TransformStorage& storage = GetStorage();
+	uint32_t index = storage.Index(m_handle);
+	storage.position[index] = newPos;
+	storage.MarkChanged(index);
 }
 
 void Transform::SetRotation(const glm::vec3 newRot)
 {
-	m_rotation = newRot;
-	updateModelMatrix();
+	TransformStorage& storage = GetStorage();
+	storage.SetRotation(storage.Index(m_handle), newRot);
 }
 
 void Transform::SetScale(const glm::vec3 newScale)
 {
-	m_scale = newScale;
-	updateModelMatrix();
-
+	TransformStorage& storage = GetStorage();
+	uint32_t index = storage.Index(m_handle);
+	storage.scale[index] = newScale;
+	storage.MarkChanged(index);
 }
 
 void Transform::SetProjection(const glm::mat4 projection)
@@ -28,14 +38,3 @@ void Transform::SetView(const glm::mat4 view)
 {
 	m_view = view;
 }
-
-void Transform::updateModelMatrix()
-{
-	m_scaleMatrix = glm::scale(glm::mat4(1.0f), m_scale);
-	m_rotationMatrix = glm::rotate(glm::mat4(1.0f), glm::radians(m_rotation.x), glm::vec3(1.0f, 0.0f, 0.0f))
-		* glm::rotate(glm::mat4(1.0f), glm::radians(m_rotation.y), glm::vec3(0.0f, 1.0f, 0.0f))
-		* glm::rotate(glm::mat4(1.0f), glm::radians(m_rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-	m_translationMatrix = glm::translate(glm::mat4(1.0f), m_position);
-
-	m_model = m_translationMatrix * m_rotationMatrix * m_scaleMatrix;
-}
@@ -2,15 +2,14 @@
 class Transform
 {
 public:
-	Transform() : m_model(glm::identity<glm::mat4>()),
-		m_projection(glm::identity<glm::mat4>()),
+	Transform() : m_projection(glm::identity<glm::mat4>()),
 		m_view(glm::identity<glm::mat4>()),
-		m_position(glm::vec3(0.0f)),
-		m_rotation(glm::vec3(0.0f)),
-		m_scale(glm::vec3(1.0f)),
-		m_translationMatrix(glm::identity<glm::mat4>()),
-		m_rotationMatrix(glm::identity<glm::mat4>()),
-		m_scaleMatrix(glm::identity<glm::mat4>()) {}
+		m_handle(GetStorage().Create()) {}
+	~Transform() { GetStorage().Destroy(m_handle); }
+
+	// A transform owns its storage slot
+	Transform(const Transform&) = delete;
+	Transform& operator=(const Transform&) = delete;
 
 	//--------------------------------
 	//Setters
@@ -42,31 +41,53 @@ public:
 
 	//@brief Returns the position of the transform
 	//@return glm::vec3 the position of the transform
-	const glm::vec3 GetPosition() const { return m_position; }
+	const glm::vec3 GetPosition() const { const TransformStorage& s = GetStorage(); return s.position[s.Index(m_handle)]; }
 
 	//@brief Returns the rotation of the transform
-	//@return glm::vec3 the rotation of the transform
-	const glm::vec3 GetRotation() const { return m_rotation; }
+	//@return glm::vec3 the rotation of the transform in Euler angles (degrees)
+	const glm::vec3 GetRotation() const { const TransformStorage& s = GetStorage(); return s.rotation[s.Index(m_handle)]; }
+
+	//@brief Returns the rotation of the transform as a quaternion
+	//@return glm::quat the orientation of the transform
+	const glm::quat GetOrientation() const { const TransformStorage& s = GetStorage(); return s.orientation[s.Index(m_handle)]; }
 
 	//@brief Returns the scale of the transform
 	//@return glm::vec3 the scale of the transform
-	const glm::vec3 GetScale() const { return m_scale; }
+	const glm::vec3 GetScale() const { const TransformStorage& s = GetStorage(); return s.scale[s.Index(m_handle)]; }
 
-	//@brief Returns the translation matrix of the transform
+	//@brief Builds the translation matrix of the transform
 	//@return glm::mat4 the translation matrix of the transform
-	const glm::mat4 GetTranslationMatrix() const { return m_translationMatrix; }
+	const glm::mat4 GetTranslationMatrix() const { return glm::translate(glm::mat4(1.0f), GetPosition()); }
 
-	//@brief Returns the rotation matrix of the transform
+	//@brief Builds the rotation matrix of the transform
 	//@return glm::mat4 the rotation matrix of the transform
-	const glm::mat4 GetRotationMatrix() const { return m_rotationMatrix; }
+	const glm::mat4 GetRotationMatrix() const { return glm::mat4_cast(GetOrientation()); }
 
-	//@brief Returns the scale matrix of the transform
+	//@brief Builds the scale matrix of the transform
 	//@return glm::mat4 the scale matrix of the transform
-	const glm::mat4 GetScaleMatrix() const { return m_scaleMatrix; }
+	const glm::mat4 GetScaleMatrix() const { return glm::scale(glm::mat4(1.0f), GetScale()); }
 
-	//@brief Returns the model matrix of the transform
+	//@brief Returns the model matrix of the transform, composed on the spot if the transform changed.
+	// Only reads the storage, so jobs may call it while the scene is updated
 	//@return glm::mat4 the model matrix of the transform
-	const glm::mat4 GetModel() const { return m_model; }
+	const glm::mat4 GetModel() const { const TransformStorage& s = GetStorage(); return s.ReadModel(s.Index(m_handle)); }
+
+	//@brief Returns the direction the local x axis points to
+	//@return glm::vec3 the right vector of the transform
+	const glm::vec3 GetRight() const { const TransformStorage& s = GetStorage(); return s.ReadBasis(s.Index(m_handle))[0]; }
+
+	//@brief Returns the direction the local y axis points to
+	//@return glm::vec3 the up vector of the transform
+	const glm::vec3 GetUp() const { const TransformStorage& s = GetStorage(); return s.ReadBasis(s.Index(m_handle))[1]; }
+
+	//@brief Returns the direction the local z axis points to. Follows the orientation quaternion, not the
+	// Euler convention of VectorCalculation::GetForwardVec
+	//@return glm::vec3 the forward vector of the transform
+	const glm::vec3 GetForward() const { const TransformStorage& s = GetStorage(); return s.ReadBasis(s.Index(m_handle))[2]; }
+
+	//@brief Returns the world matrix as of the last Scene::UpdateWorldTransforms pass
+	//@return glm::mat4 the world matrix of the transform
+	const glm::mat4 GetWorld() const { const TransformStorage& s = GetStorage(); return s.world[s.Index(m_handle)]; }
 
 	//@brief Returns the projection matrix of the transform
 	//@return glm::mat4 the projection matrix of the transform
@@ -76,19 +97,18 @@ public:
 	//@return glm::mat4 the view matrix of the transform
 	const glm::mat4 GetView() const { return m_view; }
 
+	//@brief Returns the storage handle of the transform
+	//@return uint32_t the handle of the transform in the TransformStorage
+	inline uint32_t GetHandle() const { return m_handle; }
+
+	//@brief Returns the storage shared by all transforms
+	//@return TransformStorage& the transform storage
+	static TransformStorage& GetStorage();
+
 private:
-	glm::mat4 m_model;
+	// position, rotation, scale and the derived matrices live in the TransformStorage
 	glm::mat4 m_projection;
 	glm::mat4 m_view;
 
-	glm::mat4 m_translationMatrix;
-	glm::mat4 m_rotationMatrix;
-	glm::mat4 m_scaleMatrix;
-
-	glm::vec3 m_position;
-	glm::vec3 m_rotation;
-	glm::vec3 m_scale;
-
-	//@brief Helper to update the model matrix whenever the transform changes
-	void updateModelMatrix();
+	uint32_t m_handle;
 };
\ No newline at end of file
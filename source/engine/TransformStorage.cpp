@@ -0,0 +1,99 @@
+#include "pch.h"
+#include "TransformStorage.h"
+
+uint32_t TransformStorage::Create()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto [handle, index] = m_index.Insert();
+
+	position.Reserve(index);
+	rotation.Reserve(index);
+	orientation.Reserve(index);
+	scale.Reserve(index);
+	model.Reserve(index);
+	world.Reserve(index);
+	right.Reserve(index);
+	up.Reserve(index);
+	forward.Reserve(index);
+	dirty.Reserve(index);
+
+	position[index] = glm::vec3(0.0f);
+	rotation[index] = glm::vec3(0.0f);
+	orientation[index] = glm::identity<glm::quat>();
+	scale[index] = glm::vec3(1.0f);
+	model[index] = glm::identity<glm::mat4>();
+	world[index] = glm::identity<glm::mat4>();
+	right[index] = glm::vec3(1.0f, 0.0f, 0.0f);
+	up[index] = glm::vec3(0.0f, 1.0f, 0.0f);
+	forward[index] = glm::vec3(0.0f, 0.0f, 1.0f);
+	dirty[index] = STALE_WORLD;
+	return handle;
+}
+
+void TransformStorage::Destroy(uint32_t handle)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto [index, last] = m_index.Erase(handle);
+	if (index == last)
+		return;
+
+	position[index] = position[last];
+	rotation[index] = rotation[last];
+	orientation[index] = orientation[last];
+	scale[index] = scale[last];
+	model[index] = model[last];
+	world[index] = world[last];
+	right[index] = right[last];
+	up[index] = up[last];
+	forward[index] = forward[last];
+	dirty[index] = dirty[last];
+}
+
+void TransformStorage::SetRotation(uint32_t index, const glm::vec3& degrees)
+{
+	rotation[index] = degrees;
+	// same order as rotating around x, then y, then z with matrices
+	orientation[index] = glm::angleAxis(glm::radians(degrees.x), glm::vec3(1.0f, 0.0f, 0.0f))
+		* glm::angleAxis(glm::radians(degrees.y), glm::vec3(0.0f, 1.0f, 0.0f))
+		* glm::angleAxis(glm::radians(degrees.z), glm::vec3(0.0f, 0.0f, 1.0f));
+	MarkChanged(index);
+}
+
+namespace {
+
+	// T * R * S written out: the rotation columns scaled, translation in the last column
+	glm::mat4 composeModel(const glm::mat3& r, const glm::vec3& s, const glm::vec3& position)
+	{
+		glm::mat4 m;
+		m[0] = glm::vec4(r[0] * s.x, 0.0f);
+		m[1] = glm::vec4(r[1] * s.y, 0.0f);
+		m[2] = glm::vec4(r[2] * s.z, 0.0f);
+		m[3] = glm::vec4(position, 1.0f);
+		return m;
+	}
+}
+
+void TransformStorage::Compose(uint32_t index)
+{
+	glm::mat3 r = glm::mat3_cast(orientation[index]);
+	model[index] = composeModel(r, scale[index], position[index]);
+
+	right[index] = r[0];
+	up[index] = r[1];
+	forward[index] = r[2];
+	dirty[index] &= ~STALE_MODEL;
+}
+
+glm::mat4 TransformStorage::ReadModel(uint32_t index) const
+{
+	if (!(dirty[index] & STALE_MODEL))
+		return model[index];
+	return composeModel(glm::mat3_cast(orientation[index]), scale[index], position[index]);
+}
+
+glm::mat3 TransformStorage::ReadBasis(uint32_t index) const
+{
+	if (!(dirty[index] & STALE_MODEL))
+		return glm::mat3(right[index], up[index], forward[index]);
+	return glm::mat3_cast(orientation[index]);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+// Structure-of-arrays backing store for every Transform. Systems that touch many
+// transforms per frame (physics integration, collision shape sync) stream over these
+// columns instead of chasing one heap allocation per node
+class TransformStorage
+{
+public:
+	// Bits of the dirty column
+	static constexpr uint8_t STALE_MODEL = 1 << 0;	// position/orientation/scale changed since the model matrix was composed
+	static constexpr uint8_t STALE_WORLD = 1 << 1;	// the world matrix needs to be refreshed
+
+	//@brief Allocates an identity transform
+	//@return uint32_t : Stable handle of the transform
+	uint32_t Create();
+
+	//@brief Releases a transform, the last transform is moved into its slot
+	//@param handle : Handle returned by Create
+	void Destroy(uint32_t handle);
+
+	//@brief Returns the dense index of a transform, valid until the next Destroy
+	//@param handle : Handle returned by Create
+	inline uint32_t Index(uint32_t handle) const { return m_index.DenseIndex(handle); }
+
+	//@brief Returns the number of live transforms
+	inline uint32_t Size() const { return m_index.Size(); }
+
+	//@brief Sets the Euler rotation (degrees) and the matching orientation
+	//@param index : Dense index of the transform
+	//@param degrees : Rotation around x, then y, then z
+	void SetRotation(uint32_t index, const glm::vec3& degrees);
+
+	//@brief Flags the model and world matrices of the transform as stale
+	//@param index : Dense index of the transform
+	inline void MarkChanged(uint32_t index) { dirty[index] = STALE_MODEL | STALE_WORLD; }
+
+	//@brief Composes the model matrix and basis vectors if they are stale
+	//@param index : Dense index of the transform
+	inline void Resolve(uint32_t index)
+	{
+		if (dirty[index] & STALE_MODEL)
+			Compose(index);
+	}
+
+	//@brief Composes the model matrix and basis vectors from position, orientation and scale
+	//@param index : Dense index of the transform
+	void Compose(uint32_t index);
+
+	//@brief Returns the model matrix, composed without storing it if it is stale, so readers never write
+	//@param index : Dense index of the transform
+	//@return glm::mat4 : The model matrix
+	glm::mat4 ReadModel(uint32_t index) const;
+
+	//@brief Returns the basis vectors as the columns right, up, forward, computed without storing them if they are stale
+	//@param index : Dense index of the transform
+	//@return glm::mat3 : The rotation matrix of the orientation
+	glm::mat3 ReadBasis(uint32_t index) const;
+
+	StorageColumn<glm::vec3> position;
+	StorageColumn<glm::vec3> rotation;		// Euler angles in degrees, as set through the API
+	StorageColumn<glm::quat> orientation;	// rotation as a quaternion, used for composition
+	StorageColumn<glm::vec3> scale;
+
+	StorageColumn<glm::mat4> model;			// composed lazily, see Resolve
+	StorageColumn<glm::mat4> world;			// parent world * model, refreshed by Scene::UpdateWorldTransforms
+	StorageColumn<glm::vec3> right;			// basis vectors of the orientation, composed with the model matrix
+	StorageColumn<glm::vec3> up;
+	StorageColumn<glm::vec3> forward;
+	StorageColumn<uint8_t> dirty;			// STALE_MODEL | STALE_WORLD bits
+
+private:
+	StorageIndex m_index;
+	std::mutex m_mutex;		// transforms are created from the loader threads
+};
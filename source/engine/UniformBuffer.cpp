@@ -0,0 +1,30 @@
+#include "pch.h"
+#include "UniformBuffer.h"
+
+UniformBuffer::~UniformBuffer()
+{
+	if (m_id != 0)
+		glDeleteBuffers(1, &m_id);
+}
+
+void UniformBuffer::Update(const void* data, size_t size)
+{
+	if (m_id == 0)
+	{
+		glGenBuffers(1, &m_id);
+		glBindBuffer(GL_UNIFORM_BUFFER, m_id);
+		glBufferData(GL_UNIFORM_BUFFER, size, data, GL_DYNAMIC_DRAW);
+	}
+	else
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, m_id);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	SERVICE_LOCATOR.GetRenderer()->CountUpload(size);
+}
+
+void UniformBuffer::Bind(UniformBlock block) const
+{
+	glBindBufferBase(GL_UNIFORM_BUFFER, static_cast<GLuint>(block), m_id);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+// Binding points of the uniform blocks the shaders share, assigned to the blocks of every shader when it is linked
+enum class UniformBlock : GLuint
+{
+	FRAME = 0,		// Frame, camera and light space matrices
+	LIGHT = 1,		// LightBlock
+	MATERIAL = 2	// MaterialBlock, of the bound material
+};
+
+// Texture units the samplers the shaders share read from, assigned when a shader is linked
+enum class TextureUnit : GLint
+{
+	DIFFUSE = 0,	// diffuseMap
+	SPECULAR = 1,	// specularMap
+	SHADOW = 2		// shadowMap
+};
+
+// The blocks in their std140 layout, every member on its shader's offset
+
+struct FrameBlock
+{
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::mat4 shadowMatrix;
+	glm::mat4 lightSpaceMatrix;
+	glm::ivec4 flags;			// x: draw normals as colors
+};
+
+struct LightBlock
+{
+	glm::vec4 position;			// a vec3 takes the space of a vec4
+	glm::vec4 ambient;
+	glm::vec4 diffuse;
+	glm::vec4 specular;
+};
+
+struct MaterialBlock
+{
+	glm::vec3 color;
+	float shininess;
+	GLint hasDiffuse;
+	GLint hasSpecular;
+	GLint padding[2];
+};
+
+// A uniform buffer holding one block
+class UniformBuffer
+{
+public:
+	UniformBuffer() = default;
+	~UniformBuffer();
+
+	// A buffer owns its GL name
+	UniformBuffer(const UniformBuffer&) = delete;
+	UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+	//@brief Uploads the block, creating the buffer the first time
+	//@param data : The block
+	//@param size : Bytes of the block, which must not change between uploads
+	void Update(const void* data, size_t size);
+
+	//@brief Binds the buffer to the binding point of its block
+	//@param block : The binding point
+	void Bind(UniformBlock block) const;
+
+private:
+	GLuint m_id = 0;
+};
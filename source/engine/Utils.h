@@ -1,5 +1,15 @@
 #pragma once
 
+// Driver error checks: glGetError after GL calls, and a debug context reporting through a message callback.
+// Each glGetError waits for the driver, so they only run in debug builds, or in others that define RENDER_VALIDATION
+#if defined(_DEBUG) && !defined(RENDER_VALIDATION)
+#define RENDER_VALIDATION
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 class Utils
 {
 public:
@@ -17,9 +27,10 @@ public:
 		return typeName;
 	}
 
-	//@brief Utility function for checking shader compilation/linking errors.
+	//@brief Utility function for checking shader compilation/linking errors. Does nothing without RENDER_VALIDATION
 	static void GetGLError()
 	{
+#ifdef RENDER_VALIDATION
 		GLenum error = glGetError();
 		if (error != GL_NO_ERROR)
 		{
@@ -53,5 +64,34 @@ public:
 			}
 			std::cout << "OpenGL Error: " << errorString << std::endl;
 		}
+#endif
+	}
+
+	//@brief Whether the processor has AVX2 and the system saves the wide registers, checked once. Files built
+	// with AVX2 must only be called when this holds, the rest of the engine only assumes SSE2
+	//@return bool : AVX2 can run
+	static bool HasAvx2()
+	{
+		static const bool hasAvx2 = []()
+		{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7)
+				return false;
+			__cpuid(info, 1);
+			const bool osxsave = (info[2] & (1 << 27)) != 0;
+			const bool avx = (info[2] & (1 << 28)) != 0;
+			if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+				return false;
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+			return __builtin_cpu_supports("avx2") != 0;
+#else
+			return false;
+#endif
+		}();
+		return hasAvx2;
 	}
 };
@@ -57,7 +57,9 @@ void WindowHandler::Init()
 	// Initialize OpenGL Context
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+#ifdef RENDER_VALIDATION
 	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+#endif
 	glfwWindowHint(GLFW_SAMPLES, 4);
 	glEnable(GL_MULTISAMPLE);
 	// Create window
@@ -81,10 +83,12 @@ void WindowHandler::Init()
 
 	glfwSetWindowSizeCallback(m_pWindow, this->GLFWWindowSizeCallback);
 
+#ifdef RENDER_VALIDATION
 	glEnable(GL_DEBUG_OUTPUT);
+	glDebugMessageCallback(MessageCallback, 0);
+#endif
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glDebugMessageCallback(MessageCallback, 0);
 
 	std::cout << "Window Initialized" << std::endl;
 }
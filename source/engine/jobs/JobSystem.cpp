@@ -0,0 +1,154 @@
+#include "../pch.h"
+#include "JobSystem.h"
+
+std::unique_ptr<JobSystem> JobSystem::instance = nullptr;
+thread_local uint32_t JobSystem::t_queue = JobSystem::SHARED_QUEUE;
+
+JobSystem* JobSystem::GetInstance()
+{
+	if (!instance)
+	{
+		instance = std::unique_ptr<JobSystem>(new JobSystem());
+	}
+	return instance.get();
+}
+
+JobSystem::JobSystem()
+{
+	// Jobs scheduled before Init land in the shared deque and are run by whoever waits on them
+	m_queues.push_back(std::make_unique<Queue>());
+}
+
+JobSystem::~JobSystem()
+{
+	Shutdown();
+}
+
+// ****** Workers ****** //
+#pragma region Workers
+void JobSystem::Init(uint32_t workerCount)
+{
+	if (m_running.load())
+		return;
+
+	if (workerCount == 0)
+		workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+	// Worker deques go in front of the shared one so a worker's index is also its deque's index
+	std::vector<std::unique_ptr<Queue>> queues;
+	for (uint32_t i = 0; i < workerCount; ++i)
+		queues.push_back(std::make_unique<Queue>());
+	queues.push_back(std::move(m_queues.back()));
+	m_queues = std::move(queues);
+
+	m_running.store(true);
+	for (uint32_t i = 0; i < workerCount; ++i)
+		m_workers.emplace_back(&JobSystem::workerLoop, this, i);
+
+	std::cout << "JobSystem Init (" << workerCount << " workers)" << std::endl;
+}
+
+void JobSystem::Shutdown()
+{
+	if (!m_running.exchange(false))
+		return;
+
+	// Wake every sleeping worker so it sees m_running
+	m_queued.fetch_add(1);
+	m_queued.notify_all();
+	for (auto& worker : m_workers)
+		worker.join();
+	m_workers.clear();
+	m_queued.fetch_sub(1);
+
+	// Whatever was still queued runs here before the worker deques go away
+	while (RunPendingJob()) {}
+	m_queues.erase(m_queues.begin(), m_queues.end() - 1);
+}
+
+void JobSystem::workerLoop(uint32_t index)
+{
+	t_queue = index;
+	while (m_running.load(std::memory_order_acquire))
+	{
+		if (!RunPendingJob())
+			m_queued.wait(0);
+	}
+}
+#pragma endregion
+
+// ****** Scheduling ****** //
+#pragma region Scheduling
+void JobSystem::Schedule(Job job, JobCounter* counter)
+{
+	if (counter)
+		counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+	Queue& queue = *m_queues[ownQueue()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back({ std::move(job), counter });
+		// Counted under the lock so a thief can never decrement before the increment
+		m_queued.fetch_add(1, std::memory_order_release);
+	}
+	m_queued.notify_one();
+}
+
+void JobSystem::Wait(const JobCounter& counter)
+{
+	while (!counter.IsDone())
+	{
+		if (!RunPendingJob())
+			std::this_thread::yield();
+	}
+}
+
+bool JobSystem::RunPendingJob()
+{
+	const uint32_t queueCount = static_cast<uint32_t>(m_queues.size());
+	const uint32_t own = ownQueue();
+	Task task;
+
+	// Newest own job first, it is the most likely to still be in cache
+	bool found = popBack(*m_queues[own], task);
+	for (uint32_t i = 1; !found && i < queueCount; ++i)
+		found = stealFront(*m_queues[(own + i) % queueCount], task);
+
+	if (!found)
+		return false;
+
+	execute(task);
+	return true;
+}
+
+bool JobSystem::popBack(Queue& queue, Task& task)
+{
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.tasks.empty())
+		return false;
+
+	task = std::move(queue.tasks.back());
+	queue.tasks.pop_back();
+	m_queued.fetch_sub(1, std::memory_order_relaxed);
+	return true;
+}
+
+bool JobSystem::stealFront(Queue& queue, Task& task)
+{
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.tasks.empty())
+		return false;
+
+	task = std::move(queue.tasks.front());
+	queue.tasks.pop_front();
+	m_queued.fetch_sub(1, std::memory_order_relaxed);
+	return true;
+}
+
+void JobSystem::execute(Task& task)
+{
+	task.job();
+	if (task.counter)
+		task.counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+#pragma endregion
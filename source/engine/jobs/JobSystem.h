@@ -0,0 +1,131 @@
+#pragma once
+
+// Number of jobs of a batch that are still queued or running. Wait on it to block until
+// every job scheduled against it has finished
+struct JobCounter
+{
+	std::atomic<uint32_t> pending{ 0 };
+
+	//@brief Returns whether every job scheduled against the counter has finished
+	inline bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+// Work-stealing scheduler shared by every engine system. Each worker thread owns a deque:
+// it pushes and pops its own jobs at the back and steals from the front of the others.
+// Threads that are not workers (the main thread, loader threads) share one extra deque.
+// Waiting never blocks a thread, it runs queued jobs until the counter drops to zero, so
+// jobs may schedule and wait for other jobs
+class JobSystem
+{
+public:
+	using Job = std::function<void()>;
+
+	~JobSystem();
+
+	//@brief Starts the worker threads
+	//@param workerCount : Number of workers, 0 to use one per hardware thread besides the main thread
+	void Init(uint32_t workerCount = 0);
+
+	//@brief Finishes the queued jobs and joins the worker threads
+	void Shutdown();
+
+	//@brief Queues a job on the calling thread's deque
+	//@param job : Work to run
+	//@param counter : Optional counter incremented now and decremented once the job has run
+	void Schedule(Job job, JobCounter* counter = nullptr);
+
+	//@brief Runs queued jobs on the calling thread until every job of the counter has finished
+	//@param counter : Counter passed to Schedule
+	void Wait(const JobCounter& counter);
+
+	//@brief Runs one queued job on the calling thread, stealing it if the own deque is empty
+	//@return bool : Whether a job was run
+	bool RunPendingJob();
+
+	//@brief Splits [0, count) into batches and runs fn(begin, end) for each of them across the workers,
+	// returns once every batch is done. Runs inline when the range fits in one batch
+	//@param count : Number of elements
+	//@param minBatch : Smallest batch worth a job
+	//@param fn : Callable taking (uint32_t begin, uint32_t end)
+	template <typename Function>
+	void ParallelFor(uint32_t count, uint32_t minBatch, Function&& fn)
+	{
+		if (count == 0)
+			return;
+
+		// A few batches per thread so idle threads have something to steal
+		const uint32_t threads = GetWorkerCount() + 1;
+		const uint32_t batch = std::max(std::max(minBatch, 1u), (count + threads * 4 - 1) / (threads * 4));
+		if (count <= batch)
+		{
+			fn(0u, count);
+			return;
+		}
+
+		JobCounter counter;
+		uint32_t begin = batch;
+		for (; begin < count; begin += batch)
+		{
+			const uint32_t end = std::min(begin + batch, count);
+			Schedule([&fn, begin, end]() { fn(begin, end); }, &counter);
+		}
+		// The first batch runs here instead of waiting idle
+		fn(0u, batch);
+		Wait(counter);
+	}
+
+	//@brief Returns the number of worker threads
+	inline uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+	//@brief Returns whether the calling thread is one of the workers
+	inline bool IsWorkerThread() const { return t_queue < m_workers.size(); }
+
+private:
+	JobSystem();
+
+	// t_queue of threads that are not workers
+	static constexpr uint32_t SHARED_QUEUE = std::numeric_limits<uint32_t>::max();
+
+	struct Task
+	{
+		Job job;
+		JobCounter* counter;
+	};
+
+	struct Queue
+	{
+		std::deque<Task> tasks;
+		std::mutex mutex;
+	};
+
+	//@brief Main loop of a worker thread
+	//@param index : Index of the worker and of its deque
+	void workerLoop(uint32_t index);
+
+	//@brief Pops the newest task of the deque
+	//@return bool : Whether a task was found
+	bool popBack(Queue& queue, Task& task);
+
+	//@brief Takes the oldest task of the deque
+	//@return bool : Whether a task was found
+	bool stealFront(Queue& queue, Task& task);
+
+	//@brief Runs a task and signals its counter
+	void execute(Task& task);
+
+	//@brief Returns the deque of the calling thread
+	inline uint32_t ownQueue() const { return t_queue == SHARED_QUEUE ? static_cast<uint32_t>(m_queues.size() - 1) : t_queue; }
+
+	static JobSystem* GetInstance();
+	static std::unique_ptr<JobSystem> instance;
+
+	// Worker index of the calling thread, SHARED_QUEUE unless the thread is a worker
+	static thread_local uint32_t t_queue;
+
+	std::vector<std::thread> m_workers;
+	std::vector<std::unique_ptr<Queue>> m_queues;	// One per worker, the shared deque last
+	std::atomic<uint32_t> m_queued{ 0 };			// Jobs sitting in any deque, sleeping workers wait on it
+	std::atomic<bool> m_running{ false };
+
+	friend class ServiceLocator;
+};
@@ -0,0 +1,93 @@
+#include "../pch.h"
+#include "TaskGraph.h"
+
+TaskGraph::TaskId TaskGraph::AddTask(std::string name, std::function<void()> function,
+	std::initializer_list<TaskId> dependencies, Affinity affinity)
+{
+	const TaskId id = static_cast<TaskId>(m_tasks.size());
+	for (TaskId dependency : dependencies)
+	{
+		// Only earlier tasks can be depended on, which keeps the graph acyclic
+		if (dependency >= id)
+			throw std::runtime_error("Task " + name + " depends on a task that was not added before it");
+		m_tasks[dependency].dependents.push_back(id);
+	}
+
+	Task task;
+	task.name = std::move(name);
+	task.function = std::move(function);
+	task.dependencyCount = static_cast<uint32_t>(dependencies.size());
+	task.affinity = affinity;
+	m_tasks.push_back(std::move(task));
+	return id;
+}
+
+void TaskGraph::Run(JobSystem& jobs)
+{
+	if (m_tasks.empty())
+		return;
+
+	if (m_pending.size() != m_tasks.size())
+		m_pending = std::vector<std::atomic<uint32_t>>(m_tasks.size());
+	for (TaskId id = 0; id < m_tasks.size(); ++id)
+		m_pending[id].store(m_tasks[id].dependencyCount, std::memory_order_relaxed);
+	m_remaining.pending.store(static_cast<uint32_t>(m_tasks.size()), std::memory_order_release);
+
+	for (TaskId id = 0; id < m_tasks.size(); ++id)
+	{
+		if (m_tasks[id].dependencyCount == 0)
+			dispatch(id, jobs);
+	}
+
+	while (!m_remaining.IsDone())
+	{
+		TaskId ready = 0;
+		bool hasMainThreadTask = false;
+		{
+			std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+			if (!m_mainThreadReady.empty())
+			{
+				// Oldest first, main thread tasks run in the order they became ready
+				ready = m_mainThreadReady.front();
+				m_mainThreadReady.erase(m_mainThreadReady.begin());
+				hasMainThreadTask = true;
+			}
+		}
+
+		if (hasMainThreadTask)
+			execute(ready, jobs);
+		else if (!jobs.RunPendingJob())
+			std::this_thread::yield();
+	}
+}
+
+void TaskGraph::Clear()
+{
+	m_tasks.clear();
+	m_pending.clear();
+	m_mainThreadReady.clear();
+}
+
+void TaskGraph::dispatch(TaskId id, JobSystem& jobs)
+{
+	if (m_tasks[id].affinity == Affinity::MAIN_THREAD)
+	{
+		std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+		m_mainThreadReady.push_back(id);
+		return;
+	}
+	jobs.Schedule([this, id, &jobs]() { execute(id, jobs); });
+}
+
+void TaskGraph::execute(TaskId id, JobSystem& jobs)
+{
+	const Task& task = m_tasks[id];
+	task.function();
+
+	for (TaskId dependent : task.dependents)
+	{
+		if (m_pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+			dispatch(dependent, jobs);
+	}
+	m_remaining.pending.fetch_sub(1, std::memory_order_acq_rel);
+}
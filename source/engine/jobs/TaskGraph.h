@@ -0,0 +1,63 @@
+#pragma once
+
+// Declarative description of the work of a frame. Tasks are added once with the tasks they
+// depend on, Run then starts every task as soon as its dependencies are done: tasks that
+// can run anywhere go to the JobSystem, tasks bound to the main thread (GL, GLFW, ImGui,
+// Lua, gameplay callbacks) are run by the thread calling Run while it helps with the rest
+class TaskGraph
+{
+public:
+	using TaskId = uint32_t;
+
+	enum class Affinity
+	{
+		ANY,			// Runs on whichever thread picks it up
+		MAIN_THREAD		// Runs on the thread calling Run
+	};
+
+	//@brief Adds a task to the graph
+	//@param name : Name of the task, used for debugging
+	//@param function : Work of the task
+	//@param dependencies : Tasks that must finish before this one starts, added earlier
+	//@param affinity : Where the task is allowed to run
+	//@return TaskId : ID of the task, to be used as a dependency of later tasks
+	TaskId AddTask(std::string name, std::function<void()> function,
+		std::initializer_list<TaskId> dependencies = {}, Affinity affinity = Affinity::ANY);
+
+	//@brief Runs every task once and returns when all of them are done
+	//@param jobs : Scheduler running the tasks that are not bound to the main thread
+	void Run(JobSystem& jobs);
+
+	//@brief Removes every task
+	void Clear();
+
+	//@brief Returns the number of tasks
+	inline uint32_t GetTaskCount() const { return static_cast<uint32_t>(m_tasks.size()); }
+
+	//@brief Returns the name of a task
+	inline const std::string& GetTaskName(TaskId id) const { return m_tasks[id].name; }
+
+private:
+	struct Task
+	{
+		std::string name;
+		std::function<void()> function;
+		std::vector<TaskId> dependents;		// Tasks waiting on this one
+		uint32_t dependencyCount = 0;
+		Affinity affinity = Affinity::ANY;
+	};
+
+	//@brief Hands a task whose dependencies are done to the thread allowed to run it
+	void dispatch(TaskId id, JobSystem& jobs);
+
+	//@brief Runs a task and dispatches the dependents it was the last dependency of
+	void execute(TaskId id, JobSystem& jobs);
+
+	std::vector<Task> m_tasks;
+
+	// State of the current Run
+	std::vector<std::atomic<uint32_t>> m_pending;	// Unfinished dependencies per task
+	std::vector<TaskId> m_mainThreadReady;
+	std::mutex m_mainThreadMutex;
+	JobCounter m_remaining;
+};
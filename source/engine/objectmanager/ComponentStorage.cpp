@@ -0,0 +1,41 @@
+#include "../pch.h"
+#include "ComponentStorage.h"
+
+std::pair<uint32_t, uint32_t> StorageIndex::Insert()
+{
+	uint32_t handle;
+	if (!m_freeHandles.empty())
+	{
+		handle = m_freeHandles.back();
+		m_freeHandles.pop_back();
+	}
+	else
+	{
+		handle = m_handleCount++;
+		m_sparse.Reserve(handle);
+	}
+
+	uint32_t index = m_size;
+	m_dense.Reserve(index);
+	m_sparse[handle] = index;
+	m_dense[index] = handle;
+	++m_size;
+	return { handle, index };
+}
+
+std::pair<uint32_t, uint32_t> StorageIndex::Erase(uint32_t handle)
+{
+	assert(handle < m_handleCount && m_sparse[handle] != INVALID && "Handle is not part of the storage");
+
+	uint32_t index = m_sparse[handle];
+	uint32_t last = --m_size;
+
+	// the last element takes over the freed slot
+	uint32_t movedHandle = m_dense[last];
+	m_dense[index] = movedHandle;
+	m_sparse[movedHandle] = index;
+
+	m_sparse[handle] = INVALID;
+	m_freeHandles.push_back(handle);
+	return { index, last };
+}
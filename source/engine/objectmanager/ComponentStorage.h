@@ -0,0 +1,64 @@
+#pragma once
+
+// One array of a structure-of-arrays store. Elements are kept in fixed-size pages so
+// growing the store never moves existing elements; loader threads can keep writing to
+// the objects they created while other threads are still adding new ones
+template <typename DataType>
+class StorageColumn
+{
+public:
+	static constexpr size_t PAGE_BITS = 10;
+	static constexpr size_t PAGE_SIZE = size_t(1) << PAGE_BITS;
+	static constexpr size_t MAX_PAGES = 1024;	// ~1M elements per store
+
+	inline DataType& operator[](size_t index) { return m_pages[index >> PAGE_BITS][index & (PAGE_SIZE - 1)]; }
+	inline const DataType& operator[](size_t index) const { return m_pages[index >> PAGE_BITS][index & (PAGE_SIZE - 1)]; }
+
+	//@brief Makes sure the page holding the index is allocated (call with the store lock held)
+	//@param index : Dense index about to be written
+	void Reserve(size_t index)
+	{
+		if (index >= PAGE_SIZE * MAX_PAGES)
+			throw std::runtime_error("StorageColumn is full, raise StorageColumn::MAX_PAGES");
+
+		std::unique_ptr<DataType[]>& page = m_pages[index >> PAGE_BITS];
+		if (!page)
+			page = std::make_unique<DataType[]>(PAGE_SIZE);
+	}
+
+private:
+	std::array<std::unique_ptr<DataType[]>, MAX_PAGES> m_pages;
+};
+
+// Sparse set mapping stable handles to densely packed indices. Removing an element moves
+// the last element into the freed slot so the live range [0, Size()) never has holes
+class StorageIndex
+{
+public:
+	static constexpr uint32_t INVALID = std::numeric_limits<uint32_t>::max();
+
+	//@brief Reserves a handle and appends a dense slot for it
+	//@return std::pair<uint32_t, uint32_t> : The new handle and its dense index
+	std::pair<uint32_t, uint32_t> Insert();
+
+	//@brief Releases a handle, the last dense slot is moved into the freed one
+	//@param handle : Handle to release
+	//@return std::pair<uint32_t, uint32_t> : The freed dense index and the former last index whose data must be moved there
+	std::pair<uint32_t, uint32_t> Erase(uint32_t handle);
+
+	//@brief Returns the dense index of a handle
+	inline uint32_t DenseIndex(uint32_t handle) const { return m_sparse[handle]; }
+
+	//@brief Returns the handle stored at a dense index
+	inline uint32_t Handle(uint32_t index) const { return m_dense[index]; }
+
+	//@brief Returns the number of live elements
+	inline uint32_t Size() const { return m_size; }
+
+private:
+	StorageColumn<uint32_t> m_sparse;	// handle -> dense index
+	StorageColumn<uint32_t> m_dense;	// dense index -> handle
+	std::vector<uint32_t> m_freeHandles;
+	uint32_t m_handleCount = 0;
+	uint32_t m_size = 0;
+};
@@ -1,6 +1,8 @@
 #include "../pch.h"
 #include "GameObjectFactory.h"
 #include "GameObjectManager.h"
+#include "../scenemanager/SceneManager.h"
+#include "../scenemanager/CompiledScene.h"
 #include "TransformComponent.h"
 #include "RenderComponent.h"
 #include "../physics/PhysicsComponent.h"
@@ -22,77 +24,237 @@ GameObjectFactory* GameObjectFactory::GetInstance()
     return instance.get();
 }
 
+template <typename DataType>
+static Component* attachComponent(GameObject* gameObject)
+{
+    return gameObject->AddComponent<DataType>();
+}
+
+static double millisecondsSince(std::chrono::high_resolution_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
 void GameObjectFactory::CreateAllGameObjects(const rapidjson::Value& gameObjects)
 {
-	std::vector<std::thread> threads;
-	for (rapidjson::Value::ConstMemberIterator it = gameObjects.MemberBegin(); it != gameObjects.MemberEnd(); ++it)
-		threads.push_back(std::thread([this, it]() { this->createGameObject(it); }));
-		
-	for (auto& th : threads) 
-	{
-		if (th.joinable()) 
-		{ 
-			th.join(); 
-		}
-	}
+    // Parse: one spawn per object in document order, parents before their children
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<Spawn> spawns;
+    flatten(gameObjects, -1, spawns);
+    m_lastLoad.objectCount = spawns.size();
+    m_lastLoad.parseMs = millisecondsSince(start);
+
+    // Construct: every spawn is written by a single job, so the workers share nothing but the
+    // pools and the transform storage, which lock. Reserving up front keeps page allocation out of the loop
+    start = std::chrono::high_resolution_clock::now();
+    ScenePools& pools = SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene()->GetPools();
+    pools.Reserve<GameObject>(spawns.size());
+    pools.Reserve<TransformComponent>(spawns.size());
+    SERVICE_LOCATOR.GetJobSystem()->ParallelFor(static_cast<uint32_t>(spawns.size()), CONSTRUCT_BATCH_SIZE,
+        [this, &spawns](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+                construct(spawns[i]);
+        });
+    m_lastLoad.constructMs = millisecondsSince(start);
+
+    // Commit: component constructors register with their managers and may touch GL or Lua,
+    // so attaching and registering happen here, in spawn order
+    start = std::chrono::high_resolution_clock::now();
+    commit(spawns);
+    m_lastLoad.commitMs = millisecondsSince(start);
 }
 
-void GameObjectFactory::createGameObject(rapidjson::Value::ConstMemberIterator member, GameObject* pParent)
+void GameObjectFactory::CreateAllGameObjects(const CompiledScene& scene)
 {
-    GameObject* gameObject = new GameObject();
-    gameObject->SetName(member->name.GetString());
-    if (pParent)
-		pParent->AddChild(gameObject);
+    // Parse: the records are read in place from the mapping
+    const uint32_t count = scene.GetObjectCount();
+    m_lastLoad.objectCount = count;
+    m_lastLoad.parseMs = 0.0;
+
+    // Construct: same as the json path, minus the component decoding
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<GameObject*> objects(count);
+    ScenePools& pools = SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene()->GetPools();
+    pools.Reserve<GameObject>(count);
+    pools.Reserve<TransformComponent>(count);
+    SERVICE_LOCATOR.GetJobSystem()->ParallelFor(count, CONSTRUCT_BATCH_SIZE,
+        [&scene, &objects, &pools](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                objects[i] = new (pools.Get<GameObject>()) GameObject();
+                objects[i]->SetName(std::string(scene.GetObjectName(i)));
+            }
+        });
+    m_lastLoad.constructMs = millisecondsSince(start);
+
+    // Commit: parents come before their children in the file
+    start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        scene.AttachComponents(i, objects[i]);
+        if (scene.GetParent(i) >= 0)
+            objects[scene.GetParent(i)]->AddChild(objects[i]);
+    }
+    SERVICE_LOCATOR.GetGameObjectManager()->AddGameObjects(objects);
+    m_lastLoad.commitMs = millisecondsSince(start);
+}
+
+void GameObjectFactory::BenchmarkLoad(const std::string& sceneSource, std::span<const uint32_t> counts)
+{
+    std::ifstream file(sceneSource);
+    if (!file)
+    {
+        std::cerr << "Failed to load benchmark scene " << sceneSource << std::endl;
+        return;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    rapidjson::Document sceneDoc;
+    sceneDoc.Parse(buffer.str().c_str());
+    if (sceneDoc.HasParseError() || !sceneDoc.IsObject() || sceneDoc.MemberCount() == 0)
+    {
+        std::cerr << "Error parsing the benchmark scene " << sceneSource << std::endl;
+        return;
+    }
+
+    const rapidjson::Value& sceneData = sceneDoc.MemberBegin()->value;
+    auto prototypes = sceneData.FindMember("GameObject");
+    if (prototypes == sceneData.MemberEnd() || !prototypes->value.IsObject() || prototypes->value.ObjectEmpty())
+    {
+        std::cerr << "Benchmark scene " << sceneSource << " has no game objects" << std::endl;
+        return;
+    }
+
+    Scene* scene = SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene();
+    const std::string compiledPath = (std::filesystem::temp_directory_path() / "scene_benchmark.scnb").string();
+    auto report = [this](const char* format)
+    {
+        const double total = m_lastLoad.parseMs + m_lastLoad.constructMs + m_lastLoad.commitMs;
+        printf("%8s %10zu %10.2f %12.2f %10.2f %10.2f %10.2f\n", format, m_lastLoad.objectCount, m_lastLoad.parseMs,
+            m_lastLoad.constructMs, m_lastLoad.commitMs, total, total * 1000.0 / std::max<size_t>(m_lastLoad.objectCount, 1));
+    };
+
+    printf("Scene load benchmark: %s, %u threads\n", sceneSource.c_str(), SERVICE_LOCATOR.GetJobSystem()->GetWorkerCount() + 1);
+    printf("%8s %10s %10s %12s %10s %10s %10s\n", "format", "objects", "parse ms", "construct ms", "commit ms", "total ms", "us/object");
+    for (uint32_t count : counts)
+    {
+        // Cycle through the objects of the scene, the copies get unique names for the GameObjectManager
+        rapidjson::Document gameObjects(rapidjson::kObjectType);
+        rapidjson::Document::AllocatorType& allocator = gameObjects.GetAllocator();
+        auto prototype = prototypes->value.MemberBegin();
+        for (uint32_t i = 0; i < count; ++i, ++prototype)
+        {
+            if (prototype == prototypes->value.MemberEnd())
+                prototype = prototypes->value.MemberBegin();
+            std::string name = std::string(prototype->name.GetString()) + "_" + std::to_string(i);
+            gameObjects.AddMember(rapidjson::Value(name.c_str(), allocator), rapidjson::Value(prototype->value, allocator), allocator);
+        }
+
+        CreateAllGameObjects(gameObjects);
+        report("json");
+        scene->Shutdown();
+
+        // Mapping and validating the file stands in for parsing
+        if (!CompiledScene::Compile(gameObjects, compiledPath))
+            continue;
+        const auto start = std::chrono::high_resolution_clock::now();
+        CompiledScene compiled;
+        if (!compiled.Open(compiledPath))
+            continue;
+        const double openMs = millisecondsSince(start);
+        CreateAllGameObjects(compiled);
+        m_lastLoad.parseMs = openMs;
+        report("binary");
+        scene->Shutdown();
+    }
+
+    std::error_code error;
+    std::filesystem::remove(compiledPath, error);
+}
+
+void GameObjectFactory::flatten(const rapidjson::Value& gameObjects, int32_t parent, std::vector<Spawn>& spawns)
+{
+    for (rapidjson::Value::ConstMemberIterator it = gameObjects.MemberBegin(); it != gameObjects.MemberEnd(); ++it)
+    {
+        int32_t index = static_cast<int32_t>(spawns.size());
+        spawns.push_back(Spawn{ it, parent });
+
+        auto children = it->value.FindMember("Children");
+        if (children != it->value.MemberEnd() && children->value.IsObject())
+            flatten(children->value, index, spawns);
+    }
+}
+
+void GameObjectFactory::construct(Spawn& spawn)
+{
+    spawn.object = new (SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene()->GetPools().Get<GameObject>()) GameObject();
+    spawn.object->SetName(spawn.member->name.GetString());
 
     // Iterate through the components of the game object
-    const rapidjson::Value& components = member->value["Components"];
-    deserialize(components, gameObject);
-
-  
-	const rapidjson::Value& children = member->value["Children"];
-  std::vector<std::thread> threads;
-  
-    for (rapidjson::Value::ConstMemberIterator it = children.MemberBegin(); it != children.MemberEnd(); ++it)
-        threads.push_back(std::thread([this, it, gameObject]() { this->createGameObject(it, gameObject); }));
-  
-    for (auto& th : threads) 
+    const rapidjson::Value& components = spawn.member->value["Components"];
+    deserialize(components, spawn.components);
+}
+
+void GameObjectFactory::commit(std::vector<Spawn>& spawns)
+{
+    std::vector<GameObject*> objects;
+    objects.reserve(spawns.size());
+    for (Spawn& spawn : spawns)
     {
-      if (th.joinable()) 
-      { 
-        th.join(); 
-      }
+        for (ComponentSpec& spec : spawn.components)
+        {
+            if (!spec.attach)
+            {
+                std::cerr << "Unknown component type: " << spec.name << std::endl;
+                continue;
+            }
+
+            // Process component properties
+            Component* component = spec.attach(spawn.object);
+            const auto& setters = component->GetSetters();
+            for (auto& [variableName, value] : spec.values)
+                setters.at(variableName)(value);
+        }
+
+        if (spawn.parent >= 0)
+            spawns[spawn.parent].object->AddChild(spawn.object);
+        objects.push_back(spawn.object);
     }
 
-    SERVICE_LOCATOR.GetGameObjectManager()->AddGameObject(gameObject);
+    SERVICE_LOCATOR.GetGameObjectManager()->AddGameObjects(objects);
 }
 
-void GameObjectFactory::deserialize(const rapidjson::Value& components, GameObject* gameObject)
+void GameObjectFactory::deserialize(const rapidjson::Value& components, std::vector<ComponentSpec>& specs)
 {
     for (auto& comp : components.GetObject())
     {
-        std::string componentName = comp.name.GetString();
+        ComponentSpec& spec = specs.emplace_back();
+        spec.name = comp.name.GetString();
+        const std::string& componentName = spec.name;
 
-        Component* component = nullptr;
         if (componentName == GameObjectSystemComponentConstants::TRANSFORM_COMPONENT)
-            component = gameObject->AddComponent<TransformComponent>();
+            spec.attach = &attachComponent<TransformComponent>;
         else if (componentName == GameObjectSystemComponentConstants::RENDER_COMPONENT)
-            component = gameObject->AddComponent<RenderComponent>();
+            spec.attach = &attachComponent<RenderComponent>;
         else if (componentName == GameObjectSystemComponentConstants::PHYSICS_COMPONENT)
-            component = gameObject->AddComponent<PhysicsComponent>();
+            spec.attach = &attachComponent<PhysicsComponent>;
         else if (componentName == GameObjectSystemComponentConstants::COLLISION_COMPONENT)
-            component = gameObject->AddComponent<CollisionComponent>();
+            spec.attach = &attachComponent<CollisionComponent>;
         else if (componentName == GameObjectSystemComponentConstants::CONTROLLER_COMPONENT)
-            component = gameObject->AddComponent<ControllerComponent>();
+            spec.attach = &attachComponent<ControllerComponent>;
         else if (componentName == GameObjectSystemComponentConstants::SCRIPT_COMPONENT)
-            component = gameObject->AddComponent<ScriptComponent>();
+            spec.attach = &attachComponent<ScriptComponent>;
         else
         {
-            std::cerr << "Unknown component type: " << componentName << std::endl;
+            // reported when the objects are committed
+            spec.attach = nullptr;
             continue;
         }
 
-        // Process component properties
-        const auto& setters = component->GetSetters();
+        // Decode component properties, the setters are called once the component exists
         for (auto& member : comp.value.GetObject())
         {
             std::string variableName = member.name.GetString();
@@ -109,7 +271,7 @@ void GameObjectFactory::deserialize(const rapidjson::Value& components, GameObje
                         auto array = member.value[1].GetArray();
                         vec.x = array[0].GetFloat();
                         vec.y = array[1].GetFloat();
-                        setters.at(variableName)(vec);
+                        spec.values.emplace_back(variableName, vec);
                     }
                     else
                     if constexpr (std::is_same_v<T, glm::vec3>)
@@ -119,7 +281,7 @@ void GameObjectFactory::deserialize(const rapidjson::Value& components, GameObje
                         vec.x = array[0].GetFloat();
                         vec.y = array[1].GetFloat();
                         vec.z = array[2].GetFloat();
-                        setters.at(variableName)(vec);
+                        spec.values.emplace_back(variableName, vec);
                     }
 					else if constexpr (std::is_same_v<T, glm::dvec3>)
 					{
@@ -128,7 +290,7 @@ void GameObjectFactory::deserialize(const rapidjson::Value& components, GameObje
 						vec.x = array[0].GetDouble();
 						vec.y = array[1].GetDouble();
 						vec.z = array[2].GetDouble();
-						setters.at(variableName)(vec);
+						spec.values.emplace_back(variableName, vec);
 					}
                     else if constexpr (std::is_same_v<T, glm::vec4>)
                     {
@@ -138,42 +300,42 @@ void GameObjectFactory::deserialize(const rapidjson::Value& components, GameObje
                         vec.y = array[1].GetFloat();
                         vec.z = array[2].GetFloat();
                         vec.w = array[3].GetFloat();
-                        setters.at(variableName)(vec);
+                        spec.values.emplace_back(variableName, vec);
                     }
                     else if constexpr (std::is_same_v<T, std::string>)
                     {
                         std::string strValue = member.value[1].GetString();
-                        setters.at(variableName)(strValue);
+                        spec.values.emplace_back(variableName, strValue);
                     }
                     else if constexpr (std::is_same_v<T, double>)
                     {
                         double doubleValue = member.value[1].GetDouble();
-                        setters.at(variableName)(doubleValue);
+                        spec.values.emplace_back(variableName, doubleValue);
                     }
                     else if constexpr (std::is_same_v<T, float>)
                     {
                         float floatValue = member.value[1].GetFloat();
-                        setters.at(variableName)(floatValue);
+                        spec.values.emplace_back(variableName, floatValue);
                     }
                     else if constexpr (std::is_same_v<T, int>)
                     {
                         int intValue = member.value[1].GetInt();
-                        setters.at(variableName)(intValue);
+                        spec.values.emplace_back(variableName, intValue);
                     }
                     else if constexpr (std::is_same_v<T, bool>)
                     {
                         bool boolValue = member.value[1].GetBool();
-                        setters.at(variableName)(boolValue);
+                        spec.values.emplace_back(variableName, boolValue);
                     }
                     else if constexpr (std::is_same_v<T, UV_TYPE>)
                     {
                         UV_TYPE uvType = static_cast<UV_TYPE>(member.value[1].GetInt());
-                        setters.at(variableName)(uvType);
+                        spec.values.emplace_back(variableName, uvType);
                     }
                     else if constexpr (std::is_same_v<T, CollisionShape*>)
                     {
                         auto collisionShape = parseCollisionShape(member.value[1].GetObject());
-                        setters.at(variableName)(static_cast<CollisionShape*>(collisionShape));
+                        spec.values.emplace_back(variableName, static_cast<CollisionShape*>(collisionShape));
                     }
                     }, name2type->second);
             }
@@ -213,6 +375,15 @@ CollisionShape* GameObjectFactory::parseCollisionShape(const rapidjson::Value& c
                     double doubleValue = shapeMember.value[1].GetDouble();
                     shapeSetters.at(variableName)(doubleValue);
                 }
+                else if constexpr (std::is_same_v<T, glm::vec3>)
+                {
+                    glm::vec3 vec;
+                    auto array = shapeMember.value[1].GetArray();
+                    vec.x = array[0].GetFloat();
+                    vec.y = array[1].GetFloat();
+                    vec.z = array[2].GetFloat();
+                    shapeSetters.at(variableName)(vec);
+                }
                 else if constexpr (std::is_same_v<T, glm::dvec3>)
                 {
                     glm::dvec3 vec;
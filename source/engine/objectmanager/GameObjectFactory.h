@@ -1,22 +1,78 @@
 #pragma once
+class CompiledScene;
+
 class GameObjectFactory
 {
 public:
-	// @brief load in the json and create game objects based on the data loaded
-	// @param source: path of the json file 
+	// Wall-clock time spent in each stage of the last CreateAllGameObjects call
+	struct LoadStats
+	{
+		size_t objectCount = 0;
+		double parseMs = 0.0;		// flattening the json tree into the spawn list, zero for compiled scenes
+		double constructMs = 0.0;	// building the objects and decoding their components on the workers
+		double commitMs = 0.0;		// attaching components and registering the objects on the calling thread
+	};
+
+	// Game objects per job in the construct stage
+	static constexpr uint32_t CONSTRUCT_BATCH_SIZE = 32;
+
+	// @brief load in the json and create game objects based on the data loaded. Objects and children
+	// are constructed in parallel, then registered in document order so node IDs are stable
+	// @param source: path of the json file
 	void CreateAllGameObjects(const rapidjson::Value& gameObjects);
 
+	// @brief Creates the game objects of a compiled scene. Objects are constructed in parallel, then
+	// their components are attached and registered in file order, as in the json path
+	// @param scene : Opened compiled scene
+	void CreateAllGameObjects(const CompiledScene& scene);
+
+	// @brief Returns the stage timings of the last CreateAllGameObjects call
+	inline const LoadStats& GetLastLoadStats() const { return m_lastLoad; }
+
+	// @brief Loads the game objects of a scene file over and over into the current scene, scaled up to
+	// each object count, from json and from a compiled copy, and prints the load time of every stage.
+	// The current scene is emptied
+	// @param sceneSource : Path of the scene json whose game objects are repeated
+	// @param counts : Object counts to measure
+	void BenchmarkLoad(const std::string& sceneSource, std::span<const uint32_t> counts);
+
 private:
 	static GameObjectFactory* GetInstance();
 	static std::unique_ptr<GameObjectFactory> instance;
 
-	// @brief creates game object with extracted components
-	// @param member: set of component name and data 
-	void createGameObject(rapidjson::Value::ConstMemberIterator member, GameObject* pParent = nullptr);
+	// One component of a game object, decoded from json but not yet attached
+	struct ComponentSpec
+	{
+		std::string name;
+		Component* (*attach)(GameObject*);		// nullptr if the component type is unknown
+		std::vector<std::pair<std::string, std::any>> values;	// setter name and value, in file order
+	};
+
+	// One game object of the scene file. Filled by exactly one job in the construct stage
+	struct Spawn
+	{
+		rapidjson::Value::ConstMemberIterator member;
+		int32_t parent;		// index of the parent's spawn, -1 for root objects
+		GameObject* object = nullptr;
+		std::vector<ComponentSpec> components;
+	};
 
-	void deserialize(const rapidjson::Value& components, GameObject* gameObject);
+	// @brief Appends the game objects and, after each one, its children depth first
+	// @param gameObjects : Json object of game objects
+	// @param parent : Spawn index of their parent, -1 for root objects
+	// @param spawns : Spawn list to append to
+	void flatten(const rapidjson::Value& gameObjects, int32_t parent, std::vector<Spawn>& spawns);
+
+	// @brief Builds the game object of a spawn and decodes its components. Safe to run on any thread
+	void construct(Spawn& spawn);
+
+	// @brief Attaches the decoded components, links children and registers every object in spawn order
+	void commit(std::vector<Spawn>& spawns);
+
+	void deserialize(const rapidjson::Value& components, std::vector<ComponentSpec>& specs);
 	CollisionShape* parseCollisionShape(const rapidjson::Value& collisionShapeData);
-	
+
+	LoadStats m_lastLoad;
+
 	friend class ServiceLocator;
 };
-
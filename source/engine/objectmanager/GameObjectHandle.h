@@ -0,0 +1,18 @@
+#pragma once
+
+// Weak reference to a game object registered in the GameObjectManager. The generation
+// changes every time a slot is reused, so a handle to a deleted object resolves to nullptr
+// instead of to whatever object took its place
+struct GameObjectHandle
+{
+	static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+	uint32_t index = INVALID_INDEX;		// Slot in the GameObjectManager
+	uint32_t generation = 0;			// Generation of the slot when the handle was issued
+
+	//@brief Returns whether the handle was ever assigned (it can still be stale)
+	inline bool IsNull() const { return index == INVALID_INDEX; }
+
+	inline bool operator==(const GameObjectHandle& other) const { return index == other.index && generation == other.generation; }
+	inline bool operator!=(const GameObjectHandle& other) const { return !(*this == other); }
+};
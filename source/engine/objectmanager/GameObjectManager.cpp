@@ -18,8 +18,7 @@ GameObjectManager::~GameObjectManager()
 	for (auto& go : m_gameObjects)
 		go->Destroy();
 
-	m_gameObjects.clear();
-	m_gameObjectMap.clear();
+	Clear();
 }
 
 void GameObjectManager::Init()
@@ -48,25 +47,140 @@ void GameObjectManager::Shutdown()
 	std::cout << "GameObjectManager Shutdown" << std::endl;
 }
 
-void GameObjectManager::AddGameObject(GameObject* object)
+GameObjectHandle GameObjectManager::AddGameObject(GameObject* object)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return insert(object);
+}
+
+void GameObjectManager::AddGameObjects(std::span<GameObject* const> objects)
 {
-	SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene()->AddNode(object);
-	m_gameObjectMap[object->GetName()] = m_gameObjects.size();
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_gameObjects.reserve(m_gameObjects.size() + objects.size());
+	m_denseToSlot.reserve(m_denseToSlot.size() + objects.size());
+	m_slots.reserve(m_slots.size() + objects.size());
+	for (GameObject* object : objects)
+		insert(object);
+}
+
+GameObjectHandle GameObjectManager::insert(GameObject* object)
+{
+	// children are reached through their parent, only roots are scene nodes
+	if (!object->GetParent())
+		SERVICE_LOCATOR.GetSceneManager()->GetCurrentScene()->AddNode(object);
+
+	uint32_t index;
+	if (!m_freeSlots.empty())
+	{
+		index = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		index = static_cast<uint32_t>(m_slots.size());
+		m_slots.push_back(Slot{ nullptr, 0, 0 });
+	}
+
+	Slot& slot = m_slots[index];
+	slot.object = object;
+	slot.denseIndex = static_cast<uint32_t>(m_gameObjects.size());
 	m_gameObjects.push_back(object);
+	m_denseToSlot.push_back(index);
+
+	GameObjectHandle handle{ index, slot.generation };
+	object->SetHandle(handle);
+	m_gameObjectMap[object->GetName()] = handle;
+	MarkStructureChanged();
+	return handle;
+}
+
+void GameObjectManager::Clear()
+{
+	// the objects may already be gone, so only the slots are touched
+	m_freeSlots.clear();
+	for (uint32_t index = 0; index < m_slots.size(); ++index)
+	{
+		Slot& slot = m_slots[index];
+		if (slot.object)
+		{
+			slot.object = nullptr;
+			++slot.generation;
+		}
+		m_freeSlots.push_back(index);
+	}
+	m_gameObjects.clear();
+	m_denseToSlot.clear();
+	m_gameObjectMap.clear();
+	m_queries.clear();
+	MarkStructureChanged();
 }
 
 void GameObjectManager::DeleteGameObject(GameObject* object)
 {
+	if (GetGameObject(object->GetHandle()) != object)
+		return;
+
 	object->Destroy();
-	size_t index = m_gameObjectMap[object->GetName()];
-	auto last = m_gameObjects.back();
-	if (index != m_gameObjects.size() - 1)
+	Forget(object);
+}
+
+void GameObjectManager::Forget(GameObject* object)
+{
+	GameObjectHandle handle = object->GetHandle();
+	if (GetGameObject(handle) != object)
+		return;
+
+	auto it = m_gameObjectMap.find(object->GetName());
+	if (it != m_gameObjectMap.end() && it->second == handle)
+		m_gameObjectMap.erase(it);
+	releaseSlot(handle.index);
+}
+
+GameObject* GameObjectManager::GetGameObject(const std::string& name) const
+{
+	auto it = m_gameObjectMap.find(name);
+	if (it == m_gameObjectMap.end())
+		return nullptr;
+	return GetGameObject(it->second);
+}
+
+std::span<GameObject* const> GameObjectManager::query(const ComponentRegistry::Signature& signature)
+{
+	const uint64_t version = m_structureVersion.load(std::memory_order_relaxed);
+	auto [it, inserted] = m_queries.try_emplace(signature);
+	QueryCache& cache = it->second;
+	if (inserted || cache.version != version)
 	{
-		m_gameObjects[index] = last;
-		m_gameObjectMap[last->GetName()] = index;
+		cache.objects.clear();
+		for (GameObject* object : m_gameObjects)
+		{
+			if ((object->GetSignature() & signature) == signature)
+				cache.objects.push_back(object);
+		}
+		cache.version = version;
 	}
+	return cache.objects;
+}
+
+void GameObjectManager::releaseSlot(uint32_t index)
+{
+	Slot& slot = m_slots[index];
+	GameObject* object = slot.object;
+	object->SetHandle(GameObjectHandle{});
+
+	// keep the objects packed by moving the last one into the hole
+	uint32_t dense = slot.denseIndex;
+	uint32_t lastSlot = m_denseToSlot.back();
+	m_gameObjects[dense] = m_gameObjects.back();
+	m_denseToSlot[dense] = lastSlot;
+	m_slots[lastSlot].denseIndex = dense;
 	m_gameObjects.pop_back();
-	m_gameObjectMap.erase(object->GetName());
+	m_denseToSlot.pop_back();
+
+	slot.object = nullptr;
+	++slot.generation;
+	m_freeSlots.push_back(index);
+	MarkStructureChanged();
 }
 
 
@@ -23,20 +23,56 @@ public:
 
 	//@brief Adds game object to the list
 	//@param object : GameObject to add
-	void AddGameObject(GameObject* object);
+	//@return GameObjectHandle : Handle of the game object
+	GameObjectHandle AddGameObject(GameObject* object);
+
+	//@brief Adds a batch of game objects under a single lock, in the given order
+	//@param objects : GameObjects to add, children after their parents
+	void AddGameObjects(std::span<GameObject* const> objects);
+
+	//@brief Forgets all game objects without deleting them (their scene releases them)
+	void Clear();
 
 	//@brief Deletes the game object from the list
 	//@param object : GameObject to delete
 	void DeleteGameObject(GameObject* object);
 
+	//@brief Forgets a game object without deleting it (its scene releases it), retiring its handles
+	//@param object : GameObject to forget, ignored if it is not registered
+	void Forget(GameObject* object);
+
 	//@brief Searches for the game object by name
 	//@param name : Name of the game object
-	//@return GameObject* : Game object
-    inline GameObject* GetGameObject(const std::string name) { return m_gameObjects[m_gameObjectMap[name]]; }
+	//@return GameObject* : Game object, nullptr if no object has that name
+	GameObject* GetGameObject(const std::string& name) const;
+
+	//@brief Resolves a handle in constant time
+	//@param handle : Handle returned by AddGameObject
+	//@return GameObject* : Game object, nullptr if the object was deleted since
+	inline GameObject* GetGameObject(GameObjectHandle handle) const
+	{
+		if (handle.index >= m_slots.size() || m_slots[handle.index].generation != handle.generation)
+			return nullptr;
+		return m_slots[handle.index].object;
+	}
+
+	//@brief Returns a view of all game objects, valid until the next object is added or deleted
+	//@return std::span<GameObject* const> : Game objects
+	inline std::span<GameObject* const> GetGameObjects() const { return m_gameObjects; }
+
+	//@brief Returns a view of the game objects that have all the given components. The result is
+	// cached and only rebuilt after objects or components were added or removed
+	//@return std::span<GameObject* const> : Matching game objects, valid until the next structural change
+	template <typename... DataTypes>
+	std::span<GameObject* const> Query()
+	{
+		ComponentRegistry::Signature signature;
+		(signature.set(ComponentRegistry::GetID<DataTypes>()), ...);
+		return query(signature);
+	}
 
-	//@brief Returns the list of game objects
-	//@return std::vector<GameObject*> : List of game objects
-	inline const std::vector<GameObject*> GetGameObjects() { return m_gameObjects; }
+	//@brief Invalidates the cached queries, called when a game object gains or loses a component
+	inline void MarkStructureChanged() { m_structureVersion.fetch_add(1, std::memory_order_relaxed); }
 
 	const glm::mat4 GetShadowMatrix(glm::mat4 worldProj)
 	{
@@ -82,9 +118,39 @@ private:
 
 
 
-	// Allow adding, seraching and deleting game objects by name in constant time while mantaining the order of the game objects in memory
-	std::unordered_map<std::string, size_t> m_gameObjectMap;
+	struct Slot
+	{
+		GameObject* object;		// nullptr while the slot is free
+		uint32_t generation;	// bumped whenever the object in the slot is removed
+		uint32_t denseIndex;	// position of the object in m_gameObjects
+	};
+
+	struct QueryCache
+	{
+		std::vector<GameObject*> objects;
+		uint64_t version;		// m_structureVersion the result was built for
+	};
+
+	//@brief Returns the cached result for a component signature, rebuilding it if stale
+	std::span<GameObject* const> query(const ComponentRegistry::Signature& signature);
+
+	//@brief Registers the game object, and adds it to the scene unless it is a child. Expects m_mutex to be held
+	//@return GameObjectHandle : Handle of the game object
+	GameObjectHandle insert(GameObject* object);
+
+	//@brief Removes the game object in the slot and retires the slot's handles
+	void releaseSlot(uint32_t index);
+
+	// Handles index the slots; the objects themselves are kept packed for iteration
+	std::vector<Slot> m_slots;
+	std::vector<uint32_t> m_freeSlots;
 	std::vector<GameObject*> m_gameObjects;
+	std::vector<uint32_t> m_denseToSlot;
+	std::unordered_map<std::string, GameObjectHandle> m_gameObjectMap;
+
+	std::unordered_map<ComponentRegistry::Signature, QueryCache> m_queries;
+	std::atomic<uint64_t> m_structureVersion{ 0 };
+	std::mutex m_mutex;		// game objects are added from the loader threads
 
 	friend class ServiceLocator;
 };
@@ -0,0 +1,132 @@
+#include "../pch.h"
+#include "PoolAllocator.h"
+
+// ****** PoolAllocator ****** //
+#pragma region PoolAllocator
+PoolAllocator::PoolAllocator(std::string name, size_t objectSize, size_t slotsPerPage)
+	: m_name(std::move(name)), m_objectSize(objectSize),
+	m_slotSize(HEADER_SIZE + (objectSize + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT),
+	m_slotsPerPage(std::max<size_t>(slotsPerPage, 1)), m_freeList(nullptr), m_releasing(false),
+	m_liveObjects(0), m_peakObjects(0), m_totalAllocations(0)
+{
+}
+
+PoolAllocator::~PoolAllocator()
+{
+	Release();
+}
+
+void* PoolAllocator::Allocate()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (!m_freeList)
+		addPage();
+
+	Header* header = m_freeList;
+	m_freeList = header->next;
+	header->owner = this;
+
+	++m_totalAllocations;
+	m_peakObjects = std::max(m_peakObjects, ++m_liveObjects);
+	return reinterpret_cast<std::byte*>(header) + HEADER_SIZE;
+}
+
+void PoolAllocator::Free(void* object)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	// the pages are about to be dropped as a whole
+	if (m_releasing)
+		return;
+
+	Header* header = reinterpret_cast<Header*>(static_cast<std::byte*>(object) - HEADER_SIZE);
+	assert(header->owner == this && "Object does not belong to this pool");
+	header->next = m_freeList;
+	m_freeList = header;
+	--m_liveObjects;
+}
+
+void PoolAllocator::Reserve(size_t count)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	while (m_pages.size() * m_slotsPerPage < count)
+		addPage();
+}
+
+void PoolAllocator::BeginRelease()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_releasing = true;
+}
+
+void PoolAllocator::Release()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (std::byte* page : m_pages)
+		::operator delete(page, std::align_val_t(SLOT_ALIGNMENT));
+
+	m_pages.clear();
+	m_freeList = nullptr;
+	m_liveObjects = 0;
+	m_releasing = false;
+}
+
+PoolAllocator::Stats PoolAllocator::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return Stats{ m_name, m_objectSize, m_slotSize, m_liveObjects, m_peakObjects, m_totalAllocations,
+		m_pages.size(), m_pages.size() * m_slotsPerPage * m_slotSize };
+}
+
+PoolAllocator* PoolAllocator::GetOwner(void* object)
+{
+	return reinterpret_cast<Header*>(static_cast<std::byte*>(object) - HEADER_SIZE)->owner;
+}
+
+void PoolAllocator::addPage()
+{
+	std::byte* page = static_cast<std::byte*>(::operator new(m_slotSize * m_slotsPerPage, std::align_val_t(SLOT_ALIGNMENT)));
+	m_pages.push_back(page);
+
+	// thread the new slots onto the free list in address order
+	for (size_t i = m_slotsPerPage; i-- > 0;)
+	{
+		Header* header = reinterpret_cast<Header*>(page + i * m_slotSize);
+		header->next = m_freeList;
+		m_freeList = header;
+	}
+}
+#pragma endregion
+
+// ****** PooledObject ****** //
+#pragma region PooledObject
+void* PooledObject::operator new(size_t size)
+{
+	// heap allocations carry an empty header so delete can tell them apart
+	std::byte* memory = static_cast<std::byte*>(::operator new(PoolAllocator::HEADER_SIZE + size, std::align_val_t(PoolAllocator::SLOT_ALIGNMENT)));
+	*reinterpret_cast<PoolAllocator**>(memory) = nullptr;
+	return memory + PoolAllocator::HEADER_SIZE;
+}
+
+void* PooledObject::operator new(size_t size, PoolAllocator& pool)
+{
+	assert(size <= pool.GetObjectSize() && "Object is larger than the slots of the pool");
+	return pool.Allocate();
+}
+
+void PooledObject::operator delete(void* object)
+{
+	if (!object)
+		return;
+
+	if (PoolAllocator* pool = PoolAllocator::GetOwner(object))
+		pool->Free(object);
+	else
+		::operator delete(static_cast<std::byte*>(object) - PoolAllocator::HEADER_SIZE, std::align_val_t(PoolAllocator::SLOT_ALIGNMENT));
+}
+
+void PooledObject::operator delete(void* object, PoolAllocator& pool)
+{
+	// only called when a constructor throws
+	pool.Free(object);
+}
+#pragma endregion
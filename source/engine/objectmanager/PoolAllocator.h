@@ -0,0 +1,104 @@
+#pragma once
+
+// Slab allocator handing out fixed-size slots for one object type. Slots are carved from
+// pages of SlotsPerPage objects; freed slots go on an intrusive free list, and Release
+// drops every page at once without visiting the objects
+class PoolAllocator
+{
+public:
+	// Every slot starts with a header telling operator delete which pool the object came from
+	static constexpr size_t HEADER_SIZE = 16;
+	static constexpr size_t SLOT_ALIGNMENT = 16;
+	static constexpr size_t DEFAULT_SLOTS_PER_PAGE = 256;
+
+	struct Stats
+	{
+		std::string_view name;		// Type the pool was created for
+		size_t objectSize;			// sizeof the type
+		size_t slotSize;			// Bytes per slot, header included
+		size_t liveObjects;			// Objects currently allocated
+		size_t peakObjects;			// Highest liveObjects seen
+		size_t totalAllocations;	// Allocations since the pool was created
+		size_t pages;				// Pages currently held
+		size_t reservedBytes;		// Bytes currently held in pages
+	};
+
+	//@param name : Name of the pooled type, used for statistics
+	//@param objectSize : sizeof the pooled type
+	//@param slotsPerPage : Number of objects per page
+	PoolAllocator(std::string name, size_t objectSize, size_t slotsPerPage = DEFAULT_SLOTS_PER_PAGE);
+	~PoolAllocator();
+
+	PoolAllocator(const PoolAllocator&) = delete;
+	PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+	//@brief Returns memory for one object
+	//@return void* : Uninitialized memory of at least objectSize bytes
+	void* Allocate();
+
+	//@brief Returns the slot of an object to the free list (no-op while the pool is being released)
+	//@param object : Memory returned by Allocate
+	void Free(void* object);
+
+	//@brief Makes sure count objects fit without allocating new pages
+	//@param count : Number of objects
+	void Reserve(size_t count);
+
+	//@brief Makes Free a no-op so a whole scene can be destroyed before its pages are dropped
+	void BeginRelease();
+
+	//@brief Drops every page at once, objects still living in them are not destroyed
+	void Release();
+
+	//@brief Returns the allocation statistics of the pool
+	Stats GetStats() const;
+
+	//@brief Returns the largest object size the slots can hold
+	inline size_t GetObjectSize() const { return m_objectSize; }
+
+	//@brief Returns the pool an object was allocated from
+	//@param object : Object created through PooledObject
+	//@return PoolAllocator* : The owning pool, nullptr for objects on the global heap
+	static PoolAllocator* GetOwner(void* object);
+
+private:
+	union Header
+	{
+		PoolAllocator* owner;	// while allocated
+		Header* next;			// while on the free list
+	};
+	static_assert(sizeof(Header) <= HEADER_SIZE, "Slot header does not fit");
+
+	//@brief Allocates a new page and puts its slots on the free list (lock held)
+	void addPage();
+
+	std::string m_name;
+	size_t m_objectSize;
+	size_t m_slotSize;
+	size_t m_slotsPerPage;
+
+	std::vector<std::byte*> m_pages;
+	Header* m_freeList;
+	bool m_releasing;
+
+	size_t m_liveObjects;
+	size_t m_peakObjects;
+	size_t m_totalAllocations;
+
+	mutable std::mutex m_mutex;		// game objects are created from the loader threads
+};
+
+// Base for types that can be placed in a PoolAllocator. Objects created with
+// new (pool) T(...) live in the pool, a plain new T(...) still goes to the global heap,
+// and delete works for both because every allocation carries the owner header
+class PooledObject
+{
+public:
+	static void* operator new(size_t size);
+	static void* operator new(size_t size, PoolAllocator& pool);
+	static void* operator new(size_t, void* where) { return where; }
+
+	static void operator delete(void* object);
+	static void operator delete(void* object, PoolAllocator& pool);
+	static void operator delete(void*, void*) {}
+};
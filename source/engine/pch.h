@@ -24,6 +24,11 @@
 #include <array>
 #include <random>
 #include <memory>
+#include <bitset>
+#include <atomic>
+#include <span>
+#include <mutex>
+#include <deque>
 //-----------------------
 // ImGui Library Headers
 //-----------------------
@@ -41,6 +46,7 @@
 #include "glm/mat4x4.hpp" 
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include "glm/gtc/matrix_transform.inl" //Rotate
 #include "glm/gtx/euler_angles.hpp"
 #include <glm/gtc/constants.hpp>
@@ -79,6 +85,8 @@
 #include "objectmanager/GameObjectSystemComponentConstants.h"
 #include "Time.h"
 #include "Random.h"
+#include "jobs/JobSystem.h"
+#include "jobs/TaskGraph.h"
 //-----------------------
 // Event Headers
 //-----------------------
@@ -87,12 +95,19 @@
 // Renderer Headers
 //-----------------------
 #include "Window.h"
+#include "UniformBuffer.h"
 #include "Shader.h"
 #include "Texture.h"
 #include "Material.h"
+#include "Frustum.h"
 #include "Geometry.h"
+#include "objectmanager/ComponentStorage.h"
+#include "TransformStorage.h"
 #include "Transform.h"
+#include "objectmanager/PoolAllocator.h"
+#include "scenemanager/ScenePools.h"
 #include "scenemanager/Scene.h"
+#include "RenderQueue.h"
 #include "Renderer.h"
 #include "Quaternion.h"
 #include "VQS.h"
@@ -103,14 +118,26 @@
 // Physics Headers
 //-----------------------
 #include "ParticleSystem.h"
+#include "physics/PhysicsPrecision.h"
+#include "physics/AABB.h"
+#include "physics/Broadphase.h"
+#include "physics/AABBTree.h"
+#include "physics/SweepAndPrune.h"
 #include "physics/CollisionShape.h"
 #include "physics/CollisionShape_Sphere.h"
 #include "physics/CollisionShape_Cuboid.h"
+#include "physics/ContactManifold.h"
 #include "physics/CollisionChecks.h"
+#include "physics/Narrowphase.h"
+#include "physics/CollisionQuery.h"
 #include "physics/CollisionManager.h"
+#include "physics/PhysicsBodyStorage.h"
+#include "physics/ContactSolver.h"
 //-----------------------
 // GameObject Headers
 //-----------------------
+#include "ComponentRegistry.h"
+#include "objectmanager/GameObjectHandle.h"
 #include "Node.h"
 #include "GameObject.h"
 #include "Component.h"
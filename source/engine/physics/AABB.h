@@ -0,0 +1,57 @@
+#pragma once
+
+// Axis-aligned bounding box in world space, what the broadphase sorts and tests colliders by
+struct AABB
+{
+	PhysicsVec3 min{ 0.0 };
+	PhysicsVec3 max{ 0.0 };
+
+	//@brief Returns whether the boxes overlap, touching boxes count as overlapping
+	inline bool Overlaps(const AABB& other) const
+	{
+		return min.x <= other.max.x && other.min.x <= max.x
+			&& min.y <= other.max.y && other.min.y <= max.y
+			&& min.z <= other.max.z && other.min.z <= max.z;
+	}
+
+	//@brief Returns whether other lies entirely inside this box
+	inline bool Contains(const AABB& other) const
+	{
+		return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::greaterThanEqual(max, other.max));
+	}
+
+	//@brief Returns the smallest box enclosing both boxes
+	inline AABB Merged(const AABB& other) const { return { glm::min(min, other.min), glm::max(max, other.max) }; }
+
+	//@brief Returns the box grown by margin on every side
+	inline AABB Expanded(PhysicsReal margin) const { return { min - margin, max + margin }; }
+
+	//@brief Returns whether the segment origin + t * delta enters the box for some t in [0, maxFraction]
+	//@param inverseDelta : 1 / delta per component, infinite where delta is 0
+	inline bool RayOverlaps(const PhysicsVec3& origin, const PhysicsVec3& inverseDelta, PhysicsReal maxFraction) const
+	{
+		PhysicsReal enter = 0.0;
+		PhysicsReal exit = maxFraction;
+		for (int i = 0; i < 3; ++i)
+		{
+			if (std::isinf(inverseDelta[i]))
+			{
+				if (origin[i] < min[i] || origin[i] > max[i])
+					return false;
+				continue;
+			}
+			PhysicsReal t1 = (min[i] - origin[i]) * inverseDelta[i];
+			PhysicsReal t2 = (max[i] - origin[i]) * inverseDelta[i];
+			enter = std::max(enter, std::min(t1, t2));
+			exit = std::min(exit, std::max(t1, t2));
+		}
+		return enter <= exit;
+	}
+
+	//@brief Returns half the surface area, the cost the AABB tree minimizes
+	inline PhysicsReal HalfArea() const
+	{
+		PhysicsVec3 size = max - min;
+		return size.x * size.y + size.y * size.z + size.z * size.x;
+	}
+};
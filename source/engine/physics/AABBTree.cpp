@@ -0,0 +1,389 @@
+#include "../pch.h"
+#include "AABBTree.h"
+
+// ****** Proxies ****** //
+#pragma region Proxies
+Broadphase::ProxyId AABBTree::CreateProxy(const AABB& bounds, void* userData, GroupId group)
+{
+	assert(group < m_groupCount);
+	if (group >= m_roots.size())
+		m_roots.resize(group + 1, NULL_NODE);
+
+	int32_t leaf = allocateNode();
+	m_nodes[leaf].bounds = bounds.Expanded(FAT_MARGIN);
+	m_nodes[leaf].userData = userData;
+	m_nodes[leaf].height = 0;
+	m_nodes[leaf].group = group;
+	insertLeaf(leaf);
+	markMoved(leaf);
+	++m_proxyCount;
+	return static_cast<ProxyId>(leaf);
+}
+
+void AABBTree::DestroyProxy(ProxyId proxy)
+{
+	// Pairs and moved entries still naming the proxy are dropped by the next FindPairs
+	int32_t leaf = static_cast<int32_t>(proxy);
+	removeLeaf(leaf);
+	freeNode(leaf);
+	--m_proxyCount;
+}
+
+void AABBTree::MoveProxy(ProxyId proxy, const AABB& bounds)
+{
+	int32_t leaf = static_cast<int32_t>(proxy);
+	const AABB& fatBounds = m_nodes[leaf].bounds;
+
+	// Inside its fat bounds the proxy stays put, unless it shrank so far that they would report stale pairs
+	if (fatBounds.Contains(bounds) && bounds.Expanded(4.0 * FAT_MARGIN).Contains(fatBounds))
+		return;
+
+	removeLeaf(leaf);
+	m_nodes[leaf].bounds = bounds.Expanded(FAT_MARGIN);
+	insertLeaf(leaf);
+	markMoved(leaf);
+}
+
+void AABBTree::FindPairs(std::vector<Pair>& pairs)
+{
+	m_stats = {};
+	m_stats.proxies = m_proxyCount;
+
+	// Pairs between proxies that kept their fat bounds still overlap. The others are dropped once
+	// a proxy is destroyed, or retested, and the moved proxies find their new pairs below. A proxy
+	// made in a node freed since the last call may be of a group its old pairs cannot pair with
+	std::erase_if(m_pairs, [this](const Pair& pair)
+		{
+			const Node& node1 = m_nodes[pair.first];
+			const Node& node2 = m_nodes[pair.second];
+			if (node1.height != 0 || node2.height != 0)
+				return true;
+			if (!node1.moved && !node2.moved)
+				return false;
+			if (!CanPair(node1.group, node2.group))
+				return true;
+			++m_stats.boundsTests;
+			return !node1.bounds.Overlaps(node2.bounds);
+		});
+
+	for (ProxyId proxy : m_movedProxies)
+	{
+		const Node& node = m_nodes[proxy];
+		if (node.height != 0 || !node.moved)
+			continue;
+		++m_stats.movedProxies;
+		for (GroupId group = 0; group < m_roots.size(); ++group)
+		{
+			if (!CanPair(node.group, group))
+				continue;
+			m_stats.boundsTests += queryTree(m_roots[group], node.bounds, [this, proxy](ProxyId other)
+				{
+					// When both moved, the pair is reported by the query of the smaller id
+					if (other != proxy && !(m_nodes[other].moved && other < proxy))
+						m_pairs.emplace_back(std::min(proxy, other), std::max(proxy, other));
+					return true;
+				});
+		}
+	}
+
+	for (ProxyId proxy : m_movedProxies)
+		m_nodes[proxy].moved = false;
+	m_movedProxies.clear();
+
+	// Pairs kept above are found again when one side moved without leaving the other's bounds
+	std::sort(m_pairs.begin(), m_pairs.end());
+	m_pairs.erase(std::unique(m_pairs.begin(), m_pairs.end()), m_pairs.end());
+
+	pairs.assign(m_pairs.begin(), m_pairs.end());
+	m_stats.pairs = static_cast<uint32_t>(pairs.size());
+}
+
+int32_t AABBTree::GetHeight() const
+{
+	int32_t height = 0;
+	for (int32_t root : m_roots)
+	{
+		if (root != NULL_NODE)
+			height = std::max(height, m_nodes[root].height);
+	}
+	return height;
+}
+
+void AABBTree::query(const AABB& bounds, QueryCallback callback, void* context) const
+{
+	bool stopped = false;
+	for (int32_t root : m_roots)
+	{
+		queryTree(root, bounds, [callback, context, &stopped](ProxyId proxy)
+			{
+				stopped = !callback(context, proxy);
+				return !stopped;
+			});
+		if (stopped)
+			return;
+	}
+}
+
+void AABBTree::rayCast(const PhysicsVec3& origin, const PhysicsVec3& delta, RayCastCallback callback, void* context) const
+{
+	// Every hit clips the segment, so subtrees beyond the nearest hit so far are skipped, in the
+	// trees of the other groups too
+	const PhysicsVec3 inverseDelta = inverse(delta);
+	PhysicsReal maxFraction = 1.0;
+	int32_t stack[QUERY_STACK_SIZE];
+	uint32_t count = 0;
+	for (int32_t root : m_roots)
+	{
+		if (root != NULL_NODE)
+		{
+			assert(count < QUERY_STACK_SIZE / 2);
+			stack[count++] = root;
+		}
+	}
+	while (count > 0 && maxFraction > 0.0)
+	{
+		const int32_t index = stack[--count];
+		const Node& node = m_nodes[index];
+		if (!node.bounds.RayOverlaps(origin, inverseDelta, maxFraction))
+			continue;
+
+		if (node.IsLeaf())
+		{
+			maxFraction = std::min(maxFraction, callback(context, static_cast<ProxyId>(index), maxFraction));
+		}
+		else
+		{
+			assert(count + 2 <= QUERY_STACK_SIZE);
+			stack[count++] = node.child1;
+			stack[count++] = node.child2;
+		}
+	}
+}
+
+void AABBTree::markMoved(int32_t leaf)
+{
+	if (m_nodes[leaf].moved)
+		return;
+	m_nodes[leaf].moved = true;
+	m_movedProxies.push_back(static_cast<ProxyId>(leaf));
+}
+#pragma endregion
+
+// ****** Tree ****** //
+#pragma region Tree
+int32_t AABBTree::allocateNode()
+{
+	if (m_freeList == NULL_NODE)
+	{
+		m_nodes.emplace_back();
+		return static_cast<int32_t>(m_nodes.size() - 1);
+	}
+	int32_t node = m_freeList;
+	m_freeList = m_nodes[node].parent;
+	m_nodes[node] = Node();
+	return node;
+}
+
+void AABBTree::freeNode(int32_t node)
+{
+	m_nodes[node] = Node();
+	m_nodes[node].parent = m_freeList;
+	m_freeList = node;
+}
+
+void AABBTree::insertLeaf(int32_t leaf)
+{
+	const GroupId group = m_nodes[leaf].group;
+	int32_t& root = m_roots[group];
+	if (root == NULL_NODE)
+	{
+		root = leaf;
+		m_nodes[leaf].parent = NULL_NODE;
+		return;
+	}
+
+	// Descend towards the cheapest sibling. Pairing with a node costs the area of the new parent,
+	// and every ancestor above it grows by the same amount whichever child the leaf goes under
+	const AABB leafBounds = m_nodes[leaf].bounds;
+	int32_t index = root;
+	while (!m_nodes[index].IsLeaf())
+	{
+		const Node& node = m_nodes[index];
+		PhysicsReal area = node.bounds.HalfArea();
+		PhysicsReal combinedArea = node.bounds.Merged(leafBounds).HalfArea();
+		PhysicsReal cost = 2.0 * combinedArea;
+		PhysicsReal inheritanceCost = 2.0 * (combinedArea - area);
+
+		auto descendCost = [&](int32_t child)
+			{
+				const Node& childNode = m_nodes[child];
+				PhysicsReal merged = childNode.bounds.Merged(leafBounds).HalfArea();
+				return childNode.IsLeaf() ? merged + inheritanceCost : merged - childNode.bounds.HalfArea() + inheritanceCost;
+			};
+		PhysicsReal cost1 = descendCost(node.child1);
+		PhysicsReal cost2 = descendCost(node.child2);
+
+		if (cost < cost1 && cost < cost2)
+			break;
+		index = cost1 < cost2 ? node.child1 : node.child2;
+	}
+
+	int32_t sibling = index;
+	int32_t oldParent = m_nodes[sibling].parent;
+	int32_t newParent = allocateNode();
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].bounds = leafBounds.Merged(m_nodes[sibling].bounds);
+	m_nodes[newParent].height = m_nodes[sibling].height + 1;
+	m_nodes[newParent].child1 = sibling;
+	m_nodes[newParent].child2 = leaf;
+	m_nodes[newParent].group = group;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	if (oldParent == NULL_NODE)
+		root = newParent;
+	else if (m_nodes[oldParent].child1 == sibling)
+		m_nodes[oldParent].child1 = newParent;
+	else
+		m_nodes[oldParent].child2 = newParent;
+
+	refit(newParent);
+}
+
+void AABBTree::removeLeaf(int32_t leaf)
+{
+	int32_t& root = m_roots[m_nodes[leaf].group];
+	if (leaf == root)
+	{
+		root = NULL_NODE;
+		return;
+	}
+
+	int32_t parent = m_nodes[leaf].parent;
+	int32_t grandParent = m_nodes[parent].parent;
+	int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+	m_nodes[sibling].parent = grandParent;
+	if (grandParent == NULL_NODE)
+		root = sibling;
+	else if (m_nodes[grandParent].child1 == parent)
+		m_nodes[grandParent].child1 = sibling;
+	else
+		m_nodes[grandParent].child2 = sibling;
+
+	freeNode(parent);
+	m_nodes[leaf].parent = NULL_NODE;
+	refit(grandParent);
+}
+
+void AABBTree::refit(int32_t node)
+{
+	while (node != NULL_NODE)
+	{
+		node = balance(node);
+		Node& current = m_nodes[node];
+		const Node& child1 = m_nodes[current.child1];
+		const Node& child2 = m_nodes[current.child2];
+		current.height = 1 + std::max(child1.height, child2.height);
+		current.bounds = child1.bounds.Merged(child2.bounds);
+		node = current.parent;
+	}
+}
+
+int32_t AABBTree::balance(int32_t iA)
+{
+	Node& A = m_nodes[iA];
+	if (A.IsLeaf() || A.height < 2)
+		return iA;
+
+	int32_t iB = A.child1;
+	int32_t iC = A.child2;
+	Node& B = m_nodes[iB];
+	Node& C = m_nodes[iC];
+	int32_t difference = C.height - B.height;
+
+	// Rotate C up, A keeps B and takes the shorter child of C
+	if (difference > 1)
+	{
+		int32_t iF = C.child1;
+		int32_t iG = C.child2;
+		Node& F = m_nodes[iF];
+		Node& G = m_nodes[iG];
+
+		C.child1 = iA;
+		C.parent = A.parent;
+		A.parent = iC;
+		if (C.parent == NULL_NODE)
+			m_roots[A.group] = iC;
+		else if (m_nodes[C.parent].child1 == iA)
+			m_nodes[C.parent].child1 = iC;
+		else
+			m_nodes[C.parent].child2 = iC;
+
+		if (F.height > G.height)
+		{
+			C.child2 = iF;
+			A.child2 = iG;
+			G.parent = iA;
+			A.bounds = B.bounds.Merged(G.bounds);
+			C.bounds = A.bounds.Merged(F.bounds);
+			A.height = 1 + std::max(B.height, G.height);
+			C.height = 1 + std::max(A.height, F.height);
+		}
+		else
+		{
+			C.child2 = iG;
+			A.child2 = iF;
+			F.parent = iA;
+			A.bounds = B.bounds.Merged(F.bounds);
+			C.bounds = A.bounds.Merged(G.bounds);
+			A.height = 1 + std::max(B.height, F.height);
+			C.height = 1 + std::max(A.height, G.height);
+		}
+		return iC;
+	}
+
+	// Rotate B up, A keeps C and takes the shorter child of B
+	if (difference < -1)
+	{
+		int32_t iD = B.child1;
+		int32_t iE = B.child2;
+		Node& D = m_nodes[iD];
+		Node& E = m_nodes[iE];
+
+		B.child1 = iA;
+		B.parent = A.parent;
+		A.parent = iB;
+		if (B.parent == NULL_NODE)
+			m_roots[A.group] = iB;
+		else if (m_nodes[B.parent].child1 == iA)
+			m_nodes[B.parent].child1 = iB;
+		else
+			m_nodes[B.parent].child2 = iB;
+
+		if (D.height > E.height)
+		{
+			B.child2 = iD;
+			A.child1 = iE;
+			E.parent = iA;
+			A.bounds = C.bounds.Merged(E.bounds);
+			B.bounds = A.bounds.Merged(D.bounds);
+			A.height = 1 + std::max(C.height, E.height);
+			B.height = 1 + std::max(A.height, D.height);
+		}
+		else
+		{
+			B.child2 = iE;
+			A.child1 = iD;
+			D.parent = iA;
+			A.bounds = C.bounds.Merged(D.bounds);
+			B.bounds = A.bounds.Merged(E.bounds);
+			A.height = 1 + std::max(C.height, D.height);
+			B.height = 1 + std::max(A.height, E.height);
+		}
+		return iB;
+	}
+
+	return iA;
+}
+#pragma endregion
@@ -0,0 +1,117 @@
+#pragma once
+
+// Dynamic bounding volume tree. Every proxy is a leaf holding its bounds grown by FAT_MARGIN,
+// internal nodes hold the union of their children. Leaves are inserted where they grow the
+// tree's surface area least and the tree is rebalanced by rotations on the way back up.
+// A proxy is only reinserted once its collider leaves the fat bounds, so colliders that sit
+// still or jitter cost nothing, and FindPairs only queries the tree for proxies that were
+// reinserted, keeping the pairs of everything else from the previous call. Each group of proxies
+// has a tree of its own, and a moved proxy only queries the trees of groups it can pair with
+class AABBTree : public Broadphase
+{
+public:
+	// Distance the stored bounds extend past the collider on every side
+	static constexpr PhysicsReal FAT_MARGIN = 0.1;
+
+	inline BroadphaseType GetType() const override { return BroadphaseType::AABB_TREE; }
+	ProxyId CreateProxy(const AABB& bounds, void* userData, GroupId group) override;
+	void DestroyProxy(ProxyId proxy) override;
+	void MoveProxy(ProxyId proxy, const AABB& bounds) override;
+	void FindPairs(std::vector<Pair>& pairs) override;
+	inline void* GetUserData(ProxyId proxy) const override { return m_nodes[proxy].userData; }
+
+	//@brief Returns the fat bounds stored for a proxy
+	inline const AABB& GetFatBounds(ProxyId proxy) const { return m_nodes[proxy].bounds; }
+
+	//@brief Returns the height of the tallest group's tree, 0 for a single leaf
+	int32_t GetHeight() const;
+
+protected:
+	void query(const AABB& bounds, QueryCallback callback, void* context) const override;
+	void rayCast(const PhysicsVec3& origin, const PhysicsVec3& delta, RayCastCallback callback, void* context) const override;
+
+private:
+	static constexpr int32_t NULL_NODE = -1;
+
+	// Deep enough for any tree the rotations allow, whose height stays below 1.44 log2 of the proxy count
+	static constexpr uint32_t QUERY_STACK_SIZE = 256;
+
+	struct Node
+	{
+		AABB bounds;
+		void* userData = nullptr;
+		int32_t parent = NULL_NODE;		// next free node while on the free list
+		int32_t child1 = NULL_NODE;
+		int32_t child2 = NULL_NODE;
+		int32_t height = -1;			// 0 for leaves, -1 while on the free list
+		GroupId group = 0;				// group of the tree the node is in
+		bool moved = false;				// reinserted since the last FindPairs
+
+		inline bool IsLeaf() const { return child1 == NULL_NODE; }
+	};
+
+	int32_t allocateNode();
+	void freeNode(int32_t node);
+
+	//@brief Links a leaf into the tree next to the sibling that grows the total surface area least
+	void insertLeaf(int32_t leaf);
+
+	//@brief Unlinks a leaf, its parent is freed and its sibling takes the parent's place
+	void removeLeaf(int32_t leaf);
+
+	//@brief Walks from a node to the root, rebalancing and refitting every ancestor
+	void refit(int32_t node);
+
+	//@brief Rotates a node's taller grandchild up if its children's heights differ by more than one
+	//@return int32_t : The node now in its place
+	int32_t balance(int32_t node);
+
+	//@brief Queues a proxy for the next FindPairs
+	void markMoved(int32_t leaf);
+
+	//@brief Calls callback with every proxy of one tree whose fat bounds overlap bounds
+	//@param root : Root of the tree to search
+	//@param callback : bool(ProxyId), returns false to stop the query
+	//@return uint32_t : Number of nodes tested
+	template <typename Callback>
+	uint32_t queryTree(int32_t root, const AABB& bounds, Callback&& callback) const;
+
+	std::vector<Node> m_nodes;
+	std::vector<int32_t> m_roots;		// root of the tree of each group
+	int32_t m_freeList = NULL_NODE;
+	uint32_t m_proxyCount = 0;
+	std::vector<ProxyId> m_movedProxies;
+	std::vector<Pair> m_pairs;		// pairs of the last FindPairs, updated incrementally
+};
+
+template <typename Callback>
+uint32_t AABBTree::queryTree(int32_t root, const AABB& bounds, Callback&& callback) const
+{
+	if (root == NULL_NODE)
+		return 0;
+
+	uint32_t tests = 0;
+	int32_t stack[QUERY_STACK_SIZE];
+	uint32_t count = 0;
+	stack[count++] = root;
+	while (count > 0)
+	{
+		const Node& node = m_nodes[stack[--count]];
+		++tests;
+		if (!node.bounds.Overlaps(bounds))
+			continue;
+
+		if (node.IsLeaf())
+		{
+			if (!callback(static_cast<ProxyId>(&node - m_nodes.data())))
+				return tests;
+		}
+		else
+		{
+			assert(count + 2 <= QUERY_STACK_SIZE);
+			stack[count++] = node.child1;
+			stack[count++] = node.child2;
+		}
+	}
+	return tests;
+}
@@ -0,0 +1,127 @@
+#include "../pch.h"
+#include "Broadphase.h"
+#include "AABBTree.h"
+#include "SweepAndPrune.h"
+
+// ****** Broadphase ****** //
+#pragma region Broadphase
+std::unique_ptr<Broadphase> Broadphase::Create(BroadphaseType type)
+{
+	switch (type)
+	{
+	case BroadphaseType::BRUTE_FORCE:
+		return std::make_unique<BruteForceBroadphase>();
+	case BroadphaseType::SWEEP_AND_PRUNE:
+		return std::make_unique<SweepAndPrune>();
+	case BroadphaseType::AABB_TREE:
+	default:
+		return std::make_unique<AABBTree>();
+	}
+}
+
+void Broadphase::SetGroupFilter(uint32_t groupCount, std::vector<uint8_t> canPair)
+{
+	assert(canPair.size() == static_cast<size_t>(groupCount) * groupCount);
+	m_groupCount = groupCount;
+	m_canPair = std::move(canPair);
+}
+#pragma endregion
+
+// ****** BruteForceBroadphase ****** //
+#pragma region BruteForceBroadphase
+Broadphase::ProxyId BruteForceBroadphase::CreateProxy(const AABB& bounds, void* userData, GroupId group)
+{
+	assert(group < m_groupCount);
+	ProxyId proxy;
+	if (!m_freeProxies.empty())
+	{
+		proxy = m_freeProxies.back();
+		m_freeProxies.pop_back();
+	}
+	else
+	{
+		proxy = static_cast<ProxyId>(m_proxies.size());
+		m_proxies.emplace_back();
+	}
+	m_proxies[proxy] = { bounds, userData, group, true };
+	++m_movedProxies;
+	return proxy;
+}
+
+void BruteForceBroadphase::DestroyProxy(ProxyId proxy)
+{
+	m_proxies[proxy] = {};
+	m_freeProxies.push_back(proxy);
+}
+
+void BruteForceBroadphase::MoveProxy(ProxyId proxy, const AABB& bounds)
+{
+	Proxy& stored = m_proxies[proxy];
+	if (stored.bounds.min == bounds.min && stored.bounds.max == bounds.max)
+		return;
+	stored.bounds = bounds;
+	++m_movedProxies;
+}
+
+void BruteForceBroadphase::FindPairs(std::vector<Pair>& pairs)
+{
+	pairs.clear();
+	m_stats = {};
+	m_stats.movedProxies = m_movedProxies;
+	m_movedProxies = 0;
+
+	// Every pair of groups that can pair is tested in full, the others are skipped
+	for (std::vector<ProxyId>& group : m_groups)
+		group.clear();
+	m_groups.resize(m_groupCount);
+	for (ProxyId proxy = 0; proxy < m_proxies.size(); ++proxy)
+	{
+		if (m_proxies[proxy].alive)
+			m_groups[m_proxies[proxy].group].push_back(proxy);
+	}
+	m_stats.proxies = static_cast<uint32_t>(m_proxies.size() - m_freeProxies.size());
+
+	for (GroupId group1 = 0; group1 < m_groupCount; ++group1)
+	{
+		for (GroupId group2 = group1; group2 < m_groupCount; ++group2)
+		{
+			if (!CanPair(group1, group2))
+				continue;
+			const std::vector<ProxyId>& proxies1 = m_groups[group1];
+			const std::vector<ProxyId>& proxies2 = m_groups[group2];
+			for (size_t i = 0; i < proxies1.size(); ++i)
+			{
+				for (size_t j = group1 == group2 ? i + 1 : 0; j < proxies2.size(); ++j)
+				{
+					++m_stats.boundsTests;
+					if (m_proxies[proxies1[i]].bounds.Overlaps(m_proxies[proxies2[j]].bounds))
+						pairs.emplace_back(std::min(proxies1[i], proxies2[j]), std::max(proxies1[i], proxies2[j]));
+				}
+			}
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end());
+	m_stats.pairs = static_cast<uint32_t>(pairs.size());
+}
+
+void BruteForceBroadphase::query(const AABB& bounds, QueryCallback callback, void* context) const
+{
+	for (ProxyId proxy = 0; proxy < m_proxies.size(); ++proxy)
+	{
+		if (m_proxies[proxy].alive && m_proxies[proxy].bounds.Overlaps(bounds) && !callback(context, proxy))
+			return;
+	}
+}
+
+void BruteForceBroadphase::rayCast(const PhysicsVec3& origin, const PhysicsVec3& delta, RayCastCallback callback, void* context) const
+{
+	const PhysicsVec3 inverseDelta = inverse(delta);
+	PhysicsReal maxFraction = 1.0;
+	for (ProxyId proxy = 0; proxy < m_proxies.size() && maxFraction > 0.0; ++proxy)
+	{
+		if (m_proxies[proxy].alive && m_proxies[proxy].bounds.RayOverlaps(origin, inverseDelta, maxFraction))
+			maxFraction = std::min(maxFraction, callback(context, proxy, maxFraction));
+	}
+}
+#pragma endregion
@@ -0,0 +1,147 @@
+#pragma once
+
+// How the collision manager finds the pairs of colliders worth a narrowphase test
+enum class BroadphaseType
+{
+	BRUTE_FORCE,		// Tests every pair, the reference the others are measured against
+	AABB_TREE,			// Dynamic tree of fattened bounds, suits scenes with many moving bodies
+	SWEEP_AND_PRUNE		// Bounds kept sorted along one axis, suits mostly static scenes
+};
+
+// Tracks the bounds of every collider and reports the pairs whose bounds overlap. Proxies are
+// created, moved and destroyed as colliders change, and FindPairs only redoes the work those
+// changes require. Every proxy belongs to a group, and proxies of groups that cannot pair are
+// kept apart so their pairs are never enumerated
+class Broadphase
+{
+public:
+	using ProxyId = uint32_t;
+	using GroupId = uint32_t;
+	using Pair = std::pair<ProxyId, ProxyId>;
+	static constexpr ProxyId NULL_PROXY = std::numeric_limits<ProxyId>::max();
+
+	// Work done by the last FindPairs call
+	struct Stats
+	{
+		uint32_t proxies = 0;
+		uint32_t movedProxies = 0;	// proxies whose stored bounds changed since the previous call
+		uint64_t boundsTests = 0;	// AABB overlap tests
+		uint32_t pairs = 0;			// candidate pairs handed to the narrowphase
+	};
+
+	virtual ~Broadphase() = default;
+
+	//@brief Creates the broadphase of a strategy
+	//@param type : Strategy to use
+	//@return std::unique_ptr<Broadphase> : The empty broadphase
+	static std::unique_ptr<Broadphase> Create(BroadphaseType type);
+
+	//@brief Returns the strategy of the broadphase
+	virtual BroadphaseType GetType() const = 0;
+
+	//@brief Sets which groups of proxies can pair, a single group that pairs with itself until then
+	//@param groupCount : Number of groups, the groups of proxies must be below it
+	//@param canPair : groupCount * groupCount flags by row, symmetric, nonzero where two groups can pair.
+	// Pairs already reported between groups that can no longer pair are only dropped once a side moves
+	void SetGroupFilter(uint32_t groupCount, std::vector<uint8_t> canPair);
+
+	//@brief Returns whether proxies of two groups can pair
+	inline bool CanPair(GroupId group1, GroupId group2) const { return m_canPair[group1 * m_groupCount + group2] != 0; }
+
+	//@brief Starts tracking a collider
+	//@param bounds : World bounds of the collider
+	//@param userData : Pointer handed back with the pairs of the proxy
+	//@param group : Group of the proxy
+	//@return ProxyId : Id of the new proxy, ids of destroyed proxies are reused
+	virtual ProxyId CreateProxy(const AABB& bounds, void* userData, GroupId group = 0) = 0;
+
+	//@brief Stops tracking a collider
+	//@param proxy : Proxy to destroy
+	virtual void DestroyProxy(ProxyId proxy) = 0;
+
+	//@brief Updates the bounds of a collider. Cheap when the collider has not moved
+	//@param proxy : Proxy to move
+	//@param bounds : New world bounds of the collider
+	virtual void MoveProxy(ProxyId proxy, const AABB& bounds) = 0;
+
+	//@brief Finds every pair of proxies whose bounds overlap
+	//@param pairs : Filled with the pairs, smaller id first, sorted so the narrowphase runs in a stable order
+	virtual void FindPairs(std::vector<Pair>& pairs) = 0;
+
+	//@brief Returns the user data a proxy was created with
+	virtual void* GetUserData(ProxyId proxy) const = 0;
+
+	//@brief Returns the work done by the last FindPairs call
+	inline const Stats& GetStats() const { return m_stats; }
+
+	//@brief Calls callback with every proxy whose stored bounds overlap bounds. Allocates nothing
+	//@param bounds : Box to test against
+	//@param callback : bool(ProxyId), returns false to stop the query
+	template <typename Callback>
+	void Query(const AABB& bounds, Callback&& callback) const
+	{
+		query(bounds, [](void* context, ProxyId proxy) { return (*static_cast<std::remove_reference_t<Callback>*>(context))(proxy); },
+			const_cast<void*>(static_cast<const void*>(&callback)));
+	}
+
+	//@brief Calls callback with every proxy whose stored bounds the segment origin + t * delta enters,
+	// t from 0 to 1. Allocates nothing
+	//@param origin : Start of the segment
+	//@param delta : Segment from its start to its end
+	//@param callback : PhysicsReal(ProxyId, PhysicsReal maxFraction), returns the fraction the segment is clipped to,
+	// maxFraction to carry on unchanged and 0 to stop
+	template <typename Callback>
+	void RayCast(const PhysicsVec3& origin, const PhysicsVec3& delta, Callback&& callback) const
+	{
+		rayCast(origin, delta, [](void* context, ProxyId proxy, PhysicsReal maxFraction) { return (*static_cast<std::remove_reference_t<Callback>*>(context))(proxy, maxFraction); },
+			const_cast<void*>(static_cast<const void*>(&callback)));
+	}
+
+protected:
+	using QueryCallback = bool (*)(void* context, ProxyId proxy);
+	using RayCastCallback = PhysicsReal (*)(void* context, ProxyId proxy, PhysicsReal maxFraction);
+
+	virtual void query(const AABB& bounds, QueryCallback callback, void* context) const = 0;
+	virtual void rayCast(const PhysicsVec3& origin, const PhysicsVec3& delta, RayCastCallback callback, void* context) const = 0;
+
+	//@brief Returns 1 / delta per component, the form AABB::RayOverlaps takes
+	static inline PhysicsVec3 inverse(const PhysicsVec3& delta)
+	{
+		constexpr PhysicsReal infinity = std::numeric_limits<PhysicsReal>::infinity();
+		return { delta.x != 0.0 ? 1.0 / delta.x : infinity, delta.y != 0.0 ? 1.0 / delta.y : infinity, delta.z != 0.0 ? 1.0 / delta.z : infinity };
+	}
+
+	Stats m_stats;
+	uint32_t m_groupCount = 1;
+	std::vector<uint8_t> m_canPair{ 1 };
+};
+
+// Tests every pair of proxies. Kept for small scenes and to check the other strategies against
+class BruteForceBroadphase : public Broadphase
+{
+public:
+	inline BroadphaseType GetType() const override { return BroadphaseType::BRUTE_FORCE; }
+	ProxyId CreateProxy(const AABB& bounds, void* userData, GroupId group) override;
+	void DestroyProxy(ProxyId proxy) override;
+	void MoveProxy(ProxyId proxy, const AABB& bounds) override;
+	void FindPairs(std::vector<Pair>& pairs) override;
+	inline void* GetUserData(ProxyId proxy) const override { return m_proxies[proxy].userData; }
+
+protected:
+	void query(const AABB& bounds, QueryCallback callback, void* context) const override;
+	void rayCast(const PhysicsVec3& origin, const PhysicsVec3& delta, RayCastCallback callback, void* context) const override;
+
+private:
+	struct Proxy
+	{
+		AABB bounds;
+		void* userData = nullptr;
+		GroupId group = 0;
+		bool alive = false;
+	};
+
+	std::vector<Proxy> m_proxies;
+	std::vector<ProxyId> m_freeProxies;
+	std::vector<std::vector<ProxyId>> m_groups;		// live proxies of each group, gathered by FindPairs
+	uint32_t m_movedProxies = 0;
+};
@@ -3,133 +3,471 @@
 
 namespace {
 
-	bool OverlapOnAxis(const CollisionShape_Cuboid* cuboid1, const CollisionShape_Cuboid* cuboid2, const glm::dvec3& axis) {
-
-		auto getInterval = [](const CollisionShape_Cuboid* cuboid, const glm::dvec3& axis) {
-			std::array<glm::dvec3, 8> vertices = {
-				cuboid->GetPosition() + cuboid->GetHalfWidth() * glm::dvec3(1,  1,  1),
-				cuboid->GetPosition() + cuboid->GetHalfWidth() * glm::dvec3(1,  1, -1),
-				cuboid->GetPosition() + cuboid->GetHalfWidth() * glm::dvec3(1, -1,  1),
-				cuboid->GetPosition() + cuboid->GetHalfWidth() * glm::dvec3(1, -1, -1),
-				cuboid->GetPosition() + cuboid->GetHalfWidth() * glm::dvec3(-1,  1,  1),
-				cuboid->GetPosition() + cuboid->GetHalfWidth() * glm::dvec3(-1,  1, -1),
-				cuboid->GetPosition() + cuboid->GetHalfWidth() * glm::dvec3(-1, -1,  1),
-				cuboid->GetPosition() + cuboid->GetHalfWidth() * glm::dvec3(-1, -1, -1)
-			};
-
-			double min = glm::dot(vertices[0], axis);
-			double max = min;
-			for (const auto& vertex : vertices) {
-				double projection = glm::dot(vertex, axis);
-				min = std::min(min, projection);
-				max = std::max(max, projection);
+	// Maximum steps a sweep between two rotated cuboids takes before bisecting
+	constexpr uint32_t MAX_SWEEP_STEPS = 64;
+	// Bisections refining the time of impact of a stepped sweep
+	constexpr uint32_t SWEEP_BISECTIONS = 10;
+
+	// Number of axes a box-box SAT can test: 3 face normals per box and the 9 edge cross products
+	constexpr uint8_t SAT_AXES = 15;
+	// Added to the absolute rotation terms so near-parallel edges, whose cross product is noise, never separate.
+	// Floats round a unit dot product to about 1e-7, so they need a wider margin
+	constexpr PhysicsReal PARALLEL_EPSILON = std::is_same_v<PhysicsReal, float> ? PhysicsReal(1e-6) : PhysicsReal(1e-9);
+	// Edge cross products shorter than this come from parallel edges, their direction is rounding noise
+	constexpr PhysicsReal PARALLEL_EDGE_LENGTH = std::is_same_v<PhysicsReal, float> ? PhysicsReal(1e-3) : PhysicsReal(1e-6);
+	// An edge axis is only chosen for the manifold if it overlaps this much less than the best face axis,
+	// faces give more contact points and stay stable from frame to frame
+	constexpr PhysicsReal EDGE_AXIS_BIAS = 0.95;
+
+	// A cuboid as the checks see it, so casts can test a cuboid away from its own position
+	struct Box
+	{
+		PhysicsVec3 position;
+		PhysicsMat3 axes;		// local x, y and z in world space, one per column
+		PhysicsVec3 halfWidth;	// along the local axes
+	};
+
+	Box ToBox(const CollisionShape_Cuboid* cuboid, const PhysicsVec3& position)
+	{
+		return { position, cuboid->GetAxes(), glm::abs(cuboid->GetHalfWidth()) };
+	}
+
+	// Whether every local axis of a box lies along a world axis, so the box is its own bounds
+	bool IsAxisAligned(const PhysicsMat3& axes)
+	{
+		constexpr PhysicsReal aligned = 1 - PARALLEL_EPSILON;
+		for (int i = 0; i < 3; ++i)
+		{
+			PhysicsVec3 axis = glm::abs(axes[i]);
+			if (std::max(axis.x, std::max(axis.y, axis.z)) < aligned)
+				return false;
+		}
+		return true;
+	}
+
+	// Extents of a box along the world axes
+	PhysicsVec3 WorldHalfWidth(const Box& box)
+	{
+		return glm::abs(box.axes[0]) * box.halfWidth.x + glm::abs(box.axes[1]) * box.halfWidth.y + glm::abs(box.axes[2]) * box.halfWidth.z;
+	}
+
+	// What every SAT axis between two boxes is computed from, worked out once per pair. The second box is
+	// expressed in the frame of the first, so projecting a box onto an axis is a few multiplies
+	struct BoxPair
+	{
+		const Box& box1;
+		const Box& box2;
+		PhysicsReal rotation[3][3];			// rotation[i][j] = dot(axis i of box1, axis j of box2)
+		PhysicsReal absRotation[3][3];
+		PhysicsVec3 offset;				// centre of box2 minus centre of box1, along box1's axes
+
+		BoxPair(const Box& first, const Box& second) : box1(first), box2(second)
+		{
+			PhysicsVec3 centres = box2.position - box1.position;
+			for (int i = 0; i < 3; ++i)
+			{
+				for (int j = 0; j < 3; ++j)
+				{
+					rotation[i][j] = glm::dot(box1.axes[i], box2.axes[j]);
+					absRotation[i][j] = std::abs(rotation[i][j]) + PARALLEL_EPSILON;
+				}
+				offset[i] = glm::dot(centres, box1.axes[i]);
 			}
-			return std::make_pair(min, max);
-		};
+		}
+
+		// How far the boxes' projections onto an axis overlap, negative when the axis separates them.
+		// Axes 0-2 are box1's faces, 3-5 box2's, 6-14 the cross products of box1's edge i and box2's edge j at 6 + 3i + j.
+		// Edge axes are scaled to unit length, parallel edges give no axis and report an infinite overlap
+		PhysicsReal Overlap(uint8_t axis) const
+		{
+			const PhysicsVec3& a = box1.halfWidth;
+			const PhysicsVec3& b = box2.halfWidth;
+			if (axis < 3)
+			{
+				const int i = axis;
+				PhysicsReal radius2 = b.x * absRotation[i][0] + b.y * absRotation[i][1] + b.z * absRotation[i][2];
+				return a[i] + radius2 - std::abs(offset[i]);
+			}
+			if (axis < 6)
+			{
+				const int j = axis - 3;
+				PhysicsReal radius1 = a.x * absRotation[0][j] + a.y * absRotation[1][j] + a.z * absRotation[2][j];
+				PhysicsReal distance = offset.x * rotation[0][j] + offset.y * rotation[1][j] + offset.z * rotation[2][j];
+				return radius1 + b[j] - std::abs(distance);
+			}
+
+			const int i = (axis - 6) / 3;
+			const int j = (axis - 6) % 3;
+			const int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+			const int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+			PhysicsReal length = std::sqrt(std::max(1.0 - rotation[i][j] * rotation[i][j], 0.0));
+			if (length < PARALLEL_EDGE_LENGTH)
+				return std::numeric_limits<PhysicsReal>::infinity();
+			PhysicsReal radius1 = a[i1] * absRotation[i2][j] + a[i2] * absRotation[i1][j];
+			PhysicsReal radius2 = b[j1] * absRotation[i][j2] + b[j2] * absRotation[i][j1];
+			PhysicsReal distance = offset[i2] * rotation[i1][j] - offset[i1] * rotation[i2][j];
+			return (radius1 + radius2 - std::abs(distance)) / length;
+		}
+
+		// Unit direction of an axis in world space, facing from box1 to box2
+		PhysicsVec3 Direction(uint8_t axis) const
+		{
+			PhysicsVec3 direction;
+			if (axis < 3)
+				direction = box1.axes[axis];
+			else if (axis < 6)
+				direction = box2.axes[axis - 3];
+			else
+				direction = glm::normalize(glm::cross(box1.axes[(axis - 6) / 3], box2.axes[(axis - 6) % 3]));
+			return glm::dot(direction, box2.position - box1.position) < 0.0 ? -direction : direction;
+		}
+	};
+
+	// Tests every axis, starting with the one that separated the boxes last time since objects that were
+	// apart usually still are, and stops at the first that separates them
+	bool SAT(const Box& box1, const Box& box2, uint8_t& separatingAxis)
+	{
+		const BoxPair pair(box1, box2);
+		const uint8_t first = separatingAxis < SAT_AXES ? separatingAxis : 0;
+		for (uint8_t n = 0; n < SAT_AXES; ++n)
+		{
+			uint8_t axis = (first + n) % SAT_AXES;
+			if (pair.Overlap(axis) < 0.0)
+			{
+				separatingAxis = axis;
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool BoxesOverlap(const Box& box1, const Box& box2, uint8_t& separatingAxis)
+	{
+		if (IsAxisAligned(box1.axes) && IsAxisAligned(box2.axes))	// If both are axis aligned they are their own bounds
+		{
+			PhysicsVec3 extent = WorldHalfWidth(box1) + WorldHalfWidth(box2);
+			PhysicsVec3 distance = glm::abs(box2.position - box1.position);
+			return distance.x <= extent.x && distance.y <= extent.y && distance.z <= extent.z;
+		}
+		return SAT(box1, box2, separatingAxis);
+	}
 
-		auto [min1, max1] = getInterval(cuboid1, axis);
-		auto [min2, max2] = getInterval(cuboid2, axis);
+	bool BoxesOverlap(const Box& box1, const Box& box2)
+	{
+		uint8_t separatingAxis = 0;
+		return BoxesOverlap(box1, box2, separatingAxis);
+	}
 
-		return !(max1 < min2 || max2 < min1);
+	// Clips a convex polygon to the side of a plane where dot(point, normal) <= offset, returns the vertices left
+	uint32_t ClipPolygon(const std::array<PhysicsVec3, 8>& input, uint32_t count, const PhysicsVec3& normal, PhysicsReal offset, std::array<PhysicsVec3, 8>& output)
+	{
+		uint32_t written = 0;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const PhysicsVec3& current = input[i];
+			const PhysicsVec3& next = input[(i + 1) % count];
+			PhysicsReal currentDistance = glm::dot(current, normal) - offset;
+			PhysicsReal nextDistance = glm::dot(next, normal) - offset;
+			if (currentDistance <= 0.0)
+				output[written++] = current;
+			if ((currentDistance < 0.0) != (nextDistance < 0.0) && currentDistance != nextDistance)
+				output[written++] = current + (next - current) * (currentDistance / (currentDistance - nextDistance));
+		}
+		return written;
 	}
 
-    std::vector<glm::dvec3> ComputeAxes(const CollisionShape_Cuboid* cuboid1, const CollisionShape_Cuboid* cuboid2) {
-        std::vector<glm::dvec3> axes;
+	// Keeps the four points that span the largest area, starting from the deepest
+	void ReducePoints(const std::array<PhysicsVec3, 8>& points, const std::array<PhysicsReal, 8>& depths, uint32_t count, const PhysicsVec3& normal, ContactManifold& manifold)
+	{
+		std::array<uint32_t, ContactManifold::MAX_POINTS> chosen{};
+		chosen[0] = static_cast<uint32_t>(std::max_element(depths.begin(), depths.begin() + count) - depths.begin());
 
-		// Define axis-aligned face normals for a cuboid (local space)
-		std::vector<glm::dvec3> cuboidAANormals = {
-			//glm::dvec3(0, 1, 0),  // Top face
-			glm::dvec3(0, -1, 0), // Bottom face
-			//glm::dvec3(1, 0, 0),  // Front face
-			glm::dvec3(-1, 0, 0), // Back face
-			//glm::dvec3(0, 0, 1),  // Left face
-			glm::dvec3(0, 0, -1)  // Right face
+		auto best = [&](auto&& score)
+		{
+			uint32_t index = 0;
+			PhysicsReal bestScore = -std::numeric_limits<PhysicsReal>::infinity();
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				PhysicsReal value = score(points[i]);
+				if (value > bestScore)
+				{
+					bestScore = value;
+					index = i;
+				}
+			}
+			return index;
 		};
+		const PhysicsVec3& a = points[chosen[0]];
+		chosen[1] = best([&](const PhysicsVec3& p) { return glm::length2(p - a); });
+		const PhysicsVec3& b = points[chosen[1]];
+		chosen[2] = best([&](const PhysicsVec3& p) { return std::abs(glm::dot(glm::cross(b - a, p - a), normal)); });
+		const PhysicsVec3& c = points[chosen[2]];
+		PhysicsReal side = glm::dot(glm::cross(b - a, c - a), normal);
+		chosen[3] = best([&](const PhysicsVec3& p) { return -side * glm::dot(glm::cross(b - a, p - a), normal); });
 
-        // Get face normals for cuboid1
-		std::vector<glm::dvec3> cuboid1Normals;
-		for (const glm::dvec3& normal : cuboidAANormals) {
-			cuboid1Normals.push_back(glm::rotate(glm::dquat(cuboid1->GetRotation()), normal));
+		for (uint32_t index : chosen)
+			manifold.points[manifold.pointCount++] = points[index];
+	}
+
+	// Contact points of a face axis: the face of the other box most facing the reference face, clipped to the
+	// reference face's sides, keeping the points below it
+	void FaceContact(const Box& reference, int referenceAxis, const PhysicsVec3& normal, const Box& incident, ContactManifold& manifold)
+	{
+		// normal faces from the reference box to the incident one
+		int incidentAxis = 0;
+		PhysicsReal mostOpposed = -1.0;
+		for (int k = 0; k < 3; ++k)
+		{
+			PhysicsReal alignment = std::abs(glm::dot(incident.axes[k], normal));
+			if (alignment > mostOpposed)
+			{
+				mostOpposed = alignment;
+				incidentAxis = k;
+			}
 		}
+		const int u = (incidentAxis + 1) % 3, v = (incidentAxis + 2) % 3;
+		const PhysicsReal facing = glm::dot(incident.axes[incidentAxis], normal) > 0.0 ? -1.0 : 1.0;
+		const PhysicsVec3 faceCentre = incident.position + incident.axes[incidentAxis] * (incident.halfWidth[incidentAxis] * facing);
+		const PhysicsVec3 edgeU = incident.axes[u] * incident.halfWidth[u];
+		const PhysicsVec3 edgeV = incident.axes[v] * incident.halfWidth[v];
 
+		std::array<PhysicsVec3, 8> polygon = { faceCentre + edgeU + edgeV, faceCentre - edgeU + edgeV, faceCentre - edgeU - edgeV, faceCentre + edgeU - edgeV };
+		std::array<PhysicsVec3, 8> clipped;
+		uint32_t count = 4;
+		for (int side : { (referenceAxis + 1) % 3, (referenceAxis + 2) % 3 })
+		{
+			const PhysicsVec3& axis = reference.axes[side];
+			PhysicsReal centre = glm::dot(reference.position, axis);
+			count = ClipPolygon(polygon, count, axis, centre + reference.halfWidth[side], clipped);
+			count = ClipPolygon(clipped, count, -axis, -centre + reference.halfWidth[side], polygon);
+		}
 
-        // Get face normals for cuboid2
-		std::vector<glm::dvec3> cuboid2Normals;
-		for (const glm::dvec3& normal : cuboidAANormals) {
-			cuboid2Normals.push_back(glm::rotate(glm::dquat(cuboid2->GetRotation()), normal));
+		const PhysicsReal faceOffset = glm::dot(reference.position, normal) + reference.halfWidth[referenceAxis];
+		std::array<PhysicsVec3, 8> points;
+		std::array<PhysicsReal, 8> depths;
+		uint32_t found = 0;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			PhysicsReal depth = faceOffset - glm::dot(polygon[i], normal);
+			if (depth < 0.0)
+				continue;
+			points[found] = polygon[i] + normal * (depth * PhysicsReal(0.5));
+			depths[found++] = depth;
 		}
 
-        // Add face normals
-        axes.insert(axes.end(), std::begin(cuboid1Normals), std::end(cuboid1Normals));
-        axes.insert(axes.end(), std::begin(cuboid2Normals), std::end(cuboid2Normals));
+		if (found == 0)	// Only grazing, the face centre stands in
+		{
+			manifold.points[manifold.pointCount++] = faceCentre;
+			return;
+		}
+		if (found <= ContactManifold::MAX_POINTS)
+		{
+			for (uint32_t i = 0; i < found; ++i)
+				manifold.points[manifold.pointCount++] = points[i];
+			return;
+		}
+		ReducePoints(points, depths, found, normal, manifold);
+	}
 
-        // Add cross products of edges
-        for (const auto& axis1 : cuboid1Normals) {
-            for (const auto& axis2 : cuboid2Normals) {
-                glm::dvec3 crossAxis = glm::cross(axis1, axis2);
-                if (glm::length(crossAxis) > 1e-6) { // Skip small axes
-                    axes.push_back(glm::normalize(crossAxis));
-                }
-            }
-        }
+	// Contact point of an edge axis: midway between the closest points of the two edges that touch
+	void EdgeContact(const Box& box1, int edge1, const Box& box2, int edge2, const PhysicsVec3& normal, ContactManifold& manifold)
+	{
+		// The edges are the ones furthest along the normal on box1 and against it on box2
+		PhysicsVec3 point1 = box1.position;
+		PhysicsVec3 point2 = box2.position;
+		for (int k = 0; k < 3; ++k)
+		{
+			if (k != edge1)
+				point1 += box1.axes[k] * (glm::dot(box1.axes[k], normal) > 0.0 ? box1.halfWidth[k] : -box1.halfWidth[k]);
+			if (k != edge2)
+				point2 += box2.axes[k] * (glm::dot(box2.axes[k], normal) > 0.0 ? -box2.halfWidth[k] : box2.halfWidth[k]);
+		}
 
-        return axes;
-    }
+		const PhysicsVec3& direction1 = box1.axes[edge1];
+		const PhysicsVec3& direction2 = box2.axes[edge2];
+		PhysicsVec3 between = point1 - point2;
+		PhysicsReal alignment = glm::dot(direction1, direction2);
+		PhysicsReal denominator = 1.0 - alignment * alignment;
+		PhysicsReal along1 = 0.0;
+		PhysicsReal along2 = 0.0;
+		if (denominator > 1e-12)
+		{
+			PhysicsReal d1 = glm::dot(direction1, between);
+			PhysicsReal d2 = glm::dot(direction2, between);
+			along1 = std::clamp((alignment * d2 - d1) / denominator, -box1.halfWidth[edge1], box1.halfWidth[edge1]);
+			along2 = std::clamp(d2 + alignment * along1, -box2.halfWidth[edge2], box2.halfWidth[edge2]);
+		}
+		manifold.points[manifold.pointCount++] = ((point1 + direction1 * along1) + (point2 + direction2 * along2)) * PhysicsReal(0.5);
+	}
 
-	bool SAT(const CollisionShape_Cuboid* cuboid1, const CollisionShape_Cuboid* cuboid2)
+	// Full SAT, keeping the axis of least overlap, then the contact points of that axis
+	bool BoxContact(const Box& box1, const Box& box2, uint8_t& separatingAxis, ContactManifold& manifold)
 	{
-		auto axes = ComputeAxes(cuboid1, cuboid2);
+		const BoxPair pair(box1, box2);
+		if (separatingAxis < SAT_AXES && pair.Overlap(separatingAxis) < 0.0)
+			return false;
 
-		for (const auto& axis : axes) {
-			if (!OverlapOnAxis(cuboid1, cuboid2, axis)) 
-				{ return false; }
+		uint8_t faceAxis = 0;
+		PhysicsReal faceOverlap = std::numeric_limits<PhysicsReal>::infinity();
+		uint8_t edgeAxis = 0;
+		PhysicsReal edgeOverlap = std::numeric_limits<PhysicsReal>::infinity();
+		for (uint8_t axis = 0; axis < SAT_AXES; ++axis)
+		{
+			PhysicsReal overlap = pair.Overlap(axis);
+			if (overlap < 0.0)
+			{
+				separatingAxis = axis;
+				return false;
+			}
+			if (axis < 6 && overlap < faceOverlap)
+			{
+				faceOverlap = overlap;
+				faceAxis = axis;
+			}
+			else if (axis >= 6 && overlap < edgeOverlap)
+			{
+				edgeOverlap = overlap;
+				edgeAxis = axis;
+			}
 		}
+
+		const bool useEdge = edgeOverlap < faceOverlap * EDGE_AXIS_BIAS;
+		const uint8_t axis = useEdge ? edgeAxis : faceAxis;
+		manifold = {};
+		manifold.normal = pair.Direction(axis);
+		manifold.depth = useEdge ? edgeOverlap : faceOverlap;
+		if (useEdge)
+			EdgeContact(box1, (axis - 6) / 3, box2, (axis - 6) % 3, manifold.normal, manifold);
+		else if (axis < 3)
+			FaceContact(box1, axis, manifold.normal, box2, manifold);
+		else
+			FaceContact(box2, axis - 3, -manifold.normal, box1, manifold);
 		return true;
 	}
 
-	bool AABB(const CollisionShape_Cuboid* cuboid1, const CollisionShape_Cuboid* cuboid2)
+	// Casts origin + t * delta, t in [0, 1], against a sphere. A segment starting inside hits at 0
+	bool RaySphere(const PhysicsVec3& center, PhysicsReal radius, const PhysicsVec3& origin, const PhysicsVec3& delta, PhysicsReal& fraction, PhysicsVec3& normal)
 	{
-		glm::dvec3 thisHalfWidth = cuboid1->GetHalfWidth();
-		glm::dvec3 otherHalfWidth = cuboid2->GetHalfWidth();
+		PhysicsVec3 offset = origin - center;
+		PhysicsReal c = glm::dot(offset, offset) - radius * radius;
+		if (c < 0.0)
+		{
+			fraction = 0.0;
+			normal = glm::length2(offset) > 0.0 ? glm::normalize(offset) : PhysicsVec3(0.0, 1.0, 0.0);
+			return true;
+		}
 
-		glm::dvec3 thisMin = cuboid1->GetPosition() - thisHalfWidth;
-		glm::dvec3 thisMax = cuboid1->GetPosition() + thisHalfWidth;
+		PhysicsReal a = glm::dot(delta, delta);
+		PhysicsReal b = glm::dot(offset, delta);
+		if (a <= 0.0 || b >= 0.0)	// Not moving, or moving away
+			return false;
 
-		glm::dvec3 otherMin = cuboid2->GetPosition() - otherHalfWidth;
-		glm::dvec3 otherMax = cuboid2->GetPosition() + otherHalfWidth;
+		PhysicsReal discriminant = b * b - a * c;
+		if (discriminant < 0.0)
+			return false;
 
-		if (thisMax.x < otherMin.x || thisMin.x > otherMax.x) { return false; }
-		if (thisMax.y < otherMin.y || thisMin.y > otherMax.y) { return false; }
-		if (thisMax.z < otherMin.z || thisMin.z > otherMax.z) { return false; }
+		PhysicsReal t = (-b - std::sqrt(discriminant)) / a;
+		if (t > 1.0)
+			return false;
 
+		fraction = std::max(t, PhysicsReal(0));
+		normal = glm::normalize(offset + delta * fraction);
 		return true;
 	}
-}
 
-namespace CollisionChecks {
+	// Casts origin + t * delta, t in [0, 1], against an axis-aligned box. A segment starting inside hits at 0
+	bool RayBox(const PhysicsVec3& center, const PhysicsVec3& halfWidth, const PhysicsVec3& origin, const PhysicsVec3& delta, PhysicsReal& fraction, PhysicsVec3& normal)
+	{
+		// Slab test, the hit face is the last slab the segment enters
+		PhysicsReal enter = 0.0;
+		PhysicsReal exit = 1.0;
+		int axis = -1;
+		for (int i = 0; i < 3; ++i)
+		{
+			PhysicsReal low = center[i] - halfWidth[i] - origin[i];
+			PhysicsReal high = center[i] + halfWidth[i] - origin[i];
+			if (std::abs(delta[i]) < 1e-12)
+			{
+				if (low > 0.0 || high < 0.0) { return false; }
+				continue;
+			}
 
-	bool CheckCollisionBetween(const CollisionShape_Cuboid* cuboid1, const CollisionShape_Cuboid* cuboid2)
+			PhysicsReal t1 = low / delta[i];
+			PhysicsReal t2 = high / delta[i];
+			if (t1 > t2) { std::swap(t1, t2); }
+			if (t1 > enter)
+			{
+				enter = t1;
+				axis = i;
+			}
+			exit = std::min(exit, t2);
+			if (enter > exit) { return false; }
+		}
+
+		fraction = enter;
+		normal = PhysicsVec3(0.0);
+		if (axis >= 0)
+		{
+			normal[axis] = delta[axis] > 0.0 ? -1.0 : 1.0;
+			return true;
+		}
+
+		// Started inside, the way out is through the face nearest to the origin
+		PhysicsVec3 offset = (origin - center) / glm::max(halfWidth, PhysicsVec3(1e-12));
+		PhysicsVec3 absOffset = glm::abs(offset);
+		axis = absOffset.x >= absOffset.y && absOffset.x >= absOffset.z ? 0 : (absOffset.y >= absOffset.z ? 1 : 2);
+		normal[axis] = offset[axis] < 0.0 ? -1.0 : 1.0;
+		return true;
+	}
+
+	// Sweeps one box against another in steps no longer than the thinner box, then bisects the first step that overlaps
+	bool SweepBoxes(Box moving, const PhysicsVec3& delta, const Box& target, PhysicsReal& fraction)
 	{
-		// if rot1 has x%90 == 0 and y%90 == 0 and z%90==0 then this is axis aligned
-		glm::dvec3 rot1 = cuboid1->GetRotation();
-		int x1 = glm::round(rot1.x);
-		int y1 = glm::round(rot1.y);
-		int z1 = glm::round(rot1.z);
-		bool axis_aligned1 = x1 % 90 == 0 && y1 % 90 == 0 && z1 % 90 == 0;
-		// if rot2 has x%90 == 0 and y%90 == 0 and z%90==0 then this is axis aligned
-		glm::dvec3 rot2 = cuboid2->GetRotation();
-		int x2 = glm::round(rot2.x);
-		int y2 = glm::round(rot2.y);
-		int z2 = glm::round(rot2.z);
-		bool axis_aligned2 = x2 % 90 == 0 && y2 % 90 == 0 && z2 % 90 == 0;
-		if (axis_aligned1 && axis_aligned2)	// If both are axis aligned
-		{
-			return AABB(cuboid1, cuboid2);
+		if (BoxesOverlap(moving, target))
+		{
+			fraction = 0.0;
+			return true;
 		}
-		else
+
+		const PhysicsVec3 start = moving.position;
+		PhysicsVec3 thinnest = glm::min(glm::abs(moving.halfWidth), glm::abs(target.halfWidth));
+		PhysicsReal thickness = std::min(thinnest.x, std::min(thinnest.y, thinnest.z));
+		PhysicsReal steps = std::clamp(std::ceil(glm::length(delta) / std::max(thickness, PhysicsReal(1e-6))), PhysicsReal(1), static_cast<PhysicsReal>(MAX_SWEEP_STEPS));
+
+		PhysicsReal free = 0.0;
+		for (PhysicsReal step = 1.0; step <= steps; step += 1.0)
 		{
-			return SAT(cuboid1, cuboid2);
+			PhysicsReal hit = step / steps;
+			moving.position = start + delta * hit;
+			if (!BoxesOverlap(moving, target))
+			{
+				free = hit;
+				continue;
+			}
+
+			for (uint32_t i = 0; i < SWEEP_BISECTIONS; ++i)
+			{
+				PhysicsReal middle = (free + hit) * 0.5;
+				moving.position = start + delta * middle;
+				(BoxesOverlap(moving, target) ? hit : free) = middle;
+			}
+			fraction = free;
+			return true;
 		}
+		return false;
+	}
+}
+
+namespace CollisionChecks {
+
+	bool CheckCollisionBetween(const CollisionShape_Cuboid* cuboid1, const CollisionShape_Cuboid* cuboid2)
+	{
+		return BoxesOverlap(ToBox(cuboid1, cuboid1->GetPosition()), ToBox(cuboid2, cuboid2->GetPosition()));
+	}
+
+	bool CheckCollisionBetween(const CollisionShape_Cuboid* cuboid1, const CollisionShape_Cuboid* cuboid2, uint8_t& separatingAxis)
+	{
+		return BoxesOverlap(ToBox(cuboid1, cuboid1->GetPosition()), ToBox(cuboid2, cuboid2->GetPosition()), separatingAxis);
 	}
 
 
@@ -139,18 +477,18 @@ namespace CollisionChecks {
 	/// <returns>True if the two shapes are colliding.</returns>
 	bool CheckCollisionBetween(const CollisionShape_Cuboid* cuboid, const CollisionShape_Sphere* sphere)
 	{
-		glm::dvec3 thisHalfWidth = cuboid->GetHalfWidth();
-		glm::dvec3 otherPosition = sphere->GetPosition();
-		glm::dvec3 thisMin = cuboid->GetPosition() - thisHalfWidth;
-		glm::dvec3 thisMax = cuboid->GetPosition() + thisHalfWidth;
+		PhysicsVec3 thisHalfWidth = cuboid->GetHalfWidth();
+		PhysicsVec3 otherPosition = sphere->GetPosition();
+		PhysicsVec3 thisMin = cuboid->GetPosition() - thisHalfWidth;
+		PhysicsVec3 thisMax = cuboid->GetPosition() + thisHalfWidth;
 
-		glm::dvec3 closestPoint = glm::dvec3(
+		PhysicsVec3 closestPoint = PhysicsVec3(
 			glm::clamp(otherPosition.x, thisMin.x, thisMax.x),
 			glm::clamp(otherPosition.y, thisMin.y, thisMax.y),
 			glm::clamp(otherPosition.z, thisMin.z, thisMax.z)
 		);
 
-		double distance = glm::distance(otherPosition, closestPoint);
+		PhysicsReal distance = glm::distance(otherPosition, closestPoint);
 		if (distance < sphere->GetRadius().x)						// TODO: Assuming the sphere is a perfect sphere
 		{
 			return true;
@@ -171,8 +509,8 @@ namespace CollisionChecks {
 	bool CheckCollisionBetween(const CollisionShape_Sphere* sphere1, const CollisionShape_Sphere* sphere2)
 	{
 		// Check if the distance between the two spheres is less than the sum of their radii
-		double distance = glm::distance(sphere1->GetPosition(), sphere2->GetPosition());
-		double sumRadii = sphere1->GetRadius().x + sphere2->GetRadius().x;	// TODO: Assuming the spheres are perfect spheres
+		PhysicsReal distance = glm::distance(sphere1->GetPosition(), sphere2->GetPosition());
+		PhysicsReal sumRadii = sphere1->GetRadius().x + sphere2->GetRadius().x;	// TODO: Assuming the spheres are perfect spheres
 		if (distance < sumRadii)
 		{
 			return true;
@@ -183,28 +521,161 @@ namespace CollisionChecks {
 	bool CheckCollisionBetween(const CollisionShape* shape1, const CollisionShape* shape2)
 	{
 		assert(shape1 != nullptr && shape2 != nullptr);
-		if (auto cuboid1 = dynamic_cast<const CollisionShape_Cuboid*>(shape1))
-		{
-			if (auto cuboid2 = dynamic_cast<const CollisionShape_Cuboid*>(shape2))
-			{
-				return CheckCollisionBetween(cuboid1, cuboid2);
-			}
-			else if (auto sphere2 = dynamic_cast<const CollisionShape_Sphere*>(shape2))
-			{
-				return CheckCollisionBetween(cuboid1, sphere2);
+		return GetPairCheck(shape1->GetType(), shape2->GetType())(shape1, shape2);
+	}
+
+	PairCheck GetPairCheck(ShapeType type1, ShapeType type2)
+	{
+		// Each entry casts both shapes down to the types its row and column stand for
+		static constexpr PairCheck PAIR_CHECKS[static_cast<size_t>(ShapeType::COUNT)][static_cast<size_t>(ShapeType::COUNT)] = {
+			{	// SPHERE
+				[](const CollisionShape* a, const CollisionShape* b) { return CheckCollisionBetween(static_cast<const CollisionShape_Sphere*>(a), static_cast<const CollisionShape_Sphere*>(b)); },
+				[](const CollisionShape* a, const CollisionShape* b) { return CheckCollisionBetween(static_cast<const CollisionShape_Sphere*>(a), static_cast<const CollisionShape_Cuboid*>(b)); }
+			},
+			{	// CUBOID
+				[](const CollisionShape* a, const CollisionShape* b) { return CheckCollisionBetween(static_cast<const CollisionShape_Cuboid*>(a), static_cast<const CollisionShape_Sphere*>(b)); },
+				[](const CollisionShape* a, const CollisionShape* b) { return CheckCollisionBetween(static_cast<const CollisionShape_Cuboid*>(a), static_cast<const CollisionShape_Cuboid*>(b)); }
 			}
+		};
+		assert(type1 < ShapeType::COUNT && type2 < ShapeType::COUNT);
+		return PAIR_CHECKS[static_cast<size_t>(type1)][static_cast<size_t>(type2)];
+	}
+
+	bool Collide(const CollisionShape_Sphere* sphere1, const CollisionShape_Sphere* sphere2, ContactManifold& manifold)
+	{
+		PhysicsVec3 offset = sphere2->GetPosition() - sphere1->GetPosition();
+		PhysicsReal distance = glm::length(offset);
+		PhysicsReal radius1 = sphere1->GetRadius().x;
+		PhysicsReal radius2 = sphere2->GetRadius().x;
+		if (distance >= radius1 + radius2)
+			return false;
+
+		manifold = {};
+		manifold.normal = distance > 1e-12 ? offset / distance : PhysicsVec3(0.0, 1.0, 0.0);
+		manifold.depth = radius1 + radius2 - distance;
+		manifold.points[manifold.pointCount++] = sphere1->GetPosition() + manifold.normal * (radius1 - manifold.depth * PhysicsReal(0.5));
+		return true;
+	}
+
+	bool Collide(const CollisionShape_Cuboid* cuboid, const CollisionShape_Sphere* sphere, ContactManifold& manifold)
+	{
+		// The box is unrotated, as in CheckCollisionBetween, so the narrowphase and the manifold agree
+		PhysicsVec3 halfWidth = cuboid->GetHalfWidth();
+		PhysicsVec3 centre = sphere->GetPosition();
+		PhysicsVec3 closestPoint = glm::clamp(centre, cuboid->GetPosition() - halfWidth, cuboid->GetPosition() + halfWidth);
+		PhysicsVec3 offset = centre - closestPoint;
+		PhysicsReal distance = glm::length(offset);
+		PhysicsReal radius = sphere->GetRadius().x;
+		if (distance >= radius)
+			return false;
+
+		manifold = {};
+		if (distance > 1e-12)
+		{
+			manifold.normal = offset / distance;
+			manifold.depth = radius - distance;
+			manifold.points[manifold.pointCount++] = (closestPoint + centre - manifold.normal * radius) * PhysicsReal(0.5);
+			return true;
 		}
-		else if (const CollisionShape_Sphere* sphere1 = dynamic_cast<const CollisionShape_Sphere*>(shape1))
+
+		// The centre is inside the box, it leaves through the nearest face
+		PhysicsVec3 local = centre - cuboid->GetPosition();
+		PhysicsVec3 room = glm::abs(halfWidth) - glm::abs(local);
+		int axis = room.x <= room.y && room.x <= room.z ? 0 : (room.y <= room.z ? 1 : 2);
+		manifold.normal[axis] = local[axis] < 0.0 ? -1.0 : 1.0;
+		manifold.depth = radius + room[axis];
+		manifold.points[manifold.pointCount++] = centre;
+		return true;
+	}
+
+	bool Collide(const CollisionShape_Sphere* sphere, const CollisionShape_Cuboid* cuboid, ContactManifold& manifold)
+	{
+		if (!Collide(cuboid, sphere, manifold))
+			return false;
+		manifold.normal = -manifold.normal;
+		return true;
+	}
+
+	bool Collide(const CollisionShape_Cuboid* cuboid1, const CollisionShape_Cuboid* cuboid2, ContactManifold& manifold, uint8_t& separatingAxis)
+	{
+		return BoxContact(ToBox(cuboid1, cuboid1->GetPosition()), ToBox(cuboid2, cuboid2->GetPosition()), separatingAxis, manifold);
+	}
+
+	bool Collide(const CollisionShape* shape1, const CollisionShape* shape2, ContactManifold& manifold)
+	{
+		assert(shape1 != nullptr && shape2 != nullptr);
+		const bool sphere1 = shape1->GetType() == ShapeType::SPHERE;
+		const bool sphere2 = shape2->GetType() == ShapeType::SPHERE;
+		if (sphere1 && sphere2)
+			return Collide(static_cast<const CollisionShape_Sphere*>(shape1), static_cast<const CollisionShape_Sphere*>(shape2), manifold);
+		if (sphere1)
+			return Collide(static_cast<const CollisionShape_Sphere*>(shape1), static_cast<const CollisionShape_Cuboid*>(shape2), manifold);
+		if (sphere2)
+			return Collide(static_cast<const CollisionShape_Cuboid*>(shape1), static_cast<const CollisionShape_Sphere*>(shape2), manifold);
+		uint8_t separatingAxis = 0;
+		return Collide(static_cast<const CollisionShape_Cuboid*>(shape1), static_cast<const CollisionShape_Cuboid*>(shape2), manifold, separatingAxis);
+	}
+
+	bool Raycast(const CollisionShape* shape, const PhysicsVec3& origin, const PhysicsVec3& delta, PhysicsReal& fraction, PhysicsVec3& normal)
+	{
+		assert(shape != nullptr);
+		// A ray is a sphere of no radius, so cuboids are tested unrotated as in the sphere check
+		switch (shape->GetType())
 		{
-			if (auto cuboid2 = dynamic_cast<const CollisionShape_Cuboid*>(shape2))
-			{
-				return CheckCollisionBetween(sphere1, cuboid2);
-			}
-			else if (const CollisionShape_Sphere* sphere2 = dynamic_cast<const CollisionShape_Sphere*>(shape2))
+		case ShapeType::CUBOID:
+		{
+			auto cuboid = static_cast<const CollisionShape_Cuboid*>(shape);
+			return RayBox(cuboid->GetPosition(), cuboid->GetHalfWidth(), origin, delta, fraction, normal);
+		}
+		case ShapeType::SPHERE:
+		{
+			auto sphere = static_cast<const CollisionShape_Sphere*>(shape);
+			return RaySphere(sphere->GetPosition(), sphere->GetRadius().x, origin, delta, fraction, normal);
+		}
+		default:
+			return false;
+		}
+	}
+
+	bool Sweep(const CollisionShape* moving, const PhysicsVec3& start, const PhysicsVec3& delta, const CollisionShape* target, PhysicsReal& fraction, PhysicsVec3& normal)
+	{
+		assert(moving != nullptr && target != nullptr);
+		// Sweeping one shape against another is a ray against their sum. Sphere and box sums are
+		// treated as boxes, which only reports hits early around the corners
+		const bool targetIsSphere = target->GetType() == ShapeType::SPHERE;
+		if (moving->GetType() == ShapeType::SPHERE)
+		{
+			PhysicsReal radius = static_cast<const CollisionShape_Sphere*>(moving)->GetRadius().x;
+			if (targetIsSphere)
 			{
-				return CheckCollisionBetween(sphere1, sphere2);
+				auto targetSphere = static_cast<const CollisionShape_Sphere*>(target);
+				return RaySphere(targetSphere->GetPosition(), radius + targetSphere->GetRadius().x, start, delta, fraction, normal);
 			}
+			auto targetCuboid = static_cast<const CollisionShape_Cuboid*>(target);
+			return RayBox(targetCuboid->GetPosition(), targetCuboid->GetHalfWidth() + radius, start, delta, fraction, normal);
 		}
-		return false;
+
+		auto cuboid = static_cast<const CollisionShape_Cuboid*>(moving);
+		if (targetIsSphere)
+		{
+			// The sphere moving the other way into the box, seen from the sphere the normal flips
+			auto targetSphere = static_cast<const CollisionShape_Sphere*>(target);
+			if (!RayBox(start, cuboid->GetHalfWidth() + targetSphere->GetRadius().x, targetSphere->GetPosition(), -delta, fraction, normal))
+				return false;
+			normal = -normal;
+			return true;
+		}
+
+		auto targetCuboid = static_cast<const CollisionShape_Cuboid*>(target);
+		const Box movingBox = ToBox(cuboid, start);
+		const Box targetBox = ToBox(targetCuboid, targetCuboid->GetPosition());
+		if (IsAxisAligned(movingBox.axes) && IsAxisAligned(targetBox.axes))
+		{
+			return RayBox(targetBox.position, WorldHalfWidth(targetBox) + WorldHalfWidth(movingBox), start, delta, fraction, normal);
+		}
+		if (!SweepBoxes(movingBox, delta, targetBox, fraction))
+			return false;
+		normal = targetCuboid->GetNormal(start + delta * fraction - targetCuboid->GetPosition());
+		return true;
 	}
-}
\ No newline at end of file
+}
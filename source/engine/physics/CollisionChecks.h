@@ -1,9 +1,48 @@
 #pragma once
 namespace CollisionChecks
 {
+	// Overlap test between two shapes of known types
+	using PairCheck = bool (*)(const CollisionShape* shape1, const CollisionShape* shape2);
+
+	//@brief Checks whether two shapes overlap, dispatching on their shape types
 	bool CheckCollisionBetween(const CollisionShape* shape1, const CollisionShape* shape2);
+	//@brief Returns the overlap test for a pair of shape types
+	//@return PairCheck : Test taking the shapes in the order of the types given
+	PairCheck GetPairCheck(ShapeType type1, ShapeType type2);
 	bool CheckCollisionBetween(const CollisionShape_Cuboid* cuboid1, const CollisionShape_Cuboid* cuboid2);
+	//@brief Checks whether two cuboids overlap, testing the axis that separated them last time first
+	//@param separatingAxis : In, the SAT axis that separated the pair last time. Out, the one that separates it now,
+	// left as it was if the cuboids overlap
+	bool CheckCollisionBetween(const CollisionShape_Cuboid* cuboid1, const CollisionShape_Cuboid* cuboid2, uint8_t& separatingAxis);
 	bool CheckCollisionBetween(const CollisionShape_Sphere* sphere1, const CollisionShape_Sphere* sphere2);
 	bool CheckCollisionBetween(const CollisionShape_Cuboid* cuboid, const CollisionShape_Sphere* sphere);
 	bool CheckCollisionBetween(const CollisionShape_Sphere* sphere, const CollisionShape_Cuboid* cuboid);
+
+	//@brief Finds where two shapes touch, dispatching on their shape types
+	//@param manifold : Set to the contact if the shapes overlap, its normal pointing from shape1 to shape2
+	//@return bool : Whether the shapes overlap
+	bool Collide(const CollisionShape* shape1, const CollisionShape* shape2, ContactManifold& manifold);
+	bool Collide(const CollisionShape_Sphere* sphere1, const CollisionShape_Sphere* sphere2, ContactManifold& manifold);
+	bool Collide(const CollisionShape_Cuboid* cuboid, const CollisionShape_Sphere* sphere, ContactManifold& manifold);
+	bool Collide(const CollisionShape_Sphere* sphere, const CollisionShape_Cuboid* cuboid, ContactManifold& manifold);
+	//@brief Finds where two cuboids touch by SAT, up to four points clipped from the face of least overlap,
+	// or one point between two edges
+	//@param separatingAxis : As for CheckCollisionBetween
+	bool Collide(const CollisionShape_Cuboid* cuboid1, const CollisionShape_Cuboid* cuboid2, ContactManifold& manifold, uint8_t& separatingAxis);
+
+	//@brief Casts the segment origin + t * delta, t from 0 to 1, against a shape
+	//@param fraction : Set to the t of the first hit, 0 if the segment starts inside the shape
+	//@param normal : Set to the surface normal at the hit, facing the segment
+	//@return bool : Whether the segment hits the shape
+	bool Raycast(const CollisionShape* shape, const PhysicsVec3& origin, const PhysicsVec3& delta, PhysicsReal& fraction, PhysicsVec3& normal);
+
+	//@brief Moves a shape by delta from start, keeping its rotation, and finds when it first touches another
+	//@param moving : The shape swept, its own position is ignored
+	//@param start : Position the sweep starts from
+	//@param delta : Movement over the sweep
+	//@param target : The shape swept against
+	//@param fraction : Set to the fraction of delta travelled before contact, 0 if the shapes already overlap
+	//@param normal : Set to the normal of target at the contact, facing the moving shape
+	//@return bool : Whether the shapes touch during the sweep
+	bool Sweep(const CollisionShape* moving, const PhysicsVec3& start, const PhysicsVec3& delta, const CollisionShape* target, PhysicsReal& fraction, PhysicsVec3& normal);
 }
\ No newline at end of file
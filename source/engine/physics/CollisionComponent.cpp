@@ -12,9 +12,12 @@ void CollisionComponent::Init()
 
 void CollisionComponent::Update()
 {
-	this->GetCollisionShape()->SetPosition(pOwner->GetComponent<TransformComponent>()->GetPosition());
-	this->GetCollisionShape()->SetRotation(pOwner->GetComponent<TransformComponent>()->GetRotation());
-	//this->GetCollisionShape()->SetScale(pOwner->GetComponent<TransformComponent>()->GetScale());
+	// Read straight from the transform columns instead of going through the TransformComponent
+	const TransformStorage& transforms = Transform::GetStorage();
+	uint32_t index = transforms.Index(pOwner->GetTransform()->GetHandle());
+	this->GetCollisionShape()->SetPosition(transforms.position[index]);
+	this->GetCollisionShape()->SetRotation(transforms.rotation[index]);
+	//this->GetCollisionShape()->SetScale(transforms.scale[index]);
 }
 
 void CollisionComponent::Shutdown()
@@ -29,57 +32,7 @@ bool CollisionComponent::CanCollideWith(const CollisionComponent* other) const
     return (m_collisionLayer & other->GetCollisionMask()) != 0 && (other->GetCollisionLayer() & m_collisionMask) != 0;
 }
 
-glm::dvec3 CollisionComponent::Cast_LastAvailablePosition
-	(glm::dvec3 startPosition, glm::dvec3 endPosition, glm::dvec3 startRotation, glm::dvec3 endRotation, int iterations = 1)
+bool CollisionComponent::Cast(const PhysicsVec3& startPosition, const PhysicsVec3& endPosition, QueryHit& hit) const
 {
-	CollisionComponent tempComponent = *this;
-	tempComponent.GetCollisionShape()->SetPosition(startPosition);
-	glm::dvec3 lastPosition = startPosition;
-	for (int i = 1; i < iterations; i++)
-	{
-		glm::dvec3 newPosition = startPosition + ((endPosition - startPosition) * static_cast<double>(i / iterations));
-		tempComponent.GetCollisionShape()->SetPosition(newPosition);
-
-		if (SERVICE_LOCATOR.GetCollisionManager()->ShapeIsColliding(&tempComponent)) { break; }
-		lastPosition = newPosition;
-	}
-	return lastPosition;
-}
-
-glm::dvec3 CollisionComponent::Cast_FirstAvailablePosition
-	(glm::dvec3 startPosition, glm::dvec3 endPosition, int iterations = 1)
-{
-	CollisionComponent tempComponent = *this;
-	tempComponent.GetCollisionShape()->SetPosition(startPosition);
-	for (int i = 1; i < iterations; i++)
-	{
-		glm::dvec3 newPosition = startPosition + ((endPosition - startPosition) * static_cast<double>(i / iterations));
-		tempComponent.GetCollisionShape()->SetPosition(newPosition);
-
-		if (!SERVICE_LOCATOR.GetCollisionManager()->ShapeIsColliding(&tempComponent)) { return newPosition; }
-	}
-	return startPosition;
-}
-
-std::pair<CollisionComponent, CollisionComponent*> CollisionComponent::Cast_FirstCollision
-	(glm::dvec3 startPosition, glm::dvec3 endPosition, glm::dvec3 startRotation, glm::dvec3 endRotation, int iterations)
-{
-	assert(iterations > 0 && "Iterations must be greater than 0");
-	CollisionComponent tempComponent = *this;
-	glm::dvec3 lastPosition = startPosition;
-	glm::dvec3 lastRotation = startRotation;
-	glm::dvec3 moveVector = endPosition - startPosition;
-	glm::dvec3 rotateVector = endRotation - startRotation;
-	for (int i = 1; i <= iterations; i++)
-	{
-		glm::dvec3 newPosition = startPosition + (moveVector * static_cast<double>(i) / static_cast<double>(iterations));
-		glm::dvec3 newRotation = startRotation + (rotateVector * static_cast<double>(i) / static_cast<double>(iterations));
-		tempComponent.GetCollisionShape()->SetPosition(newPosition);
-		tempComponent.GetCollisionShape()->SetRotation(newRotation);
-		if (CollisionComponent* collidedObject = SERVICE_LOCATOR.GetCollisionManager()->ShapeIsColliding(this))
-		{
-			return std::make_pair(tempComponent, collidedObject);
-		}
-	}
-	return std::pair{ tempComponent, nullptr };
+	return SERVICE_LOCATOR.GetCollisionManager()->ShapeCast(*m_collisionShape, startPosition, endPosition, hit, GetQueryFilter());
 }
@@ -6,12 +6,10 @@ public:
 	CollisionComponent() : m_collisionLayer(0), m_collisionMask(0) { Init(); }
 	CollisionComponent(int layer, int mask) : m_collisionLayer(layer), m_collisionMask(mask) { Init(); }
 	virtual ~CollisionComponent() { Shutdown(); }
-	CollisionComponent(const CollisionComponent& other)
-		: m_collisionLayer(other.m_collisionLayer), m_collisionMask(other.m_collisionMask)
-	{ 
-		m_collisionShape = other.m_collisionShape->Clone();
-		Init();
-	}
+
+	// A component registers itself with the CollisionManager, copies would register as colliders too
+	CollisionComponent(const CollisionComponent&) = delete;
+	CollisionComponent& operator=(const CollisionComponent&) = delete;
 
 	//@brief Initialize the CollisionComponent
 	virtual void Init() override;
@@ -50,15 +48,17 @@ public:
 	//@return bool True if the objects can collide
 	bool CanCollideWith(const CollisionComponent* other) const;
 
+	//@brief Get the filter of queries cast by this object, which hit what it can collide with except itself
+	//@return QueryFilter The filter to pass to the CollisionManager queries
+	inline QueryFilter GetQueryFilter() const { return { m_collisionLayer, m_collisionMask, this }; }
 
 	// ****** Casting ****** //
-	//@brief Cast a shape between two points and wait until a collision occurs
-	glm::dvec3 Cast_LastAvailablePosition(glm::dvec3 startPosition, glm::dvec3 endPosition, glm::dvec3 startRotation, glm::dvec3 endRotation, int iterations);
-
-	//@brief Cast a shape between two points and return the first available position
-	glm::dvec3 Cast_FirstAvailablePosition(glm::dvec3 startPosition, glm::dvec3 endPosition, int iterations);
-
-	std::pair<CollisionComponent, CollisionComponent*> Cast_FirstCollision(glm::dvec3 startPosition, glm::dvec3 endPosition, glm::dvec3 startRotation, glm::dvec3 endRotation, int iterations = 1);
+	//@brief Sweep this object's shape between two points
+	//@param startPosition : Position the sweep starts from
+	//@param endPosition : Position the sweep ends at
+	//@param hit : Set to the first contact
+	//@return bool True if the shape touches another collider on the way
+	bool Cast(const PhysicsVec3& startPosition, const PhysicsVec3& endPosition, QueryHit& hit) const;
 private:
 	std::unique_ptr<CollisionShape> m_collisionShape;
 
@@ -19,7 +19,7 @@ CollisionManager* CollisionManager::GetInstance()
 	return instance.get();
 }
 
-CollisionManager::CollisionManager()
+CollisionManager::CollisionManager() : m_broadphase(Broadphase::Create(BroadphaseType::AABB_TREE))
 {
 	Init();
 }
@@ -36,33 +36,116 @@ void CollisionManager::Init()
 
 void CollisionManager::Update()
 {
-
-	for (auto& component : m_collisionComponents)
-	{
-		component->Update();
-	}
-	std::vector<std::pair<GameObject*, GameObject*>> collisions;
-	for (int i = 0; i < m_collisionComponents.size(); i++)
-	{
-		CollisionComponent* component1 = m_collisionComponents[i];
-		for (int j = i + 1; j < m_collisionComponents.size(); j++)
+	// Each component only copies its own transform into its own shape and reads back its bounds.
+	// Sleeping bodies cannot have moved, their shapes and bounds are kept as they are
+	const uint32_t count = static_cast<uint32_t>(m_collisionComponents.size());
+	m_bounds.resize(count);
+	m_moved.resize(count);
+	m_narrowphase.Resize(count);
+	SERVICE_LOCATOR.GetJobSystem()->ParallelFor(count, SYNC_BATCH_SIZE,
+		[this](uint32_t begin, uint32_t end)
 		{
-			CollisionComponent* component2 = m_collisionComponents[j];
-			if (component1->CanCollideWith(component2))
+			for (uint32_t i = begin; i < end; ++i)
 			{
-				if (CollisionChecks::CheckCollisionBetween(component1->GetCollisionShape(), component2->GetCollisionShape()))
+				CollisionComponent* component = m_collisionComponents[i];
+				const CollisionShape* shape = component->GetCollisionShape();
+				const PhysicsComponent* physics = component->GetComponent<PhysicsComponent>();
+				if (physics && !physics->IsAwake())
+					m_moved[i] = 0;
+				else
 				{
-					GameObject* obj1 = dynamic_cast<GameObject*>(component1->GetOwner());
-					GameObject* obj2 = dynamic_cast<GameObject*>(component2->GetOwner());
-					if (obj1 && obj2) std::cout << "Collision detected between " << obj1->GetName() << " and " << obj2->GetName() << std::endl;
-					//collisions.push_back(std::make_pair(component1, component2));
-					collisions.push_back(std::make_pair(obj1, obj2));
+					component->Update();
+					const AABB bounds = shape->GetBounds();
+					m_moved[i] = bounds.min != m_bounds[i].min || bounds.max != m_bounds[i].max;
+					m_bounds[i] = bounds;
 				}
+				m_narrowphase.SetShape(i, shape);
 			}
+		});
+
+	// Proxies are made here rather than on registration, the casts register and drop temporary
+	// components between updates that should never reach the broadphase. A collider whose layer,
+	// mask or physics changed is moved to the proxy of its new group
+	for (FilterGroup& group : m_filterGroups)
+		group.colliders = 0;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const Broadphase::GroupId group = findGroup(m_collisionComponents[i], m_groups[i]);
+		if (m_proxies[i] != Broadphase::NULL_PROXY && group != m_groups[i])
+		{
+			m_broadphase->DestroyProxy(m_proxies[i]);
+			m_proxies[i] = Broadphase::NULL_PROXY;
 		}
+		m_groups[i] = group;
+		m_filterGroups[group].colliders++;
+
+		if (m_proxies[i] == Broadphase::NULL_PROXY)
+			m_proxies[i] = m_broadphase->CreateProxy(m_bounds[i], m_collisionComponents[i], group);
+		else if (m_moved[i])
+			m_broadphase->MoveProxy(m_proxies[i], m_bounds[i]);
+
+		if (m_proxies[i] >= m_proxyComponents.size())
+			m_proxyComponents.resize(m_proxies[i] + 1);
+		m_proxyComponents[m_proxies[i]] = i;
+	}
+	m_broadphase->FindPairs(m_pairs);
+
+	// The broadphase only pairs groups that can collide, so every pair goes to the batches. Shapes
+	// were gathered by the sync, pairs refer to them by the index of their component
+	m_candidates.clear();
+	m_narrowphase.Clear();
+	std::fill(m_groupPairs.begin(), m_groupPairs.end(), 0);
+	for (const Broadphase::Pair& pair : m_pairs)
+	{
+		const uint32_t index1 = m_proxyComponents[pair.first];
+		const uint32_t index2 = m_proxyComponents[pair.second];
+		m_candidates.emplace_back(m_collisionComponents[index1], m_collisionComponents[index2]);
+		m_narrowphase.Add(index1, index2, pair.first, pair.second);
+		m_groupPairs[std::min(m_groups[index1], m_groups[index2]) * m_filterGroups.size() + std::max(m_groups[index1], m_groups[index2])]++;
+	}
+	m_narrowphase.Run(m_overlapping, &m_manifolds);
+
+	// The PhysicsManager responds to the contacts on the next step. Pairs are stamped with this update
+	// as they are found, the ones left with an older stamp stopped touching
+	m_frame++;
+	m_contacts.clear();
+	m_events.assign(m_removedEnds.begin(), m_removedEnds.end());
+	m_removedEnds.clear();
+	for (size_t i = 0; i < m_candidates.size(); ++i)
+	{
+		if (!m_overlapping[i])
+			continue;
+
+		CollisionComponent* component1 = m_candidates[i].first;
+		CollisionComponent* component2 = m_candidates[i].second;
+		// Bodies wake each other through their islands, a collider without a body has no island and
+		// wakes the bodies it moves against
+		if (m_moved[m_proxyComponents[m_pairs[i].first]] && !component1->HasComponent<PhysicsComponent>())
+			wake(component2);
+		if (m_moved[m_proxyComponents[m_pairs[i].second]] && !component2->HasComponent<PhysicsComponent>())
+			wake(component1);
+		const uint32_t contact = static_cast<uint32_t>(m_contacts.size());
+		m_contacts.push_back({ component1, component2, m_manifolds[i] });
+
+		auto [pair, inserted] = m_touching.try_emplace(MakePairKey(component1, component2), TouchingPair{ component1, component2, m_frame });
+		pair->second.frame = m_frame;
+		m_events.push_back({ inserted ? ContactEventType::BEGIN : ContactEventType::PERSIST, component1, component2, contact });
 	}
-	PhysicsManager* physicsManager = SERVICE_LOCATOR.GetPhysicsManager();
-	physicsManager->CollisionRouting(collisions);
+	for (auto pair = m_touching.begin(); pair != m_touching.end();)
+	{
+		if (pair->second.frame == m_frame)
+		{
+			++pair;
+			continue;
+		}
+		m_events.push_back({ ContactEventType::END, pair->second.component1, pair->second.component2, NO_CONTACT });
+		pair = m_touching.erase(pair);
+	}
+
+	if (m_logContacts)
+		logContactEvents();
+	for (auto& [id, listener] : m_contactListeners)
+		listener(m_events);
 }
 
 void CollisionManager::Shutdown()
@@ -73,6 +156,7 @@ void CollisionManager::Shutdown()
 		delete m_collisionComponents[0];
 	}
 	m_collisionComponents.clear();
+	m_removedEnds.clear();
 }
 #pragma endregion
 
@@ -80,18 +164,9 @@ void CollisionManager::Shutdown()
 #pragma region CollisionDetection
 CollisionComponent* CollisionManager::ShapeIsColliding(CollisionComponent* component) const
 {
-	for (auto& other : m_collisionComponents)
-	{
-		if (other == component) { continue; }
-		if (component->CanCollideWith(other))
-		{
-			if (CollisionChecks::CheckCollisionBetween(component->GetCollisionShape(), other->GetCollisionShape()))
-			{
-				return other;
-			}
-		}
-	}
-	return nullptr;
+	CollisionComponent* other = nullptr;
+	Overlap(*component->GetCollisionShape(), { &other, 1 }, component->GetQueryFilter());
+	return other;
 }
 
 bool CollisionManager::ShapeIsCollidingWith(CollisionComponent* component, CollisionComponent* other) const
@@ -105,6 +180,115 @@ bool CollisionManager::ShapeIsCollidingWith(CollisionComponent* component, Colli
 }
 #pragma endregion
 
+// ****** Contact Events ****** //
+#pragma region ContactEvents
+uint32_t CollisionManager::AddContactListener(ContactListener listener)
+{
+	m_contactListeners.emplace_back(m_nextContactListener, std::move(listener));
+	return m_nextContactListener++;
+}
+
+void CollisionManager::RemoveContactListener(uint32_t id)
+{
+	std::erase_if(m_contactListeners, [id](const auto& listener) { return listener.first == id; });
+}
+
+void CollisionManager::logContactEvents() const
+{
+	for (const ContactEvent& event : m_events)
+	{
+		if (event.type == ContactEventType::PERSIST)
+			continue;
+		GameObject* obj1 = event.removed & REMOVED_1 ? nullptr : dynamic_cast<GameObject*>(event.component1->GetOwner());
+		GameObject* obj2 = event.removed & REMOVED_2 ? nullptr : dynamic_cast<GameObject*>(event.component2->GetOwner());
+		if (obj1 && obj2)
+			printf("Collision %s between %s and %s\n", event.type == ContactEventType::BEGIN ? "began" : "ended", obj1->GetName().c_str(), obj2->GetName().c_str());
+		else if (event.removed && (obj1 || obj2))
+			printf("Collision ended between %s and a removed collider\n", (obj1 ? obj1 : obj2)->GetName().c_str());
+	}
+}
+#pragma endregion
+
+// ****** Queries ****** //
+#pragma region Queries
+bool CollisionManager::Raycast(const PhysicsVec3& origin, const PhysicsVec3& end, QueryHit& hit, const QueryFilter& filter) const
+{
+	const PhysicsVec3 delta = end - origin;
+	bool found = false;
+	m_broadphase->RayCast(origin, delta, [&](Broadphase::ProxyId proxy, PhysicsReal maxFraction)
+		{
+			CollisionComponent* component = static_cast<CollisionComponent*>(m_broadphase->GetUserData(proxy));
+			PhysicsReal fraction;
+			PhysicsVec3 normal;
+			if (!accepts(filter, component) || !CollisionChecks::Raycast(component->GetCollisionShape(), origin, delta, fraction, normal) || fraction > maxFraction)
+				return maxFraction;
+
+			found = true;
+			hit = { component, origin + delta * fraction, normal, fraction };
+			return fraction;
+		});
+	return found;
+}
+
+bool CollisionManager::ShapeCast(const CollisionShape& shape, const PhysicsVec3& start, const PhysicsVec3& end, QueryHit& hit, const QueryFilter& filter) const
+{
+	// Every collider the shape's bounds pass over is a candidate
+	const PhysicsVec3 delta = end - start;
+	const AABB bounds = shape.GetBounds();
+	const AABB swept = AABB{ bounds.min - shape.GetPosition(), bounds.max - shape.GetPosition() };
+	const AABB travelled = AABB{ start + swept.min, start + swept.max }.Merged({ end + swept.min, end + swept.max });
+
+	bool found = false;
+	hit.fraction = 1.0;
+	m_broadphase->Query(travelled, [&](Broadphase::ProxyId proxy)
+		{
+			CollisionComponent* component = static_cast<CollisionComponent*>(m_broadphase->GetUserData(proxy));
+			PhysicsReal fraction;
+			PhysicsVec3 normal;
+			if (!accepts(filter, component) || !CollisionChecks::Sweep(&shape, start, delta, component->GetCollisionShape(), fraction, normal))
+				return true;
+			if ((fraction <= 0.0 && filter.ignoreInitialOverlaps) || (found && fraction >= hit.fraction))
+				return true;
+
+			found = true;
+			hit = { component, start + delta * fraction, normal, fraction };
+			return true;
+		});
+	return found;
+}
+
+uint32_t CollisionManager::Overlap(const CollisionShape& shape, std::span<CollisionComponent*> results, const QueryFilter& filter) const
+{
+	uint32_t count = 0;
+	if (results.empty())
+		return count;
+
+	m_broadphase->Query(shape.GetBounds(), [&](Broadphase::ProxyId proxy)
+		{
+			CollisionComponent* component = static_cast<CollisionComponent*>(m_broadphase->GetUserData(proxy));
+			if (accepts(filter, component) && CollisionChecks::CheckCollisionBetween(&shape, component->GetCollisionShape()))
+				results[count++] = component;
+			return count < results.size();
+		});
+	return count;
+}
+
+void CollisionManager::wake(CollisionComponent* component)
+{
+	if (PhysicsComponent* physics = component->GetComponent<PhysicsComponent>(); physics && !physics->IsAwake())
+		physics->Wake();
+}
+
+bool CollisionManager::accepts(const QueryFilter& filter, CollisionComponent* component) const
+{
+	if (component == filter.ignore)
+		return false;
+	if ((filter.layer & component->GetCollisionMask()) == 0 || (component->GetCollisionLayer() & filter.mask) == 0)
+		return false;
+	return !filter.staticOnly || !component->HasComponent<PhysicsComponent>();
+}
+#pragma endregion
+
 // ****** CollisionComponent Management ****** //
 #pragma region CollisionComponent Management
 CollisionComponent* CollisionManager::CreateCollisionComponent(int layer, int mask)
@@ -121,6 +305,8 @@ void CollisionManager::AddCollisionComponent(CollisionComponent* component)
 	if (std::find(m_collisionComponents.begin(), m_collisionComponents.end(), component) != m_collisionComponents.end())
 		return;
 	m_collisionComponents.push_back(component);
+	m_proxies.push_back(Broadphase::NULL_PROXY);
+	m_groups.push_back(0);
 }
 
 void CollisionManager::RemoveCollisionComponent(CollisionComponent* component)
@@ -128,7 +314,286 @@ void CollisionManager::RemoveCollisionComponent(CollisionComponent* component)
 	auto it = std::find(m_collisionComponents.begin(), m_collisionComponents.end(), component);
 	if (it != m_collisionComponents.end())
 	{
+		auto proxy = m_proxies.begin() + (it - m_collisionComponents.begin());
+		if (*proxy != Broadphase::NULL_PROXY)
+			m_broadphase->DestroyProxy(*proxy);
+		m_proxies.erase(proxy);
+		m_groups.erase(m_groups.begin() + (it - m_collisionComponents.begin()));
+		if (static_cast<size_t>(it - m_collisionComponents.begin()) < m_bounds.size())
+			m_bounds.erase(m_bounds.begin() + (it - m_collisionComponents.begin()));
 		m_collisionComponents.erase(it);
+		// The solver reads the contacts on the next step, after gameplay may have destroyed colliders. Pairs of
+		// a removed collider end with the next update's events, flagged so its pointer is not followed. Bodies
+		// resting on it are woken to fall
+		for (ContactEvent& event : m_removedEnds)
+		{
+			if (event.component1 == component)
+				event.removed |= REMOVED_1;
+			else if (event.component2 == component)
+				event.removed |= REMOVED_2;
+		}
+		for (const auto& [key, pair] : m_touching)
+		{
+			if (pair.component1 == component)
+			{
+				wake(pair.component2);
+				m_removedEnds.push_back({ ContactEventType::END, pair.component1, pair.component2, NO_CONTACT, REMOVED_1 });
+			}
+			else if (pair.component2 == component)
+			{
+				wake(pair.component1);
+				m_removedEnds.push_back({ ContactEventType::END, pair.component1, pair.component2, NO_CONTACT, REMOVED_2 });
+			}
+		}
+		std::erase_if(m_contacts, [component](const Contact& contact) { return contact.component1 == component || contact.component2 == component; });
+		std::erase_if(m_touching, [component](const auto& pair) { return pair.second.component1 == component || pair.second.component2 == component; });
+	}
+}
+#pragma endregion
+
+// ****** Broadphase ****** //
+#pragma region Broadphase
+void CollisionManager::SetBroadphase(BroadphaseType type)
+{
+	if (m_broadphase->GetType() == type)
+		return;
+	m_broadphase = Broadphase::Create(type);
+	if (!m_filterGroups.empty())
+		m_broadphase->SetGroupFilter(static_cast<uint32_t>(m_filterGroups.size()), m_groupCanPair);
+	std::fill(m_proxies.begin(), m_proxies.end(), Broadphase::NULL_PROXY);
+}
+
+void CollisionManager::ShiftOrigin(const glm::dvec3& shift)
+{
+	// Same rounded offset the transforms got, the next sync then finds nothing else to move
+	const PhysicsVec3 offset = glm::vec3(shift);
+	for (uint32_t i = 0; i < m_collisionComponents.size(); ++i)
+	{
+		Node* owner = m_collisionComponents[i]->GetOwner();
+		if (!owner || owner->GetParent())
+			continue;
+		CollisionShape* shape = m_collisionComponents[i]->GetCollisionShape();
+		shape->SetPosition(shape->GetPosition() + offset);
+		if (i >= m_bounds.size())
+			continue;
+		m_bounds[i] = shape->GetBounds();
+		if (m_proxies[i] != Broadphase::NULL_PROXY)
+			m_broadphase->MoveProxy(m_proxies[i], m_bounds[i]);
+	}
+	for (Contact& contact : m_contacts)
+	{
+		for (uint32_t point = 0; point < contact.manifold.pointCount; ++point)
+			contact.manifold.points[point] += offset;
 	}
 }
-#pragma endregion
\ No newline at end of file
+
+void CollisionManager::BenchmarkBroadphase(std::span<const uint32_t> counts)
+{
+	static constexpr uint32_t STEPS = 20;
+	static constexpr const char* NAMES[] = { "brute force", "aabb tree", "sweep and prune" };
+
+	printf("%-16s %10s %12s %12s %14s %10s\n", "broadphase", "colliders", "build ms", "step ms", "bounds tests", "pairs");
+	for (uint32_t count : counts)
+	{
+		// Unit boxes in a cube that grows with the count, so every collider has about the same number of neighbours
+		std::mt19937 random(count);
+		double extent = std::cbrt(static_cast<double>(count)) * 2.0;
+		std::uniform_real_distribution<double> place(0.0, extent);
+		std::uniform_real_distribution<double> nudge(-0.25, 0.25);
+		std::vector<AABB> start(count);
+		for (AABB& bounds : start)
+		{
+			bounds.min = PhysicsVec3(place(random), place(random), place(random));
+			bounds.max = bounds.min + PhysicsReal(1);
+		}
+
+		for (BroadphaseType type : { BroadphaseType::BRUTE_FORCE, BroadphaseType::AABB_TREE, BroadphaseType::SWEEP_AND_PRUNE })
+		{
+			const char* name = NAMES[static_cast<int>(type)];
+			if (type == BroadphaseType::BRUTE_FORCE && count > BRUTE_FORCE_BENCHMARK_LIMIT)
+			{
+				printf("%-16s %10u %12s\n", name, count, "skipped");
+				continue;
+			}
+
+			std::unique_ptr<Broadphase> broadphase = Broadphase::Create(type);
+			std::vector<AABB> bounds = start;
+			std::vector<Broadphase::ProxyId> proxies(count);
+			std::vector<Broadphase::Pair> pairs;
+			std::mt19937 motion(count);
+
+			auto begin = std::chrono::high_resolution_clock::now();
+			for (uint32_t i = 0; i < count; ++i)
+				proxies[i] = broadphase->CreateProxy(bounds[i], nullptr);
+			broadphase->FindPairs(pairs);
+			double buildMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count();
+
+			// Every collider is handed its bounds each step, as Update does, but only a tenth of them moved
+			double stepMs = 0.0;
+			uint64_t tests = 0;
+			for (uint32_t step = 0; step < STEPS; ++step)
+			{
+				for (uint32_t i = step % 10; i < count; i += 10)
+				{
+					PhysicsVec3 offset(nudge(motion), nudge(motion), nudge(motion));
+					bounds[i].min += offset;
+					bounds[i].max += offset;
+				}
+
+				begin = std::chrono::high_resolution_clock::now();
+				for (uint32_t i = 0; i < count; ++i)
+					broadphase->MoveProxy(proxies[i], bounds[i]);
+				broadphase->FindPairs(pairs);
+				stepMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count();
+				tests += broadphase->GetStats().boundsTests;
+			}
+
+			printf("%-16s %10u %12.3f %12.3f %14llu %10u\n", name, count, buildMs, stepMs / STEPS,
+				static_cast<unsigned long long>(tests / STEPS), broadphase->GetStats().pairs);
+		}
+	}
+}
+
+void CollisionManager::BenchmarkNarrowphase(std::span<const uint32_t> counts)
+{
+	static constexpr uint32_t REPEATS = 20;
+
+	printf("narrowphase: %u pairs per instruction\n", Narrowphase::LANES);
+	printf("%-14s %10s %16s %16s %12s %10s %10s\n", "pairs", "count", "scalar pairs/us", "batched pairs/us", "gather us", "overlaps", "mismatches");
+	for (uint32_t count : counts)
+	{
+		// Shapes scattered over a box small enough that a good share of the pairs overlap
+		std::mt19937 random(count);
+		std::uniform_real_distribution<double> place(-1.0, 1.0);
+		std::uniform_real_distribution<double> size(0.5, 1.5);
+		std::vector<CollisionShape_Sphere> spheres(count);
+		std::vector<CollisionShape_Cuboid> cuboids(count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			spheres[i].SetPosition(place(random), place(random), place(random));
+			spheres[i].SetDiameter(size(random));
+			cuboids[i].SetPosition(place(random), place(random), place(random));
+			cuboids[i].SetScale(size(random), size(random), size(random));
+		}
+
+		// Colliders 0 to count - 1 are the spheres, count to 2 * count - 1 the cuboids
+		std::vector<const CollisionShape*> shapes(count * 2);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			shapes[i] = &spheres[i];
+			shapes[count + i] = &cuboids[i];
+		}
+
+		auto measure = [&](const char* name, uint32_t secondOffset)
+		{
+			std::vector<Broadphase::Pair> pairs(count);
+			for (uint32_t i = 0; i < count; ++i)
+				pairs[i] = { i, secondOffset + (i * 7919u + 1u) % count };
+
+			// Scalar: one dispatched check per pair. Batched: grouping and testing the pairs, the shapes are
+			// gathered beforehand as the sync does in the collision update, and that is timed on its own
+			std::vector<uint8_t> scalar(count);
+			auto begin = std::chrono::high_resolution_clock::now();
+			for (uint32_t repeat = 0; repeat < REPEATS; ++repeat)
+			{
+				for (uint32_t i = 0; i < count; ++i)
+					scalar[i] = CollisionChecks::CheckCollisionBetween(shapes[pairs[i].first], shapes[pairs[i].second]) ? 1 : 0;
+			}
+			double scalarUs = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - begin).count();
+
+			Narrowphase narrowphase;
+			narrowphase.Resize(count * 2);
+			begin = std::chrono::high_resolution_clock::now();
+			for (uint32_t repeat = 0; repeat < REPEATS; ++repeat)
+			{
+				for (uint32_t i = 0; i < count * 2; ++i)
+					narrowphase.SetShape(i, shapes[i]);
+			}
+			double gatherUs = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - begin).count();
+
+			std::vector<uint8_t> batched;
+			begin = std::chrono::high_resolution_clock::now();
+			for (uint32_t repeat = 0; repeat < REPEATS; ++repeat)
+			{
+				narrowphase.Clear();
+				for (const Broadphase::Pair& pair : pairs)
+					narrowphase.Add(pair.first, pair.second);
+				narrowphase.Run(batched);
+			}
+			double batchedUs = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - begin).count();
+
+			uint32_t mismatches = 0;
+			for (uint32_t i = 0; i < count; ++i)
+				mismatches += scalar[i] != batched[i] ? 1 : 0;
+			double tested = static_cast<double>(count) * REPEATS;
+			printf("%-14s %10u %16.1f %16.1f %12.1f %10u %10u\n", name, count, tested / std::max(scalarUs, 1e-3), tested / std::max(batchedUs, 1e-3),
+				gatherUs / REPEATS, narrowphase.GetStats().overlaps, mismatches);
+		};
+		measure("sphere-sphere", 0);
+		measure("sphere-cuboid", count);
+	}
+}
+#pragma endregion
+
+// ****** Filter Groups ****** //
+#pragma region FilterGroups
+Broadphase::GroupId CollisionManager::findGroup(CollisionComponent* component, Broadphase::GroupId current)
+{
+	const int layer = component->GetCollisionLayer();
+	const int mask = component->GetCollisionMask();
+	const bool isStatic = !component->HasComponent<PhysicsComponent>();
+	auto matches = [&](const FilterGroup& group) { return group.layer == layer && group.mask == mask && group.isStatic == isStatic; };
+
+	// Colliders rarely change group, and scenes only use a handful of them
+	if (current < m_filterGroups.size() && matches(m_filterGroups[current]))
+		return current;
+	for (Broadphase::GroupId group = 0; group < m_filterGroups.size(); ++group)
+	{
+		if (matches(m_filterGroups[group]))
+			return group;
+	}
+
+	// Groups are only ever added, so the pairs the broadphase keeps between the others stay valid
+	m_filterGroups.push_back({ layer, mask, isStatic });
+	const size_t count = m_filterGroups.size();
+	m_groupCanPair.assign(count * count, 0);
+	for (size_t i = 0; i < count; ++i)
+	{
+		for (size_t j = 0; j < count; ++j)
+		{
+			const FilterGroup& group1 = m_filterGroups[i];
+			const FilterGroup& group2 = m_filterGroups[j];
+			m_groupCanPair[i * count + j] = !(group1.isStatic && group2.isStatic)
+				&& (group1.layer & group2.mask) != 0 && (group2.layer & group1.mask) != 0;
+		}
+	}
+	m_groupPairs.assign(count * count, 0);
+	m_broadphase->SetGroupFilter(static_cast<uint32_t>(count), m_groupCanPair);
+	return static_cast<Broadphase::GroupId>(count - 1);
+}
+
+uint32_t CollisionManager::GetGroupPairs(Broadphase::GroupId group1, Broadphase::GroupId group2) const
+{
+	return m_groupPairs[std::min(group1, group2) * m_filterGroups.size() + std::max(group1, group2)];
+}
+
+void CollisionManager::PrintFilterGroups() const
+{
+	printf("%-6s %10s %10s %8s %10s\n", "group", "layer", "mask", "static", "colliders");
+	for (size_t group = 0; group < m_filterGroups.size(); ++group)
+	{
+		const FilterGroup& filterGroup = m_filterGroups[group];
+		printf("%-6zu %10d %10d %8s %10u\n", group, filterGroup.layer, filterGroup.mask, filterGroup.isStatic ? "yes" : "no", filterGroup.colliders);
+	}
+
+	printf("%-6s %6s %10s\n", "group", "with", "pairs");
+	for (Broadphase::GroupId group1 = 0; group1 < m_filterGroups.size(); ++group1)
+	{
+		for (Broadphase::GroupId group2 = group1; group2 < m_filterGroups.size(); ++group2)
+		{
+			if (CanPair(group1, group2))
+				printf("%-6u %6u %10u\n", group1, group2, GetGroupPairs(group1, group2));
+		}
+	}
+}
+#pragma endregion
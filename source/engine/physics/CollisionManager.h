@@ -5,6 +5,52 @@ class CollisionComponent;
 class CollisionManager
 {
 public:
+	// Two colliders found overlapping by the last update
+	struct Contact
+	{
+		CollisionComponent* component1;
+		CollisionComponent* component2;
+		ContactManifold manifold;		// normal from component1 to component2
+	};
+
+	// Whether a pair of colliders started touching in the last update, kept touching or stopped
+	enum class ContactEventType : uint8_t
+	{
+		BEGIN,
+		PERSIST,
+		END
+	};
+
+	struct ContactEvent
+	{
+		ContactEventType type;
+		CollisionComponent* component1;
+		CollisionComponent* component2;
+		uint32_t contact;				// index in GetContacts, NO_CONTACT for END events
+		uint8_t removed = 0;			// REMOVED_1 and REMOVED_2 of the colliders removed since, only compare their pointers
+	};
+	static constexpr uint32_t NO_CONTACT = ~0u;
+	static constexpr uint8_t REMOVED_1 = 1 << 0;
+	static constexpr uint8_t REMOVED_2 = 1 << 1;
+
+	// Called once per update with the events of every pair
+	using ContactListener = std::function<void(std::span<const ContactEvent>)>;
+
+	// Identifies a pair of colliders whichever order they were found in, the lower address first
+	using PairKey = std::pair<const CollisionComponent*, const CollisionComponent*>;
+	struct PairKeyHash
+	{
+		size_t operator()(const PairKey& key) const
+		{
+			return std::hash<const void*>()(key.first) ^ (std::hash<const void*>()(key.second) * 31);
+		}
+	};
+	//@brief Returns the key of a pair of colliders
+	static inline PairKey MakePairKey(const CollisionComponent* component1, const CollisionComponent* component2)
+	{
+		return component1 < component2 ? PairKey(component1, component2) : PairKey(component2, component1);
+	}
+
 	~CollisionManager();
 
 	//@brief Initializes the collision manager
@@ -20,18 +66,53 @@ public:
 	CollisionComponent* ShapeIsColliding(CollisionComponent* component) const;
 	//@brief Checks if a collision component is colliding with another collision component
 	bool ShapeIsCollidingWith(CollisionComponent* component, CollisionComponent* other) const;
+	//@brief Returns every pair of colliders the last update found overlapping, with where they touch
+	inline const std::vector<Contact>& GetContacts() const { return m_contacts; }
 
-// ****** Collision Response ****** //
+// ****** Contact Events ****** //
 
-	//@brief Handles a collision between two collision components
-	void CollisionResponse(std::pair<CollisionComponent*, CollisionComponent*> collision);
-	void CollisionResponse(CollisionComponent* shape1, CollisionComponent* shape2);
-	//@brief Handles a collision between a static and dynamic collision component
-	void StaticDynamicResponse(CollisionComponent* staticObject, CollisionComponent* dynamicObject);
-	//@brief Handles a collision between two dynamic collision components
-	void DynamicDynamicCollision(CollisionComponent* component1, CollisionComponent* component2);
-	//@brief Handles a collision between two dynamic collision components
-	void DynamicBounce(CollisionComponent* shape1, CollisionComponent* shape2);
+	//@brief Registers a function that receives the contact events of every update in one batch, after the
+	// contacts are found. Listeners must not destroy colliders or add and remove listeners while they
+	// handle a batch. They run once per physics step on a job system worker, inside the frame's Simulation
+	// task, in parallel with Audio and Camera and before the main thread Events, Scripts and Game. They
+	// must not touch GL, Lua, audio or the camera; copy what the game needs and act on it from there
+	//@param listener : Function to call
+	//@return uint32_t : Id to remove the listener with
+	uint32_t AddContactListener(ContactListener listener);
+	//@brief Stops calling a listener
+	//@param id : Id returned by AddContactListener
+	void RemoveContactListener(uint32_t id);
+	//@brief Returns the contact events of the last update
+	inline std::span<const ContactEvent> GetContactEvents() const { return m_events; }
+	//@brief Prints the pairs that start and stop touching to the console, for debugging
+	//@param log : Whether to print them
+	inline void SetContactLogging(bool log) { m_logContacts = log; }
+
+// ****** Queries ****** //
+// Queries only look at colliders the broadphase returns and allocate nothing. Colliders are seen
+// where the last Update put them, and from their first Update on
+
+	//@brief Casts a segment against the colliders
+	//@param origin : Start of the segment
+	//@param end : End of the segment
+	//@param hit : Set to the nearest hit
+	//@param filter : Colliders the segment can hit
+	//@return bool : Whether anything was hit
+	bool Raycast(const PhysicsVec3& origin, const PhysicsVec3& end, QueryHit& hit, const QueryFilter& filter = {}) const;
+	//@brief Moves a shape from start to end, keeping its rotation, and finds the first collider it touches
+	//@param shape : Shape to sweep, its own position is ignored
+	//@param start : Position the sweep starts from
+	//@param end : Position the sweep ends at
+	//@param hit : Set to the first contact
+	//@param filter : Colliders the shape can hit
+	//@return bool : Whether anything was hit
+	bool ShapeCast(const CollisionShape& shape, const PhysicsVec3& start, const PhysicsVec3& end, QueryHit& hit, const QueryFilter& filter = {}) const;
+	//@brief Finds the colliders overlapping a shape where it stands
+	//@param shape : Shape to test
+	//@param results : Filled with the colliders found, the query stops once it is full
+	//@param filter : Colliders that can be reported
+	//@return uint32_t : Number of colliders written to results
+	uint32_t Overlap(const CollisionShape& shape, std::span<CollisionComponent*> results, const QueryFilter& filter = {}) const;
 
 // ****** CollisionComponent Management ****** //
 
@@ -47,14 +128,113 @@ public:
 	//@param component : The collision component to remove
 	void RemoveCollisionComponent(CollisionComponent* component);
 
+// ****** Broadphase ****** //
+
+	//@brief Switches the strategy used to find candidate pairs, the colliders are moved over on the next update
+	//@param type : Broadphase strategy
+	void SetBroadphase(BroadphaseType type);
+	//@brief Returns the strategy used to find candidate pairs
+	inline BroadphaseType GetBroadphaseType() const { return m_broadphase->GetType(); }
+	//@brief Returns the work the broadphase did in the last update
+	inline const Broadphase::Stats& GetBroadphaseStats() const { return m_broadphase->GetStats(); }
+
+	//@brief Moves the shapes, bounds and contacts of colliders on root nodes along with their transforms when
+	// the Scene rebases its origin, so queries before the next update see them where they now are. Every
+	// proxy moves at once, which costs the broadphase about as much as rebuilding it
+	//@param shift : Offset added to every root position
+	void ShiftOrigin(const glm::dvec3& shift);
+
+	//@brief Runs every broadphase strategy over randomly placed colliders, a tenth of them moving each step,
+	// and prints the time, bounds tests and candidate pairs per step. Colliders of the scene are not touched
+	//@param counts : Collider counts to measure
+	void BenchmarkBroadphase(std::span<const uint32_t> counts);
+	//@brief Tests random sphere-sphere and sphere-cuboid pairs one at a time through the pair table and in
+	// batches, and prints the pairs tested per microsecond by each along with any pair they disagree on
+	//@param counts : Pair counts to measure
+	void BenchmarkNarrowphase(std::span<const uint32_t> counts);
+	//@brief Returns the pairs the narrowphase tested in the last update
+	inline const Narrowphase::Stats& GetNarrowphaseStats() const { return m_narrowphase.GetStats(); }
+
+// ****** Filter Groups ****** //
+
+	// Colliders with the same layer and mask that are all static or all moving. Each group has its own
+	// bucket in the broadphase, which only looks for pairs between groups whose layers and masks match.
+	// Static groups never pair with each other
+	struct FilterGroup
+	{
+		int layer;
+		int mask;
+		bool isStatic;				// colliders without a PhysicsComponent
+		uint32_t colliders = 0;		// in the group as of the last update
+	};
+
+	//@brief Returns the groups of colliders seen so far
+	inline const std::vector<FilterGroup>& GetFilterGroups() const { return m_filterGroups; }
+	//@brief Returns whether colliders of two groups are ever paired
+	inline bool CanPair(Broadphase::GroupId group1, Broadphase::GroupId group2) const { return m_groupCanPair[group1 * m_filterGroups.size() + group2] != 0; }
+	//@brief Returns the candidate pairs the last update found between two groups
+	uint32_t GetGroupPairs(Broadphase::GroupId group1, Broadphase::GroupId group2) const;
+	//@brief Prints every group with its colliders, and the candidate pairs of the last update between every two groups that can pair
+	void PrintFilterGroups() const;
+
 private:
 	CollisionManager();
 
+	// Components per job when shapes are synced with their transforms
+	static constexpr uint32_t SYNC_BATCH_SIZE = 256;
+	// Colliders above which the benchmark skips the brute force strategy
+	static constexpr uint32_t BRUTE_FORCE_BENCHMARK_LIMIT = 10000;
+
+	//@brief Prints the pairs of the last update that started and stopped touching
+	void logContactEvents() const;
+
+	//@brief Returns the group of a collider, adding the group if it is the first of its kind
+	//@param component : The collider
+	//@param current : Group the collider was in at the last update, checked first
+	Broadphase::GroupId findGroup(CollisionComponent* component, Broadphase::GroupId current);
+
+	//@brief Wakes the body of a collider if it is sleeping
+	void wake(CollisionComponent* component);
+
+	//@brief Returns whether a query with this filter can report a collider
+	bool accepts(const QueryFilter& filter, CollisionComponent* component) const;
+
 	//@brief Returns the instance of the collision manager
 	static CollisionManager* GetInstance();
 	static std::unique_ptr<CollisionManager> instance;
 
 	std::vector<CollisionComponent*> m_collisionComponents;
+	std::vector<Broadphase::ProxyId> m_proxies;		// proxy of each component, NULL_PROXY until its first update
+	std::vector<Broadphase::GroupId> m_groups;		// filter group of each component's proxy
+	std::vector<uint32_t> m_proxyComponents;		// index of the component of each proxy, as of the last update
+	std::vector<AABB> m_bounds;						// bounds of each component, refreshed by the sync
+	std::vector<uint8_t> m_moved;					// whether the bounds of each component changed in the last sync
+	std::vector<Broadphase::Pair> m_pairs;
+	std::unique_ptr<Broadphase> m_broadphase;
+	std::vector<FilterGroup> m_filterGroups;
+	std::vector<uint8_t> m_groupCanPair;			// group count * group count flags by row, handed to the broadphase
+	std::vector<uint32_t> m_groupPairs;				// candidate pairs between two groups, lower group first by row
+	std::vector<std::pair<CollisionComponent*, CollisionComponent*>> m_candidates;
+	std::vector<uint8_t> m_overlapping;				// whether each candidate overlaps, filled by the narrowphase
+	std::vector<ContactManifold> m_manifolds;		// contact of each candidate that overlaps
+	std::vector<Contact> m_contacts;
+
+	// Pairs touching as of the last update, stamped with the update they were last seen touching in. A pair
+	// allocates its entry when it starts touching and nothing after that
+	struct TouchingPair
+	{
+		CollisionComponent* component1;
+		CollisionComponent* component2;
+		uint32_t frame;
+	};
+	std::unordered_map<PairKey, TouchingPair, PairKeyHash> m_touching;
+	std::vector<ContactEvent> m_events;
+	std::vector<ContactEvent> m_removedEnds;		// END events of the pairs of removed colliders, sent with the next update
+	std::vector<std::pair<uint32_t, ContactListener>> m_contactListeners;
+	uint32_t m_nextContactListener = 0;
+	uint32_t m_frame = 0;
+	bool m_logContacts = false;
+	Narrowphase m_narrowphase;
 
 	friend class ServiceLocator;
 };
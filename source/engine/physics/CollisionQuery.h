@@ -0,0 +1,22 @@
+#pragma once
+
+class CollisionComponent;
+
+// Which colliders a raycast, shape cast or overlap query can report
+struct QueryFilter
+{
+	int layer = ~0;									// Layers the query is on, tested against each collider's mask
+	int mask = ~0;									// Layers of the colliders the query can hit
+	const CollisionComponent* ignore = nullptr;		// Collider never reported, usually the one casting
+	bool staticOnly = false;						// Skip colliders whose object has a PhysicsComponent
+	bool ignoreInitialOverlaps = false;				// Skip colliders a cast already overlaps where it starts
+};
+
+// First collider a raycast or shape cast reaches
+struct QueryHit
+{
+	CollisionComponent* component = nullptr;		// Collider hit
+	PhysicsVec3 position{ 0.0 };						// Raycasts: point hit. Shape casts: position of the cast shape at contact
+	PhysicsVec3 normal{ 0.0 };						// Surface normal of the collider hit, facing the cast
+	PhysicsReal fraction = 1.0;							// Fraction of the cast travelled before the hit
+};
@@ -1,2 +1,11 @@
 #include "../pch.h"
 
+void CollisionShape::updateAxes()
+{
+	// same order as TransformStorage::SetRotation, around x, then y, then z
+	PhysicsVec3 radians = glm::radians(m_rotation);
+	PhysicsQuat orientation = glm::angleAxis(radians.x, PhysicsVec3(1.0, 0.0, 0.0))
+		* glm::angleAxis(radians.y, PhysicsVec3(0.0, 1.0, 0.0))
+		* glm::angleAxis(radians.z, PhysicsVec3(0.0, 0.0, 1.0));
+	m_axes = glm::mat3_cast(orientation);
+}
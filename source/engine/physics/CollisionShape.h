@@ -1,54 +1,77 @@
 #pragma once
 class RenderComponent;
+
+// Concrete type of a collision shape, indexes the pair tables of the narrowphase
+enum class ShapeType : uint8_t
+{
+	SPHERE,
+	CUBOID,
+	COUNT
+};
+
 class CollisionShape : public IHasGettersSetters
 {
 public:
-	CollisionShape() : m_position(0.0), m_rotation(0.0), m_scale(1.0) {}
+	explicit CollisionShape(ShapeType type) : m_position(0.0), m_rotation(0.0), m_scale(1.0), m_axes(1.0), m_type(type) {}
 	virtual ~CollisionShape() {}
 	virtual std::unique_ptr<CollisionShape> Clone() const = 0;
 
 	//@brief Set the position of the collision shape
 	//@param position : The position to set
-	inline void SetPosition(const glm::dvec3& position) { m_position = position; }
+	inline void SetPosition(const PhysicsVec3& position) { m_position = position; }
 	//@brief Set the position of the collision shape
 	//@param x : The x component of the position
 	//@param y : The y component of the position
 	//@param z : The z component of the position
-	inline void SetPosition(double x, double y, double z) { m_position = glm::dvec3(x, y, z); }
+	inline void SetPosition(PhysicsReal x, PhysicsReal y, PhysicsReal z) { m_position = PhysicsVec3(x, y, z); }
 	//@brief Get the position of the collision shape
-	inline glm::dvec3 GetPosition() const { return m_position; }
+	inline PhysicsVec3 GetPosition() const { return m_position; }
 
-	//@brief Set the rotation of the collision shape
-	inline void SetRotation(const glm::dvec3& rotation) { m_rotation = rotation; }
+	//@brief Set the rotation of the collision shape, Euler angles in degrees as on the transform
+	inline void SetRotation(const PhysicsVec3& rotation) { if (rotation != m_rotation) { m_rotation = rotation; updateAxes(); } }
 	//@brief Set the rotation of the collision shape
 	//@param x : The x component of the rotation
 	//@param y : The y component of the rotation
 	//@param z : The z component of the rotation
-	inline void SetRotation(double x, double y, double z) { m_rotation = glm::dvec3(x, y, z); }
+	inline void SetRotation(PhysicsReal x, PhysicsReal y, PhysicsReal z) { SetRotation(PhysicsVec3(x, y, z)); }
 	//@brief Get the rotation of the collision shape
-	inline glm::dvec3 GetRotation() const { return m_rotation; }
+	inline PhysicsVec3 GetRotation() const { return m_rotation; }
+	//@brief Get the local x, y and z axes of the collision shape in world space, one per column.
+	// Cached when the rotation changes so the checks never convert Euler angles per pair
+	inline const PhysicsMat3& GetAxes() const { return m_axes; }
 
 	//@brief Set the scale of the collision shape
-	inline void SetScale(const glm::dvec3& scale) { m_scale = scale; }
+	inline void SetScale(const PhysicsVec3& scale) { m_scale = scale; }
 	//@brief Set the scale of the collision shape
 	//@param x : The x component of the scale
 	//@param y : The y component of the scale
 	//@param z : The z component of the scale
-	inline void SetScale(double x, double y, double z) { m_scale = glm::dvec3(x, y, z); }
+	inline void SetScale(PhysicsReal x, PhysicsReal y, PhysicsReal z) { m_scale = PhysicsVec3(x, y, z); }
 	//@brief Get the scale of the collision shape
-	inline glm::dvec3 GetScale() const { return m_scale; }
+	inline PhysicsVec3 GetScale() const { return m_scale; }
 
 	//@brief Get the normal of the collision shape
 	//@param dir : The direction from shape center to get the normal from
 	//@return The normal of the collision shape at the point intercepted by the direction
-	virtual glm::dvec3 GetNormal(const glm::dvec3& dir) const = 0;
+	virtual PhysicsVec3 GetNormal(const PhysicsVec3& dir) const = 0;
+
+	//@brief Get the world bounds of the collision shape, as used by the broadphase
+	virtual AABB GetBounds() const = 0;
 
 	virtual std::string GetShapeType() const = 0;
+	//@brief Get the concrete type of the collision shape, what the checks dispatch on instead of a dynamic_cast
+	inline ShapeType GetType() const { return m_type; }
 
 protected:
-	glm::dvec3 m_position;
-	glm::dvec3 m_rotation;
-	glm::dvec3 m_scale;
+	PhysicsVec3 m_position;
+	PhysicsVec3 m_rotation;
+	PhysicsVec3 m_scale;
+	PhysicsMat3 m_axes;
+	ShapeType m_type;
 
 	void defineMember() override {}
+
+private:
+	//@brief Recomputes the world axes from the rotation, in the order the transform applies it
+	void updateAxes();
 };
@@ -1,12 +1,12 @@
 #include "../pch.h"
 #include "CollisionShape_Cuboid.h"
 
-glm::dvec3 CollisionShape_Cuboid::GetNormal(const glm::dvec3& dir) const
+PhysicsVec3 CollisionShape_Cuboid::GetNormal(const PhysicsVec3& dir) const
 {
 
-	glm::dvec3 normal(0.0);
+	PhysicsVec3 normal(0.0);
 	// Get the absolute direction to compare for the largest component
-	glm::dvec3 absDir = glm::abs(dir);
+	PhysicsVec3 absDir = glm::abs(dir);
 
 	if (absDir.x > absDir.y && absDir.x > absDir.z)
 	{
@@ -22,4 +22,14 @@ glm::dvec3 CollisionShape_Cuboid::GetNormal(const glm::dvec3& dir) const
 	}
 
 	return normal;
-}
\ No newline at end of file
+}
+
+AABB CollisionShape_Cuboid::GetBounds() const
+{
+	// Boxes are tested against boxes with their rotation but against spheres and rays without it,
+	// the bounds cover both
+	PhysicsVec3 halfWidth = glm::abs(GetHalfWidth());
+	PhysicsVec3 rotatedHalfWidth = glm::abs(m_axes[0]) * halfWidth.x + glm::abs(m_axes[1]) * halfWidth.y + glm::abs(m_axes[2]) * halfWidth.z;
+	PhysicsVec3 extent = glm::max(halfWidth, rotatedHalfWidth);
+	return { m_position - extent, m_position + extent };
+}
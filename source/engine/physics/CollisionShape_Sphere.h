@@ -2,29 +2,35 @@
 class CollisionShape_Sphere : public CollisionShape
 {
 public:
-	CollisionShape_Sphere() { defineMember(); }
+	CollisionShape_Sphere() : CollisionShape(ShapeType::SPHERE) { defineMember(); }
 	~CollisionShape_Sphere() {}
 	std::unique_ptr<CollisionShape> Clone() const override { return std::unique_ptr<CollisionShape_Sphere>(new CollisionShape_Sphere(*this)); }
 
-	inline glm::dvec3 GetRadius() const { return m_scale * 0.5; }
-	inline void SetRadius(glm::dvec3 radius) { m_scale = glm::dvec3(radius * 0.5); }
-	inline void SetRadius(double x, double y, double z) { m_scale = glm::dvec3(x, y, z) * 0.5; }
-	inline void SetRadius(double radius) { m_scale = glm::dvec3(radius * 0.5); }
-	inline glm::dvec3 GetDiameter() const { return m_scale; }
-	inline void SetDiameter(glm::dvec3 diameter) { m_scale = diameter; }
-	inline void SetDiameter(double x, double y, double z) { m_scale = glm::dvec3(x, y, z); }
-	inline void SetDiameter(double diameter) { m_scale = glm::dvec3(diameter); }
+	inline PhysicsVec3 GetRadius() const { return m_scale * PhysicsReal(0.5); }
+	inline void SetRadius(PhysicsVec3 radius) { m_scale = radius * PhysicsReal(0.5); }
+	inline void SetRadius(PhysicsReal x, PhysicsReal y, PhysicsReal z) { m_scale = PhysicsVec3(x, y, z) * PhysicsReal(0.5); }
+	inline void SetRadius(PhysicsReal radius) { m_scale = PhysicsVec3(radius * PhysicsReal(0.5)); }
+	inline PhysicsVec3 GetDiameter() const { return m_scale; }
+	inline void SetDiameter(PhysicsVec3 diameter) { m_scale = diameter; }
+	inline void SetDiameter(PhysicsReal x, PhysicsReal y, PhysicsReal z) { m_scale = PhysicsVec3(x, y, z); }
+	inline void SetDiameter(PhysicsReal diameter) { m_scale = PhysicsVec3(diameter); }
 
 	inline std::string GetShapeType() const override {
 		return Utils::GetClassName<std::remove_pointer_t<decltype(*this)>>();
 	}
-	inline glm::dvec3 GetNormal(const glm::dvec3& dir) const override { return glm::normalize(dir); }
+	inline PhysicsVec3 GetNormal(const PhysicsVec3& dir) const override { return glm::normalize(dir); }
+	inline AABB GetBounds() const override
+	{
+		PhysicsVec3 radius = glm::abs(GetRadius());
+		PhysicsReal extent = std::max(radius.x, std::max(radius.y, radius.z));
+		return { m_position - extent, m_position + extent };
+	}
 private:
 	void defineMember() override
 	{
-		m_setters["radius"] = [this](std::any val) { this->SetRadius(std::any_cast<double>(val)); };
+		m_setters["radius"] = [this](std::any val) { this->SetRadius(static_cast<PhysicsReal>(std::any_cast<double>(val))); };
 
-		m_getters["radius"] = [this]() -> std::any { return std::any(this->GetRadius());};
+		m_getters["radius"] = [this]() -> std::any { return std::any(glm::dvec3(this->GetRadius()));};
 		m_getters["shapeType"] = [this]() -> std::any { return std::any(this->GetShapeType()); };
 	}
 };
@@ -0,0 +1,12 @@
+#pragma once
+
+// Where two overlapping shapes touch, what collision response works from
+struct ContactManifold
+{
+	static constexpr uint32_t MAX_POINTS = 4;
+
+	PhysicsVec3 normal{ 0.0 };						// Unit normal pointing from the first shape to the second
+	PhysicsReal depth = 0.0;								// Distance the shapes overlap along the normal
+	std::array<PhysicsVec3, MAX_POINTS> points{};	// Points in world space, midway between the two surfaces
+	uint32_t pointCount = 0;
+};
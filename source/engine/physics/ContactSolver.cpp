@@ -0,0 +1,149 @@
+#include "../pch.h"
+#include "ContactSolver.h"
+#include "CollisionComponent.h"
+#include "PhysicsComponent.h"
+#include "PhysicsManager.h"
+
+void ContactSolver::Solve(const std::vector<CollisionManager::Contact>& contacts, PhysicsBodyStorage& bodies, PhysicsReal dt)
+{
+	m_stats = {};
+	m_constraints.clear();
+	m_frame++;
+
+	for (const CollisionManager::Contact& contact : contacts)
+	{
+		PhysicsComponent* physics1 = contact.component1->GetComponent<PhysicsComponent>();
+		PhysicsComponent* physics2 = contact.component2->GetComponent<PhysicsComponent>();
+		const PhysicsReal inverseMass1 = physics1 ? physics1->GetInverseMass() : 0.0;
+		const PhysicsReal inverseMass2 = physics2 ? physics2->GetInverseMass() : 0.0;
+		if (inverseMass1 + inverseMass2 <= 0.0)
+			continue;
+		// Islands wake whole, so a pair with no awake body is at rest against something static. Its
+		// impulses are kept for when it wakes
+		if (!(physics1 && physics1->IsAwake()) && !(physics2 && physics2->IsAwake()))
+		{
+			if (auto cached = m_impulses.find(CollisionManager::MakePairKey(contact.component1, contact.component2)); cached != m_impulses.end())
+				cached->second.frame = m_frame;
+			continue;
+		}
+
+		Constraint constraint;
+		constraint.velocity1 = physics1 ? &bodies.velocity[bodies.Index(physics1->GetBody())] : &m_static;
+		constraint.velocity2 = physics2 ? &bodies.velocity[bodies.Index(physics2->GetBody())] : &m_static;
+		constraint.inverseMass1 = inverseMass1;
+		constraint.inverseMass2 = inverseMass2;
+		constraint.mass = 1.0 / (inverseMass1 + inverseMass2);
+		constraint.normal = contact.manifold.normal;
+
+		// A collider without a body takes on the material of the body it touches
+		const PhysicsReal friction1 = physics1 ? physics1->GetFriction() : physics2->GetFriction();
+		const PhysicsReal friction2 = physics2 ? physics2->GetFriction() : physics1->GetFriction();
+		constraint.friction = std::sqrt(friction1 * friction2);
+		const PhysicsReal bounciness = std::max(physics1 ? physics1->GetBounciness() : 0.0, physics2 ? physics2->GetBounciness() : 0.0);
+
+		// Bounce off the speed the bodies met at, and push out what the last step left overlapping
+		const PhysicsReal approach = glm::dot(*constraint.velocity2 - *constraint.velocity1, constraint.normal);
+		const PhysicsReal restitution = approach < -RESTITUTION_THRESHOLD ? -bounciness * approach : 0.0;
+		const PhysicsReal correction = BAUMGARTE / dt * std::max(contact.manifold.depth - SLOP, PhysicsReal(0));
+		constraint.bias = std::max(restitution, correction);
+
+		const CollisionManager::PairKey key = CollisionManager::MakePairKey(contact.component1, contact.component2);
+		constraint.sign = key.first == contact.component1 ? 1.0 : -1.0;
+
+		// Last step's impulses, the friction one turned into the plane of this step's normal
+		auto [cached, inserted] = m_impulses.try_emplace(key);
+		constraint.cached = &cached->second;
+		constraint.normalImpulse = 0.0;
+		constraint.tangentImpulse = PhysicsVec3(0.0);
+		if (!inserted)
+		{
+			constraint.normalImpulse = cached->second.normal;
+			const PhysicsVec3 tangent = cached->second.tangent * constraint.sign;
+			constraint.tangentImpulse = tangent - glm::dot(tangent, constraint.normal) * constraint.normal;
+			m_stats.warmStarted++;
+		}
+
+		const PhysicsVec3 impulse = constraint.normal * constraint.normalImpulse + constraint.tangentImpulse;
+		*constraint.velocity1 -= impulse * constraint.inverseMass1;
+		*constraint.velocity2 += impulse * constraint.inverseMass2;
+		m_constraints.push_back(constraint);
+	}
+	m_stats.constraints = static_cast<uint32_t>(m_constraints.size());
+
+	for (uint32_t iteration = 0; iteration < m_iterations && !m_constraints.empty(); ++iteration)
+	{
+		PhysicsReal residual = 0.0;
+		for (Constraint& constraint : m_constraints)
+		{
+			// Friction first, limited by the normal impulse of the last iteration, so the normal
+			// constraint has the final say on whether the bodies approach
+			PhysicsVec3 relative = *constraint.velocity2 - *constraint.velocity1;
+			const PhysicsVec3 slide = relative - glm::dot(relative, constraint.normal) * constraint.normal;
+			PhysicsVec3 tangentImpulse = constraint.tangentImpulse - slide * constraint.mass;
+			const PhysicsReal maxFriction = constraint.friction * constraint.normalImpulse;
+			const PhysicsReal length = glm::length(tangentImpulse);
+			if (length > maxFriction)
+				tangentImpulse *= length > 0.0 ? maxFriction / length : 0.0;
+			PhysicsVec3 impulse = tangentImpulse - constraint.tangentImpulse;
+			constraint.tangentImpulse = tangentImpulse;
+			residual = std::max(residual, glm::length(impulse));
+
+			// The bodies may pull apart but not push into each other
+			relative = *constraint.velocity2 - *constraint.velocity1;
+			const PhysicsReal speed = glm::dot(relative, constraint.normal);
+			const PhysicsReal normalImpulse = std::max(constraint.normalImpulse + (constraint.bias - speed) * constraint.mass, PhysicsReal(0));
+			const PhysicsReal change = normalImpulse - constraint.normalImpulse;
+			constraint.normalImpulse = normalImpulse;
+			residual = std::max(residual, std::abs(change));
+
+			impulse += constraint.normal * change;
+			*constraint.velocity1 -= impulse * constraint.inverseMass1;
+			*constraint.velocity2 += impulse * constraint.inverseMass2;
+		}
+		m_stats.iterations = iteration + 1;
+		m_stats.residual = residual;
+		if (residual <= m_tolerance)
+			break;
+	}
+
+	for (const Constraint& constraint : m_constraints)
+		*constraint.cached = { constraint.normalImpulse, constraint.tangentImpulse * constraint.sign, m_frame };
+	std::erase_if(m_impulses, [this](const auto& pair) { return pair.second.frame != m_frame; });
+}
+
+void ContactSolver::TestImmovableBody()
+{
+	// Objects outside any scene, gone with the test. Only the components the solver reads are added
+	GameObject ground;
+	ground.AddComponent<CollisionComponent>();
+	GameObject immovable;
+	immovable.AddComponent<CollisionComponent>();
+	PhysicsComponent* immovableBody = immovable.AddComponent<PhysicsComponent>(0.0);
+	GameObject falling;
+	falling.AddComponent<CollisionComponent>();
+	PhysicsComponent* fallingBody = falling.AddComponent<PhysicsComponent>(1.0);
+
+	const glm::dvec3 restingVelocity(0.0, -0.1, 0.0);
+	immovableBody->SetVelocity(restingVelocity);
+	fallingBody->SetVelocity(0.0, -2.0, 0.0);
+
+	// Both contacts overlap and approach, normals pointing up from the lower collider
+	ContactManifold manifold;
+	manifold.normal = PhysicsVec3(0.0, 1.0, 0.0);
+	manifold.depth = 0.05;
+	const std::vector<CollisionManager::Contact> contacts = {
+		{ ground.GetComponent<CollisionComponent>(), immovable.GetComponent<CollisionComponent>(), manifold },
+		{ immovable.GetComponent<CollisionComponent>(), falling.GetComponent<CollisionComponent>(), manifold } };
+
+	ContactSolver solver;
+	solver.Solve(contacts, SERVICE_LOCATOR.GetPhysicsManager()->GetBodies(), 1.0 / 60.0);
+
+	const glm::dvec3 immovableVelocity = immovableBody->GetVelocity();
+	const glm::dvec3 fallingVelocity = fallingBody->GetVelocity();
+	const bool finite = !glm::any(glm::isnan(immovableVelocity)) && !glm::any(glm::isinf(immovableVelocity)) &&
+		!glm::any(glm::isnan(fallingVelocity)) && !glm::any(glm::isinf(fallingVelocity));
+	const bool kept = immovableVelocity == glm::dvec3(PhysicsVec3(restingVelocity));
+	const bool stopped = fallingVelocity.y >= immovableVelocity.y;
+	printf("immovable body: %s (finite %d, kept velocity %d, landing body stopped %d, constraints %u)\n",
+		finite && kept && stopped ? "passed" : "FAILED", finite, kept, stopped, solver.GetStats().constraints);
+}
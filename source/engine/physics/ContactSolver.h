@@ -0,0 +1,92 @@
+#pragma once
+
+class PhysicsBodyStorage;
+
+// Sequential impulse solver for the contacts found by the CollisionManager. Every contact is one
+// constraint that keeps the colliders from approaching along the manifold normal, bouncing them apart
+// by their bounciness, and a friction constraint in the plane of the contact. Bodies carry no inertia
+// and are rotated by Euler angles, so impulses only change linear velocity and act through the centre
+// of the body. Colliders without a PhysicsComponent do not move. The impulses of each pair are kept
+// and applied before the first iteration of the next Solve, so resting contacts start from the answer
+// of the last step and settle in a few iterations. Contacts of sleeping bodies are skipped
+class ContactSolver
+{
+public:
+	// Work done by the last Solve
+	struct Stats
+	{
+		uint32_t constraints = 0;		// contacts with at least one body that moves
+		uint32_t warmStarted = 0;		// of those, contacts that started from the impulses of the last step
+		uint32_t iterations = 0;		// iterations run, fewer than the limit once the impulses settle
+		PhysicsReal residual = 0.0;			// largest change of an impulse in the last iteration
+	};
+
+	//@brief Sets the most iterations a Solve runs
+	//@param iterations : Iterations, at least 1
+	inline void SetIterations(uint32_t iterations) { m_iterations = std::max(iterations, 1u); }
+	//@brief Returns the most iterations a Solve runs
+	inline uint32_t GetIterations() const { return m_iterations; }
+	//@brief Sets the impulse change under which the iterations stop early
+	//@param tolerance : Largest change of any impulse in an iteration, 0 to always run every iteration
+	inline void SetTolerance(PhysicsReal tolerance) { m_tolerance = tolerance; }
+	//@brief Returns the impulse change under which the iterations stop early
+	inline PhysicsReal GetTolerance() const { return m_tolerance; }
+
+	//@brief Changes the velocities of the bodies in contact so they stop approaching each other, bounce
+	// and slide as their materials say, and push apart where they overlap
+	//@param contacts : Contacts found by the last CollisionManager update
+	//@param bodies : Storage holding the velocities of the bodies
+	//@param dt : Step length the velocities will be integrated over
+	void Solve(const std::vector<CollisionManager::Contact>& contacts, PhysicsBodyStorage& bodies, PhysicsReal dt);
+
+	//@brief Returns the work done by the last Solve
+	inline const Stats& GetStats() const { return m_stats; }
+
+	//@brief Solves a body of zero mass resting on a collider without a body, then a unit mass body landing
+	// on it, and prints whether the zero mass body kept its velocity, the other stopped approaching and
+	// every velocity stayed finite
+	static void TestImmovableBody();
+
+private:
+	// Fraction of the overlap removed each step
+	static constexpr PhysicsReal BAUMGARTE = 0.2;
+	// Overlap left alone, so resting contacts stay touching instead of separating every other step
+	static constexpr PhysicsReal SLOP = 0.005;
+	// Approach speed under which contacts do not bounce, keeps resting bodies from jittering
+	static constexpr PhysicsReal RESTITUTION_THRESHOLD = 1.0;
+
+	// Accumulated impulses of a pair, the tangent one as applied to the second collider of the key
+	struct Impulse
+	{
+		PhysicsReal normal = 0.0;
+		PhysicsVec3 tangent{ 0.0 };
+		uint32_t frame = 0;				// last Solve the pair was in contact
+	};
+
+	struct Constraint
+	{
+		PhysicsVec3* velocity1;
+		PhysicsVec3* velocity2;
+		PhysicsReal inverseMass1;
+		PhysicsReal inverseMass2;
+		PhysicsReal mass;					// 1 / (inverseMass1 + inverseMass2)
+		PhysicsVec3 normal;				// from the first collider to the second
+		PhysicsReal bias;					// separating speed the contact asks for, to bounce and to push out overlap
+		PhysicsReal friction;
+		PhysicsReal normalImpulse;			// accumulated over the iterations
+		PhysicsVec3 tangentImpulse;		// applied to the second body, the first gets the opposite
+		PhysicsReal sign;					// -1 if the colliders are the other way round in the key
+		Impulse* cached;				// entry of the pair in m_impulses
+	};
+
+	uint32_t m_iterations = 10;
+	PhysicsReal m_tolerance = 1e-4;
+	PhysicsVec3 m_static{ 0.0 };			// velocity of every collider without a body, never changed
+	std::vector<Constraint> m_constraints;
+
+	// Impulses of the pairs in contact. A pair allocates its entry when it starts touching, entries
+	// not stamped by a Solve are dropped at its end
+	std::unordered_map<CollisionManager::PairKey, Impulse, CollisionManager::PairKeyHash> m_impulses;
+	uint32_t m_frame = 0;
+	Stats m_stats;
+};
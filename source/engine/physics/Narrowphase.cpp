@@ -0,0 +1,300 @@
+#include "../pch.h"
+#include "Narrowphase.h"
+#include "CollisionChecks.h"
+#include "NarrowphaseKernels.h"
+
+namespace {
+
+	using NarrowphaseKernels::Colliders;
+
+	template<typename Real>
+	Colliders<Real> ToColliders(const std::vector<Real> (&fields)[6])
+	{
+		return { fields[0].data(), fields[1].data(), fields[2].data(), fields[3].data(), fields[4].data(), fields[5].data() };
+	}
+
+	//@brief Returns the kernels of a precision for this processor, the AVX2 ones if it has it and SSE2 ones otherwise
+	template<typename Real>
+	const NarrowphaseKernels::Set<Real>& Kernels()
+	{
+		static const NarrowphaseKernels::Set<Real> kernels = Utils::HasAvx2() ? NarrowphaseKernels::Avx2<Real>() : CompiledKernels<Real>();
+		return kernels;
+	}
+}
+
+// ****** Narrowphase ****** //
+#pragma region Narrowphase
+const uint32_t Narrowphase::LANES = Kernels<PhysicsReal>().lanes;
+
+void Narrowphase::Resize(uint32_t count)
+{
+	// The extra entry is the empty collider the batches are padded with
+	m_types.resize(count + 1);
+	m_shapes.resize(count + 1);
+	m_types[count] = ShapeType::COUNT;
+	m_shapes[count] = nullptr;
+	for (std::vector<PhysicsReal>* values : { &m_x, &m_y, &m_z, &m_sizeX, &m_sizeY, &m_sizeZ })
+	{
+		values->resize(count + 1);
+		(*values)[count] = 0.0;
+	}
+}
+
+void Narrowphase::SetShape(uint32_t collider, const CollisionShape* shape)
+{
+	assert(collider + 1 < m_shapes.size() && shape != nullptr);
+	PhysicsVec3 position = shape->GetPosition();
+	PhysicsVec3 size(0.0);
+	if (shape->GetType() == ShapeType::SPHERE)
+		size.x = static_cast<const CollisionShape_Sphere*>(shape)->GetRadius().x;
+	else if (shape->GetType() == ShapeType::CUBOID)
+		size = static_cast<const CollisionShape_Cuboid*>(shape)->GetHalfWidth();
+
+	m_types[collider] = shape->GetType();
+	m_shapes[collider] = shape;
+	m_x[collider] = position.x;
+	m_y[collider] = position.y;
+	m_z[collider] = position.z;
+	m_sizeX[collider] = size.x;
+	m_sizeY[collider] = size.y;
+	m_sizeZ[collider] = size.z;
+}
+
+void Narrowphase::Run(std::vector<uint8_t>& overlapping, std::vector<ContactManifold>* manifolds)
+{
+	overlapping.assign(m_pairs.size(), 0);
+	if (manifolds)
+		manifolds->resize(m_pairs.size());
+	group();
+	m_stats = {};
+	m_stats.sphereSphere = m_sphereSphere.count;
+	m_stats.sphereCuboid = m_sphereCuboid.count;
+	m_stats.cuboidCuboid = m_cuboidCuboid.count;
+	m_stats.dispatched = m_dispatched.count;
+
+	const Colliders<PhysicsReal> colliders{ m_x.data(), m_y.data(), m_z.data(), m_sizeX.data(), m_sizeY.data(), m_sizeZ.data() };
+	const NarrowphaseKernels::Set<PhysicsReal>& kernels = Kernels<PhysicsReal>();
+	m_stats.overlaps += kernels.sphereSphere(colliders, m_sphereSphere.first.data(), m_sphereSphere.second.data(), m_sphereSphere.pair.data(), m_stats.sphereSphere, overlapping.data());
+	m_stats.overlaps += kernels.sphereCuboid(colliders, m_sphereCuboid.first.data(), m_sphereCuboid.second.data(), m_sphereCuboid.pair.data(), m_stats.sphereCuboid, overlapping.data());
+
+	// The kernels only say which pairs overlap, the few that do get their manifold one by one
+	if (manifolds)
+	{
+		for (const Batch* batch : { &m_sphereSphere, &m_sphereCuboid })
+		{
+			for (uint32_t i = 0; i < batch->count; ++i)
+			{
+				const uint32_t pair = batch->pair[i];
+				if (overlapping[pair] && !CollisionChecks::Collide(m_shapes[m_pairs[pair].first], m_shapes[m_pairs[pair].second], (*manifolds)[pair]))
+				{
+					overlapping[pair] = 0;	// only where the comparison of squares and of distances round differently
+					--m_stats.overlaps;
+				}
+			}
+		}
+	}
+
+	// Hints written by the last Run are read, the ones of this Run are stamped with it
+	++m_run;
+	for (uint32_t i = 0; i < m_cuboidCuboid.count; ++i)
+	{
+		const uint32_t collider1 = m_cuboidCuboid.first[i];
+		const uint32_t collider2 = m_cuboidCuboid.second[i];
+		const auto [id1, id2] = m_pairIds[m_cuboidCuboid.pair[i]];
+		AxisHint& hint = axisHint(id1, id2);
+		uint8_t separatingAxis = hint.partner == id2 && hint.run + 1 == m_run ? hint.axis : 0;
+
+		auto cuboid1 = static_cast<const CollisionShape_Cuboid*>(m_shapes[collider1]);
+		auto cuboid2 = static_cast<const CollisionShape_Cuboid*>(m_shapes[collider2]);
+		const bool overlap = manifolds
+			? CollisionChecks::Collide(cuboid1, cuboid2, (*manifolds)[m_cuboidCuboid.pair[i]], separatingAxis)
+			: CollisionChecks::CheckCollisionBetween(cuboid1, cuboid2, separatingAxis);
+		if (overlap)
+		{
+			overlapping[m_cuboidCuboid.pair[i]] = 1;
+			++m_stats.overlaps;
+		}
+		else
+		{
+			hint.partner = id2;
+			hint.run = m_run;
+			hint.axis = separatingAxis;
+		}
+	}
+
+	for (uint32_t i = 0; i < m_dispatched.count; ++i)
+	{
+		const CollisionShape* shape1 = m_shapes[m_dispatched.first[i]];
+		const CollisionShape* shape2 = m_shapes[m_dispatched.second[i]];
+		const uint32_t pair = m_dispatched.pair[i];
+		const bool overlap = manifolds ? CollisionChecks::Collide(shape1, shape2, (*manifolds)[pair]) : CollisionChecks::CheckCollisionBetween(shape1, shape2);
+		overlapping[pair] = overlap ? 1 : 0;
+		m_stats.overlaps += overlapping[pair];
+	}
+}
+
+void Narrowphase::group()
+{
+	// Every batch is sized for all the pairs plus padding, so the pairs are written without checks
+	const uint32_t count = static_cast<uint32_t>(m_pairs.size());
+	for (Batch* batch : { &m_sphereSphere, &m_sphereCuboid, &m_cuboidCuboid, &m_dispatched })
+	{
+		batch->count = 0;
+		if (batch->pair.size() < count + LANES)
+		{
+			batch->first.resize(count + LANES);
+			batch->second.resize(count + LANES);
+			batch->pair.resize(count + LANES);
+		}
+	}
+
+	for (uint32_t pair = 0; pair < count; ++pair)
+	{
+		auto [collider1, collider2] = m_pairs[pair];
+		const ShapeType type1 = m_types[collider1];
+		const ShapeType type2 = m_types[collider2];
+		assert(type1 != ShapeType::COUNT && type2 != ShapeType::COUNT);
+
+		Batch* batch = &m_dispatched;
+		if (type1 == ShapeType::SPHERE && type2 == ShapeType::SPHERE)
+		{
+			batch = &m_sphereSphere;
+		}
+		else if (type1 == ShapeType::SPHERE && type2 == ShapeType::CUBOID)
+		{
+			batch = &m_sphereCuboid;
+		}
+		else if (type1 == ShapeType::CUBOID && type2 == ShapeType::SPHERE)
+		{
+			batch = &m_sphereCuboid;
+			std::swap(collider1, collider2);
+		}
+		else if (type1 == ShapeType::CUBOID && type2 == ShapeType::CUBOID)
+		{
+			batch = &m_cuboidCuboid;
+		}
+		const uint32_t index = batch->count++;
+		batch->first[index] = collider1;
+		batch->second[index] = collider2;
+		batch->pair[index] = pair;
+	}
+
+	const uint32_t empty = static_cast<uint32_t>(m_shapes.size() - 1);
+	for (Batch* batch : { &m_sphereSphere, &m_sphereCuboid })
+	{
+		for (uint32_t index = batch->count; index % LANES != 0; ++index)
+		{
+			batch->first[index] = empty;
+			batch->second[index] = empty;
+		}
+	}
+}
+
+Narrowphase::AxisHint& Narrowphase::axisHint(uint32_t id1, uint32_t id2)
+{
+	if (m_axisHints.size() < (static_cast<size_t>(id1) + 1) * HINTS_PER_ID)
+		m_axisHints.resize((static_cast<size_t>(id1) + 1) * HINTS_PER_ID);
+
+	AxisHint* hints = &m_axisHints[static_cast<size_t>(id1) * HINTS_PER_ID];
+	AxisHint* oldest = hints;
+	for (uint32_t slot = 0; slot < HINTS_PER_ID; ++slot)
+	{
+		if (hints[slot].partner == id2)
+			return hints[slot];
+		if (hints[slot].run < oldest->run)
+			oldest = &hints[slot];
+	}
+	return *oldest;
+}
+
+void Narrowphase::BenchmarkPrecision(std::span<const uint32_t> counts)
+{
+	static constexpr uint32_t REPEATS = 20;
+	// Far enough out that floats only keep about a millimetre, where a floating origin would rebase
+	static constexpr double FAR_OFFSET = 10000.0;
+
+	printf("narrowphase precision: physics built with %s, %u double and %u float pairs per instruction\n", PHYSICS_PRECISION_NAME,
+		Kernels<double>().lanes, Kernels<float>().lanes);
+	printf("%-14s %10s %16s %16s %8s %12s %16s\n", "pairs", "count", "double pairs/us", "float pairs/us", "speedup", "mismatches", "far mismatches");
+	for (uint32_t count : counts)
+	{
+		// The scene of BenchmarkNarrowphase, generated in doubles and rounded to floats. Colliders 0 to
+		// count - 1 are the spheres, count to 2 * count - 1 the cuboids, 2 * count the empty one
+		std::mt19937 random(count);
+		std::uniform_real_distribution<double> place(-1.0, 1.0);
+		std::uniform_real_distribution<double> size(0.5, 1.5);
+		const uint32_t empty = count * 2;
+		std::vector<double> doubles[6];
+		for (std::vector<double>& values : doubles)
+			values.assign(empty + 1, 0.0);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			for (uint32_t axis = 0; axis < 3; ++axis)
+				doubles[axis][i] = place(random);
+			doubles[3][i] = size(random) * 0.5;
+			for (uint32_t axis = 0; axis < 3; ++axis)
+				doubles[axis][count + i] = place(random);
+			for (uint32_t axis = 3; axis < 6; ++axis)
+				doubles[axis][count + i] = size(random) * 0.5;
+		}
+
+		// The same scene away from the origin, where doubles keep the answer and floats start to miss
+		std::vector<double> farDoubles[6];
+		std::vector<float> floats[6], farFloats[6];
+		for (uint32_t field = 0; field < 6; ++field)
+		{
+			farDoubles[field] = doubles[field];
+			if (field < 3)
+			{
+				for (uint32_t i = 0; i < empty; ++i)
+					farDoubles[field][i] += FAR_OFFSET;
+			}
+			floats[field].assign(doubles[field].begin(), doubles[field].end());
+			farFloats[field].assign(farDoubles[field].begin(), farDoubles[field].end());
+		}
+
+		auto measure = [&](const char* name, uint32_t secondOffset, auto select)
+		{
+			// Padded for the widest precision, the narrower one tests a few more empty pairs
+			const uint32_t padded = (count + NarrowphaseKernels::MAX_LANES - 1) / NarrowphaseKernels::MAX_LANES * NarrowphaseKernels::MAX_LANES;
+			std::vector<uint32_t> first(padded, empty), second(padded, empty), pairs(padded, 0);
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				first[i] = i;
+				second[i] = secondOffset + (i * 7919u + 1u) % count;
+				pairs[i] = i;
+			}
+
+			std::vector<uint8_t> doubleOverlaps(count), floatOverlaps(count);
+			auto run = [&]<typename Real>(const Colliders<Real>& colliders, std::vector<uint8_t>& overlapping)
+			{
+				const auto kernel = select(Kernels<Real>());
+				auto begin = std::chrono::high_resolution_clock::now();
+				for (uint32_t repeat = 0; repeat < REPEATS; ++repeat)
+					kernel(colliders, first.data(), second.data(), pairs.data(), count, overlapping.data());
+				return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - begin).count();
+			};
+			auto mismatches = [&]()
+			{
+				uint32_t mismatched = 0;
+				for (uint32_t i = 0; i < count; ++i)
+					mismatched += doubleOverlaps[i] != floatOverlaps[i] ? 1 : 0;
+				return mismatched;
+			};
+
+			const double doubleUs = run(ToColliders(doubles), doubleOverlaps);
+			const double floatUs = run(ToColliders(floats), floatOverlaps);
+			const uint32_t nearMismatches = mismatches();
+			run(ToColliders(farDoubles), doubleOverlaps);
+			run(ToColliders(farFloats), floatOverlaps);
+			const uint32_t farMismatches = mismatches();
+
+			const double tested = static_cast<double>(count) * REPEATS;
+			printf("%-14s %10u %16.1f %16.1f %8.2f %12u %16u\n", name, count, tested / std::max(doubleUs, 1e-3), tested / std::max(floatUs, 1e-3),
+				doubleUs / std::max(floatUs, 1e-3), nearMismatches, farMismatches);
+		};
+		measure("sphere-sphere", 0, [](const auto& kernels) { return kernels.sphereSphere; });
+		measure("sphere-cuboid", count, [](const auto& kernels) { return kernels.sphereCuboid; });
+	}
+}
+#pragma endregion
@@ -0,0 +1,115 @@
+#pragma once
+
+// Tests candidate pairs in batches. The shape of every collider is gathered once into one array
+// per field, pairs are then grouped by the types of their shapes so sphere-sphere and sphere-cuboid
+// pairs are tested LANES at a time with vector instructions. Cuboid pairs go through the SAT one at a
+// time, starting from the axis that separated them in the last Run. Overlapping pairs get a manifold
+class Narrowphase
+{
+public:
+	// Pairs tested by one vector instruction: 4 doubles or 8 floats on processors with AVX2, 2 doubles or
+	// 4 floats on the others, 1 without SSE2. See PhysicsPrecision.h and NarrowphaseKernels.h
+	static const uint32_t LANES;
+
+	// Pairs tested by the last Run
+	struct Stats
+	{
+		uint32_t sphereSphere = 0;
+		uint32_t sphereCuboid = 0;
+		uint32_t cuboidCuboid = 0;
+		uint32_t dispatched = 0;	// pairs of other types, tested through the pair table
+		uint32_t overlaps = 0;
+	};
+
+	//@brief Sets how many colliders the pairs can refer to
+	//@param count : Colliders, indexed from 0
+	void Resize(uint32_t count);
+
+	//@brief Reads the position and size of a collider's shape. Colliders can be set from several threads at once
+	//@param collider : Index of the collider
+	//@param shape : Its shape, which must outlive the next Run
+	void SetShape(uint32_t collider, const CollisionShape* shape);
+
+	//@brief Drops the pairs added since the last Run
+	inline void Clear() { m_pairs.clear(); m_pairIds.clear(); }
+
+	//@brief Queues a pair of colliders whose shapes are set
+	//@param collider1 : Index of the first collider
+	//@param collider2 : Index of the second collider
+	//@param id1 : Id the first collider keeps while its index shifts, such as its broadphase proxy. Cuboid
+	// pairs remember their separating axis under the ids
+	//@param id2 : Id the second collider keeps
+	inline void Add(uint32_t collider1, uint32_t collider2, uint32_t id1, uint32_t id2)
+	{
+		m_pairs.emplace_back(collider1, collider2);
+		m_pairIds.emplace_back(id1, id2);
+	}
+
+	//@brief Queues a pair of colliders whose indices are their ids
+	inline void Add(uint32_t collider1, uint32_t collider2) { Add(collider1, collider2, collider1, collider2); }
+
+	//@brief Tests every pair added since the last Clear
+	//@param overlapping : Resized to the pairs added, set to 1 for each pair that overlaps in the order they were added
+	//@param manifolds : If given, resized to the pairs added and set to the contact of each pair that overlaps,
+	// normal from the first collider of the pair to the second
+	void Run(std::vector<uint8_t>& overlapping, std::vector<ContactManifold>* manifolds = nullptr);
+
+	//@brief Returns the pairs tested by the last Run
+	inline const Stats& GetStats() const { return m_stats; }
+
+	//@brief Runs the sphere-sphere and sphere-cuboid kernels in doubles and in floats on the same shapes, near
+	// the origin and far from it, and prints the pairs each tests per microsecond and how often floats disagree.
+	// Only times those two kernels on generated shapes, not the SAT, the solver or a whole physics step
+	//@param counts : Numbers of pairs to test
+	static void BenchmarkPrecision(std::span<const uint32_t> counts);
+
+private:
+	// Pairs of one type, the colliders they refer to and the order they were added in. The arrays
+	// only grow, count is how many entries the last Run used
+	struct Batch
+	{
+		std::vector<uint32_t> first;
+		std::vector<uint32_t> second;
+		std::vector<uint32_t> pair;
+		uint32_t count = 0;
+	};
+
+	// Last separating axis of a cuboid pair that was apart, under the id of its first collider. Only a hint
+	// of the axis to test first, so an id reused within a Run costs nothing but time
+	struct AxisHint
+	{
+		uint32_t partner = UINT32_MAX;	// id of the second collider
+		uint32_t run = 0;				// Run that wrote it, only the hints of the last one are read
+		uint8_t axis = 0;
+	};
+	static constexpr uint32_t HINTS_PER_ID = 4;
+
+	//@brief Sorts the pairs into a batch per type, padding the SIMD batches to a whole number of
+	// lanes with pairs of the empty collider, which never overlap
+	void group();
+
+	//@brief Returns the hint slot of a pair of ids, its own if the pair has one and else the oldest
+	//@param id1 : Id of the first collider
+	//@param id2 : Id of the second collider
+	//@return AxisHint& : The slot, whose partner is id2 only if it is the pair's
+	AxisHint& axisHint(uint32_t id1, uint32_t id2);
+
+	// One entry per collider plus an empty one at the end for padding. Spheres keep their radius in
+	// sizeX, cuboids their half width
+	std::vector<ShapeType> m_types;
+	std::vector<const CollisionShape*> m_shapes;
+	std::vector<PhysicsReal> m_x, m_y, m_z;
+	std::vector<PhysicsReal> m_sizeX, m_sizeY, m_sizeZ;
+
+	Batch m_sphereSphere;
+	Batch m_sphereCuboid;		// sphere first
+	Batch m_cuboidCuboid;
+	Batch m_dispatched;
+	std::vector<std::pair<uint32_t, uint32_t>> m_pairs;
+	std::vector<std::pair<uint32_t, uint32_t>> m_pairIds;
+
+	// HINTS_PER_ID slots per id. Only grows, a slot is taken over once its pair stops being written
+	std::vector<AxisHint> m_axisHints;
+	uint32_t m_run = 0;
+	Stats m_stats;
+};
@@ -0,0 +1,12 @@
+// Built with AVX2 and without the precompiled header, see NarrowphaseKernels.h. Without the flag, as in
+// Win32 builds, these are the same kernels as Narrowphase.cpp's
+#include "NarrowphaseKernels.h"
+
+template<typename Real>
+NarrowphaseKernels::Set<Real> NarrowphaseKernels::Avx2()
+{
+	return CompiledKernels<Real>();
+}
+
+template NarrowphaseKernels::Set<float> NarrowphaseKernels::Avx2<float>();
+template NarrowphaseKernels::Set<double> NarrowphaseKernels::Avx2<double>();
@@ -0,0 +1,209 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// The sphere-sphere and sphere-cuboid kernels of Narrowphase. Included by Narrowphase.cpp, built for
+// SSE2, and by NarrowphaseAvx.cpp, built for AVX2, so the kernels are compiled once per instruction set.
+// Only plain pointers cross into them, so the AVX2 file instantiates no library code the linker could share
+namespace NarrowphaseKernels {
+
+	// Lanes of the widest kernel, what batches are padded to so every kernel can run on them
+	constexpr uint32_t MAX_LANES = 8;
+
+	// One array per field of every collider, in one precision
+	template<typename Real>
+	struct Colliders
+	{
+		const Real* x;
+		const Real* y;
+		const Real* z;
+		const Real* sizeX;
+		const Real* sizeY;
+		const Real* sizeZ;
+	};
+
+	// Tests count pairs, the colliders of pair i being first[i] and second[i], and writes the overlap of each
+	// to overlapping[pairs[i]]. Returns the overlaps
+	template<typename Real>
+	using Kernel = uint32_t (*)(const Colliders<Real>& colliders, const uint32_t* first, const uint32_t* second, const uint32_t* pairs,
+		uint32_t count, uint8_t* overlapping);
+
+	// The kernels of one precision for one instruction set, lanes being the pairs they test at a time
+	template<typename Real>
+	struct Set
+	{
+		uint32_t lanes;
+		Kernel<Real> sphereSphere;
+		Kernel<Real> sphereCuboid;
+	};
+
+	//@brief Returns the kernels built for AVX2, only to be run when Utils::HasAvx2
+	template<typename Real>
+	Set<Real> Avx2();
+}
+
+// Internal to each file that includes it, as each builds it for its own instruction set
+namespace {
+
+	// The handful of operations the kernels need, on as many values of one precision as one register
+	// holds. Gather reads one value per lane from the collider that lane's pair refers to, element by
+	// element, as the colliders of a batch are scattered through the arrays
+	template<typename Real>
+	struct Simd
+	{
+		using Lanes = Real;
+		static constexpr uint32_t LANE_COUNT = 1;
+		static Lanes Gather(const Real* values, const uint32_t* colliders) { return values[*colliders]; }
+		static Lanes Zero() { return Real(0); }
+		static Lanes Add(Lanes a, Lanes b) { return a + b; }
+		static Lanes Sub(Lanes a, Lanes b) { return a - b; }
+		static Lanes Mul(Lanes a, Lanes b) { return a * b; }
+		static Lanes Min(Lanes a, Lanes b) { return std::min(a, b); }
+		static Lanes Max(Lanes a, Lanes b) { return std::max(a, b); }
+		static Lanes Negate(Lanes a) { return -a; }
+		static uint32_t LessMask(Lanes a, Lanes b) { return a < b ? 1u : 0u; }
+	};
+
+#if defined(__AVX__)
+	template<>
+	struct Simd<double>
+	{
+		using Lanes = __m256d;
+		static constexpr uint32_t LANE_COUNT = 4;
+		static Lanes Gather(const double* values, const uint32_t* colliders) { return _mm256_set_pd(values[colliders[3]], values[colliders[2]], values[colliders[1]], values[colliders[0]]); }
+		static Lanes Zero() { return _mm256_setzero_pd(); }
+		static Lanes Add(Lanes a, Lanes b) { return _mm256_add_pd(a, b); }
+		static Lanes Sub(Lanes a, Lanes b) { return _mm256_sub_pd(a, b); }
+		static Lanes Mul(Lanes a, Lanes b) { return _mm256_mul_pd(a, b); }
+		static Lanes Min(Lanes a, Lanes b) { return _mm256_min_pd(a, b); }
+		static Lanes Max(Lanes a, Lanes b) { return _mm256_max_pd(a, b); }
+		static Lanes Negate(Lanes a) { return _mm256_sub_pd(_mm256_setzero_pd(), a); }
+		static uint32_t LessMask(Lanes a, Lanes b) { return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ))); }
+	};
+
+	template<>
+	struct Simd<float>
+	{
+		using Lanes = __m256;
+		static constexpr uint32_t LANE_COUNT = 8;
+		static Lanes Gather(const float* values, const uint32_t* colliders)
+		{
+			return _mm256_set_ps(values[colliders[7]], values[colliders[6]], values[colliders[5]], values[colliders[4]],
+				values[colliders[3]], values[colliders[2]], values[colliders[1]], values[colliders[0]]);
+		}
+		static Lanes Zero() { return _mm256_setzero_ps(); }
+		static Lanes Add(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+		static Lanes Sub(Lanes a, Lanes b) { return _mm256_sub_ps(a, b); }
+		static Lanes Mul(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+		static Lanes Min(Lanes a, Lanes b) { return _mm256_min_ps(a, b); }
+		static Lanes Max(Lanes a, Lanes b) { return _mm256_max_ps(a, b); }
+		static Lanes Negate(Lanes a) { return _mm256_sub_ps(_mm256_setzero_ps(), a); }
+		static uint32_t LessMask(Lanes a, Lanes b) { return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ))); }
+	};
+#elif defined(__SSE2__) || defined(_M_X64)
+	template<>
+	struct Simd<double>
+	{
+		using Lanes = __m128d;
+		static constexpr uint32_t LANE_COUNT = 2;
+		static Lanes Gather(const double* values, const uint32_t* colliders) { return _mm_set_pd(values[colliders[1]], values[colliders[0]]); }
+		static Lanes Zero() { return _mm_setzero_pd(); }
+		static Lanes Add(Lanes a, Lanes b) { return _mm_add_pd(a, b); }
+		static Lanes Sub(Lanes a, Lanes b) { return _mm_sub_pd(a, b); }
+		static Lanes Mul(Lanes a, Lanes b) { return _mm_mul_pd(a, b); }
+		static Lanes Min(Lanes a, Lanes b) { return _mm_min_pd(a, b); }
+		static Lanes Max(Lanes a, Lanes b) { return _mm_max_pd(a, b); }
+		static Lanes Negate(Lanes a) { return _mm_sub_pd(_mm_setzero_pd(), a); }
+		static uint32_t LessMask(Lanes a, Lanes b) { return static_cast<uint32_t>(_mm_movemask_pd(_mm_cmplt_pd(a, b))); }
+	};
+
+	template<>
+	struct Simd<float>
+	{
+		using Lanes = __m128;
+		static constexpr uint32_t LANE_COUNT = 4;
+		static Lanes Gather(const float* values, const uint32_t* colliders) { return _mm_set_ps(values[colliders[3]], values[colliders[2]], values[colliders[1]], values[colliders[0]]); }
+		static Lanes Zero() { return _mm_setzero_ps(); }
+		static Lanes Add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+		static Lanes Sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+		static Lanes Mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+		static Lanes Min(Lanes a, Lanes b) { return _mm_min_ps(a, b); }
+		static Lanes Max(Lanes a, Lanes b) { return _mm_max_ps(a, b); }
+		static Lanes Negate(Lanes a) { return _mm_sub_ps(_mm_setzero_ps(), a); }
+		static uint32_t LessMask(Lanes a, Lanes b) { return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(a, b))); }
+	};
+#endif
+
+	// Writes the overlap bit of each lane to the pair it was gathered from, skipping the padding
+	template<typename Real>
+	uint32_t Scatter(uint32_t mask, const uint32_t* pairs, uint32_t remaining, uint8_t* overlapping)
+	{
+		uint32_t overlaps = 0;
+		for (uint32_t lane = 0; lane < Simd<Real>::LANE_COUNT && lane < remaining; ++lane)
+		{
+			uint8_t overlap = (mask >> lane) & 1u;
+			overlapping[pairs[lane]] = overlap;
+			overlaps += overlap;
+		}
+		return overlaps;
+	}
+
+	// Centres closer than the sum of the radii. A sum of 0 or less never overlaps, as in the scalar check
+	template<typename Real>
+	uint32_t SphereSphere(const NarrowphaseKernels::Colliders<Real>& colliders, const uint32_t* first, const uint32_t* second, const uint32_t* pairs,
+		uint32_t count, uint8_t* overlapping)
+	{
+		using S = Simd<Real>;
+		uint32_t overlaps = 0;
+		for (uint32_t i = 0; i < count; i += S::LANE_COUNT)
+		{
+			typename S::Lanes x = S::Sub(S::Gather(colliders.x, &second[i]), S::Gather(colliders.x, &first[i]));
+			typename S::Lanes y = S::Sub(S::Gather(colliders.y, &second[i]), S::Gather(colliders.y, &first[i]));
+			typename S::Lanes z = S::Sub(S::Gather(colliders.z, &second[i]), S::Gather(colliders.z, &first[i]));
+			typename S::Lanes radius = S::Add(S::Gather(colliders.sizeX, &first[i]), S::Gather(colliders.sizeX, &second[i]));
+			typename S::Lanes distance2 = S::Add(S::Add(S::Mul(x, x), S::Mul(y, y)), S::Mul(z, z));
+			uint32_t mask = S::LessMask(distance2, S::Mul(radius, radius)) & S::LessMask(S::Zero(), radius);
+			overlaps += Scatter<Real>(mask, &pairs[i], count - i, overlapping);
+		}
+		return overlaps;
+	}
+
+	// Point of the unrotated cuboid closest to the sphere nearer than the radius, as the scalar check.
+	// first holds the spheres, second the cuboids
+	template<typename Real>
+	uint32_t SphereCuboid(const NarrowphaseKernels::Colliders<Real>& colliders, const uint32_t* first, const uint32_t* second, const uint32_t* pairs,
+		uint32_t count, uint8_t* overlapping)
+	{
+		using S = Simd<Real>;
+		uint32_t overlaps = 0;
+		for (uint32_t i = 0; i < count; i += S::LANE_COUNT)
+		{
+			const uint32_t* sphere = &first[i];
+			const uint32_t* cuboid = &second[i];
+			typename S::Lanes x = S::Sub(S::Gather(colliders.x, sphere), S::Gather(colliders.x, cuboid));
+			typename S::Lanes y = S::Sub(S::Gather(colliders.y, sphere), S::Gather(colliders.y, cuboid));
+			typename S::Lanes z = S::Sub(S::Gather(colliders.z, sphere), S::Gather(colliders.z, cuboid));
+			typename S::Lanes halfX = S::Gather(colliders.sizeX, cuboid);
+			typename S::Lanes halfY = S::Gather(colliders.sizeY, cuboid);
+			typename S::Lanes halfZ = S::Gather(colliders.sizeZ, cuboid);
+			typename S::Lanes radius = S::Gather(colliders.sizeX, sphere);
+			typename S::Lanes dx = S::Sub(x, S::Min(S::Max(x, S::Negate(halfX)), halfX));
+			typename S::Lanes dy = S::Sub(y, S::Min(S::Max(y, S::Negate(halfY)), halfY));
+			typename S::Lanes dz = S::Sub(z, S::Min(S::Max(z, S::Negate(halfZ)), halfZ));
+			typename S::Lanes distance2 = S::Add(S::Add(S::Mul(dx, dx), S::Mul(dy, dy)), S::Mul(dz, dz));
+			uint32_t mask = S::LessMask(distance2, S::Mul(radius, radius)) & S::LessMask(S::Zero(), radius);
+			overlaps += Scatter<Real>(mask, &pairs[i], count - i, overlapping);
+		}
+		return overlaps;
+	}
+
+	// The kernels as built in the including file
+	template<typename Real>
+	NarrowphaseKernels::Set<Real> CompiledKernels()
+	{
+		return { Simd<Real>::LANE_COUNT, &SphereSphere<Real>, &SphereCuboid<Real> };
+	}
+}
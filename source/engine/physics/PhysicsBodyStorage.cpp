@@ -0,0 +1,166 @@
+#include "../pch.h"
+#include "PhysicsBodyStorage.h"
+
+// ****** Body Management ****** //
+#pragma region BodyManagement
+uint32_t PhysicsBodyStorage::Create(PhysicsComponent* component)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto [handle, index] = m_index.Insert();
+
+	velocity.Reserve(index);
+	rotationalVelocity.Reserve(index);
+	acceleration.Reserve(index);
+	rotationalAcceleration.Reserve(index);
+	awake.Reserve(index);
+	restingTime.Reserve(index);
+	transform.Reserve(index);
+	owner.Reserve(index);
+	previousPosition.Reserve(index);
+	previousOrientation.Reserve(index);
+	simulatedPosition.Reserve(index);
+	simulatedOrientation.Reserve(index);
+	interpolated.Reserve(index);
+
+	velocity[index] = PhysicsVec3(0);
+	rotationalVelocity[index] = PhysicsVec3(0);
+	acceleration[index] = PhysicsVec3(0);
+	rotationalAcceleration[index] = PhysicsVec3(0);
+	awake[index] = 1;
+	restingTime[index] = 0;
+	transform[index] = StorageIndex::INVALID;
+	owner[index] = component;
+	previousPosition[index] = glm::vec3(0);
+	previousOrientation[index] = glm::quat(1, 0, 0, 0);
+	simulatedPosition[index] = glm::vec3(0);
+	simulatedOrientation[index] = glm::quat(1, 0, 0, 0);
+	interpolated[index] = 0;
+	return handle;
+}
+
+void PhysicsBodyStorage::Destroy(uint32_t handle)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto [index, last] = m_index.Erase(handle);
+	if (index == last)
+		return;
+
+	velocity[index] = velocity[last];
+	rotationalVelocity[index] = rotationalVelocity[last];
+	acceleration[index] = acceleration[last];
+	rotationalAcceleration[index] = rotationalAcceleration[last];
+	awake[index] = awake[last];
+	restingTime[index] = restingTime[last];
+	transform[index] = transform[last];
+	owner[index] = owner[last];
+	previousPosition[index] = previousPosition[last];
+	previousOrientation[index] = previousOrientation[last];
+	simulatedPosition[index] = simulatedPosition[last];
+	simulatedOrientation[index] = simulatedOrientation[last];
+	interpolated[index] = interpolated[last];
+}
+
+void PhysicsBodyStorage::Sleep(uint32_t index)
+{
+	awake[index] = 0;
+	velocity[index] = PhysicsVec3(0);
+	rotationalVelocity[index] = PhysicsVec3(0);
+	// Rendering shows the body at rest instead of between its last two poses
+	previousPosition[index] = simulatedPosition[index];
+	previousOrientation[index] = simulatedOrientation[index];
+}
+#pragma endregion
+
+// ****** Integration ****** //
+#pragma region Integration
+// Every body only writes its own rows and its own transform, so batches need no locking. Sleeping
+// bodies are skipped
+void PhysicsBodyStorage::IntegrateForces(JobSystem& jobs)
+{
+	jobs.ParallelFor(Size(), BATCH_SIZE, [this](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+			IntegrateForces(i);
+	});
+}
+
+void PhysicsBodyStorage::IntegrateVelocities(PhysicsReal dt, TransformStorage& transforms, JobSystem& jobs)
+{
+	jobs.ParallelFor(Size(), BATCH_SIZE, [this, dt, &transforms](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+			IntegrateVelocities(i, dt, transforms);
+	});
+}
+
+void PhysicsBodyStorage::IntegrateForces(uint32_t index)
+{
+	if (!awake[index])
+		return;
+	velocity[index] += acceleration[index];
+	rotationalVelocity[index] += rotationalAcceleration[index];
+	acceleration[index] = PhysicsVec3(0);
+	rotationalAcceleration[index] = PhysicsVec3(0);
+}
+
+void PhysicsBodyStorage::IntegrateVelocities(uint32_t index, PhysicsReal dt, TransformStorage& transforms)
+{
+	if (transform[index] == StorageIndex::INVALID || !awake[index])
+		return;
+
+	uint32_t t = transforms.Index(transform[index]);
+	previousPosition[index] = transforms.position[t];
+	previousOrientation[index] = transforms.orientation[t];
+
+	transforms.position[t] = PhysicsVec3(transforms.position[t]) + velocity[index] * dt;
+	// the matrices are composed once in the world transform pass
+	if (rotationalVelocity[index] != PhysicsVec3(0))
+		transforms.SetRotation(t, PhysicsVec3(transforms.rotation[t]) + rotationalVelocity[index] * dt);
+	else
+		transforms.MarkChanged(t);
+
+	simulatedPosition[index] = transforms.position[t];
+	simulatedOrientation[index] = transforms.orientation[t];
+}
+
+void PhysicsBodyStorage::Interpolate(float alpha, TransformStorage& transforms, JobSystem& jobs)
+{
+	alpha = glm::clamp(alpha, 0.0f, 1.0f);
+	jobs.ParallelFor(Size(), BATCH_SIZE, [this, alpha, &transforms](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			if (transform[i] == StorageIndex::INVALID || !awake[i])
+				continue;
+
+			// A transform set by gameplay after the step is shown where it was put
+			uint32_t t = transforms.Index(transform[i]);
+			if (transforms.position[t] != simulatedPosition[i] || transforms.orientation[t] != simulatedOrientation[i])
+				continue;
+
+			transforms.position[t] = glm::mix(previousPosition[i], simulatedPosition[i], alpha);
+			transforms.orientation[t] = glm::slerp(previousOrientation[i], simulatedOrientation[i], alpha);
+			transforms.MarkChanged(t);
+			interpolated[i] = 1;
+		}
+	});
+}
+
+void PhysicsBodyStorage::RestoreSimulated(TransformStorage& transforms, JobSystem& jobs)
+{
+	jobs.ParallelFor(Size(), BATCH_SIZE, [this, &transforms](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			if (!interpolated[i])
+				continue;
+
+			uint32_t t = transforms.Index(transform[i]);
+			transforms.position[t] = simulatedPosition[i];
+			transforms.orientation[t] = simulatedOrientation[i];
+			transforms.MarkChanged(t);
+			interpolated[i] = 0;
+		}
+	});
+}
+#pragma endregion
@@ -0,0 +1,89 @@
+#pragma once
+
+class PhysicsComponent;
+class TransformStorage;
+
+// Structure-of-arrays store for the hot state of every physics body. The integrator runs
+// linearly over these columns; mass, drag and other tuning values stay on the component
+class PhysicsBodyStorage
+{
+public:
+	// Bodies per job when the integration passes are split across the workers
+	static constexpr uint32_t BATCH_SIZE = 256;
+
+	//@brief Allocates a body at rest
+	//@param component : The component the body belongs to
+	//@return uint32_t : Stable handle of the body
+	uint32_t Create(PhysicsComponent* component);
+
+	//@brief Releases a body, the last body is moved into its slot
+	//@param handle : Handle returned by Create
+	void Destroy(uint32_t handle);
+
+	//@brief Returns the dense index of a body, valid until the next Destroy
+	//@param handle : Handle returned by Create
+	inline uint32_t Index(uint32_t handle) const { return m_index.DenseIndex(handle); }
+
+	//@brief Returns the number of live bodies
+	inline uint32_t Size() const { return m_index.Size(); }
+
+	//@brief Wakes a body, it is simulated again from the next step
+	//@param index : Dense index of the body
+	inline void Wake(uint32_t index) { awake[index] = 1; restingTime[index] = 0; }
+
+	//@brief Puts a body to sleep where it was last simulated
+	//@param index : Dense index of the body
+	void Sleep(uint32_t index);
+
+	//@brief Folds the accumulated accelerations of all bodies into their velocities
+	//@param jobs : Scheduler the bodies are split across
+	void IntegrateForces(JobSystem& jobs);
+
+	//@brief Moves the transforms of all bodies by their velocities
+	//@param dt : Time step
+	//@param transforms : Storage the transform handles refer to
+	//@param jobs : Scheduler the bodies are split across
+	void IntegrateVelocities(PhysicsReal dt, TransformStorage& transforms, JobSystem& jobs);
+
+	//@brief Moves the transforms of all awake bodies to their pose alpha of the way through the last step,
+	// for rendering. Transforms that were moved since the step keep their pose
+	//@param alpha : Fraction of the step, 0 for the pose before it and 1 for the pose after it
+	//@param transforms : Storage the transform handles refer to
+	//@param jobs : Scheduler the bodies are split across
+	void Interpolate(float alpha, TransformStorage& transforms, JobSystem& jobs);
+
+	//@brief Puts back the simulated poses replaced by Interpolate
+	//@param transforms : Storage the transform handles refer to
+	//@param jobs : Scheduler the bodies are split across
+	void RestoreSimulated(TransformStorage& transforms, JobSystem& jobs);
+
+	//@brief Same as IntegrateForces for a single body
+	//@param index : Dense index of the body
+	void IntegrateForces(uint32_t index);
+
+	//@brief Same as IntegrateVelocities for a single body
+	//@param index : Dense index of the body
+	//@param dt : Time step
+	//@param transforms : Storage the transform handles refer to
+	void IntegrateVelocities(uint32_t index, PhysicsReal dt, TransformStorage& transforms);
+
+	StorageColumn<PhysicsVec3> velocity;
+	StorageColumn<PhysicsVec3> rotationalVelocity;
+	StorageColumn<PhysicsVec3> acceleration;
+	StorageColumn<PhysicsVec3> rotationalAcceleration;
+	StorageColumn<uint8_t> awake;				// Sleeping bodies are skipped by every pass until something wakes them
+	StorageColumn<PhysicsReal> restingTime;		// Seconds the body has moved slower than the sleep thresholds
+	StorageColumn<uint32_t> transform;			// Transform handle, StorageIndex::INVALID until the component is attached
+	StorageColumn<PhysicsComponent*> owner;
+
+	// Pose of the transform before and after the last step, the two states rendering interpolates between
+	StorageColumn<glm::vec3> previousPosition;
+	StorageColumn<glm::quat> previousOrientation;
+	StorageColumn<glm::vec3> simulatedPosition;
+	StorageColumn<glm::quat> simulatedOrientation;
+	StorageColumn<uint8_t> interpolated;		// The transform holds an interpolated pose until RestoreSimulated
+
+private:
+	StorageIndex m_index;
+	std::mutex m_mutex;		// bodies are created from the loader threads
+};
@@ -3,13 +3,12 @@
 #include "CollisionComponent.h"
 #include "PhysicsManager.h"
 
-PhysicsComponent::PhysicsComponent(double mass, double gravityMultiplyer, double bounciness, double drag, double rotationalDrag) : Component(),
-	m_velocity(glm::dvec3(0)), m_rotationalVelocity(glm::dvec3(0)),
-	m_acceleration(glm::dvec3(0)), m_rotationalAcceleration(glm::dvec3(0)),
-	m_mass(mass), m_inverseMass(1 / m_mass), m_drag(drag), m_rotationalDrag(rotationalDrag),
-	m_gravityMultiplier(gravityMultiplyer), m_bounciness(bounciness), m_grounded(false)
+PhysicsComponent::PhysicsComponent(double mass, double gravityMultiplyer, double bounciness, double drag, double rotationalDrag, double friction) : Component(),
+	m_mass(mass), m_inverseMass(inverseOf(m_mass)), m_drag(drag), m_rotationalDrag(rotationalDrag),
+	m_gravityMultiplier(gravityMultiplyer), m_bounciness(bounciness), m_friction(friction), m_grounded(false),
+	m_pBodies(&SERVICE_LOCATOR.GetPhysicsManager()->GetBodies())
 {
-	SERVICE_LOCATOR.GetPhysicsManager()->AddPhysicsComponent(this);
+	m_body = SERVICE_LOCATOR.GetPhysicsManager()->AddPhysicsComponent(this);
 	Init();
 }
 
@@ -21,21 +20,21 @@ PhysicsComponent::~PhysicsComponent()
 void PhysicsComponent::Init()
 {
 	defineMember();
+	// Init runs again once the component is attached, the integrator needs the owner's transform
+	if (pOwner)
+		m_pBodies->transform[m_pBodies->Index(m_body)] = pOwner->GetTransform()->GetHandle();
 }
 
 void PhysicsComponent::Update(double deltaTime)
 {
-	m_velocity += m_acceleration;
-	m_rotationalVelocity += m_rotationalAcceleration;
-	m_acceleration = glm::dvec3(0);
-	m_rotationalAcceleration = glm::dvec3(0);
+	// Single body version of PhysicsManager::Update
+	if (!IsAwake())
+		return;
+	m_pBodies->IntegrateForces(m_pBodies->Index(m_body));
 
 	GroundedResponse();
 
-	glm::dvec3 pos = pOwner->GetTransform()->GetPosition();
-	pOwner->GetTransform()->SetPosition(pos + (m_velocity * deltaTime));
-	glm::dvec3 rotation = pOwner->GetTransform()->GetRotation();
-	pOwner->GetTransform()->SetRotation(rotation + (m_rotationalVelocity * deltaTime));
+	m_pBodies->IntegrateVelocities(m_pBodies->Index(m_body), deltaTime, Transform::GetStorage());
 }
 
 void PhysicsComponent::Shutdown()
@@ -44,116 +43,56 @@ void PhysicsComponent::Shutdown()
 
 void PhysicsComponent::GroundedResponse()
 {
-	glm::dvec3 gravity = SERVICE_LOCATOR.GetPhysicsManager()->GetGravity();
-	glm::dvec3 grav_dir = glm::normalize(gravity);
+	PhysicsVec3 gravity = SERVICE_LOCATOR.GetPhysicsManager()->GetGravity();
 
-	if (!m_grounded)
+	// The contact is only lost on the next collision update, an object already moving off the ground,
+	// as after a jump, leaves it now
+	if (m_ground.support && glm::dot(velocity() - PhysicsVec3(m_ground.velocity), PhysicsVec3(m_ground.normal)) > LEAVE_GROUND_SPEED)
+		m_ground = {};
+
+	const bool landing = m_ground.support && !m_grounded;
+	m_grounded = m_ground.support != nullptr;
+	if (m_grounded)
 	{
-		auto groundCheck = CheckForGround();
-		if (groundCheck)	// Transition to grounded state
+		// The ground holds the object up instead of gravity and carries it along: the object keeps its
+		// velocity relative to the ground, so a moving platform moves it through the body's own pose.
+		// Velocity into the ground is removed and the contact solver pushes out what overlaps
+		const PhysicsVec3 normal(m_ground.normal);
+		const PhysicsVec3 groundVelocity(m_ground.velocity);
+		if (landing)
 		{
-			if (m_bounciness > 0)	// Bounce off the ground; if velocity still too low, set grounded to true
-			{
-				// TODO: Implement bouncing off the ground
-				// glm::dvec3 normal = groundCheck->first.GetCollisionShape()->GetNormal(grav_dir);
-				// m_velocity = m_velocity - 2.0 * glm::dot(m_velocity, normal) * normal * m_bounciness;
-			}
-			double parallel_to_gravity = glm::dot(glm::normalize(m_velocity), grav_dir);
-			if (parallel_to_gravity >= 0)	// If the velocity is aligned with gravity, the object is grounded
-			{
-				m_grounded = true;
-				CollisionComponent* collisionComponent = this->GetComponent<CollisionComponent>();
-				CollisionComponent tempComponent = groundCheck->first;
-				glm::dvec3 startPos = tempComponent.GetCollisionShape()->GetPosition();
-				glm::dvec3 endPos = collisionComponent->GetCollisionShape()->GetPosition();
-				glm::dvec3 newPos = tempComponent.Cast_FirstAvailablePosition(startPos, endPos, 10); // TODO maybe change iterations to depend on velocity
-
-				glm::dvec3 rotation = groundCheck->first.GetCollisionShape()->GetRotation();
-
-				glm::dvec3 projection = (glm::dot(m_velocity, gravity) / glm::length2(gravity)) * gravity;
-				m_velocity -= projection; // Remove velocity component aligned with gravity
-				m_rotationalVelocity = glm::dvec3(0);
-				// still need to set position and rotation to the ground
-				collisionComponent->GetCollisionShape()->SetPosition(newPos);
-				collisionComponent->GetCollisionShape()->SetRotation(rotation);
-				pOwner->GetTransform()->SetPosition(newPos);
-				pOwner->GetTransform()->SetRotation(rotation);
-				m_velocity = ApplyDrag();
-			}
+			rotationalVelocity() = PhysicsVec3(0);
+			velocity() = groundVelocity + (velocity() - groundVelocity) * (1 - m_drag);
 		}
-	}
-	else	// grounded
-	{
-		m_grounded = IsStillGrounded();
-		if (m_grounded)	// continue to be grounded
+		else
 		{
-			return; // TODO: Can move left or right and be inside the ground
+			velocity() += groundVelocity - m_carriedVelocity;
 		}
+		m_carriedVelocity = groundVelocity;
+		const PhysicsReal approach = glm::dot(velocity() - groundVelocity, normal);
+		velocity() -= std::min(approach, PhysicsReal(0)) * normal;
+		return;
 	}
+	// Leaving the ground keeps the velocity it gave
+	m_carriedVelocity = PhysicsVec3(0);
 
-	if (!m_grounded)
-	{
-		m_velocity += gravity * m_gravityMultiplier;
-		m_velocity = ApplyDrag();
-		m_rotationalVelocity = ApplyRotationalDrag();
-	}
+	velocity() += gravity * m_gravityMultiplier;
+	velocity() = ApplyDrag();
+	rotationalVelocity() = ApplyRotationalDrag();
 }
 
 void PhysicsComponent::Update() 
-{ Update(SERVICE_LOCATOR.GetTime()->GetDeltaTime()); }
+{ }
 
 
-glm::dvec3 PhysicsComponent::ApplyDrag()
+PhysicsVec3 PhysicsComponent::ApplyDrag()
 {
-	glm::dvec3 drag = m_velocity * (1 - m_drag);
+	PhysicsVec3 drag = velocity() * (1 - m_drag);
 	return drag;
 }
 
-glm::dvec3 PhysicsComponent::ApplyRotationalDrag()
+PhysicsVec3 PhysicsComponent::ApplyRotationalDrag()
 {
-	glm::dvec3 drag = m_rotationalVelocity * (1 - m_rotationalDrag);
+	PhysicsVec3 drag = rotationalVelocity() * (1 - m_rotationalDrag);
 	return drag;
 }
-
-std::optional<std::pair<CollisionComponent,CollisionComponent>> PhysicsComponent::CheckForGround()
-{
-	CollisionComponent* collisionComponent = this->GetComponent<CollisionComponent>();
-	if (!collisionComponent) { return std::nullopt; }	// If this has no collision component, this cannot be grounded
-	glm::dvec3 gravity = SERVICE_LOCATOR.GetPhysicsManager()->GetGravity();
-	glm::dvec3 gravDir = glm::normalize(gravity);
-	double  gravityDot = glm::dot(glm::normalize(m_velocity), gravDir);
-	if (gravityDot <= 0) { return std::nullopt; } // If this is moving upwards, this is not grounded
-	double deltaTime = SERVICE_LOCATOR.GetTime()->GetDeltaTime();
-	glm::dvec3 startPosition = collisionComponent->GetCollisionShape()->GetPosition();
-	glm::dvec3 endPosition = startPosition + (m_velocity * deltaTime);
-	glm::dvec3 startRotation = collisionComponent->GetCollisionShape()->GetRotation();
-	glm::dvec3 endRotation = startRotation + (m_rotationalVelocity * deltaTime);
-
-	auto castResult = collisionComponent->Cast_FirstCollision(startPosition, endPosition, startRotation, endRotation, 10);
-	CollisionComponent* collidedComponent = castResult.second;
-	if (!collidedComponent) { return std::nullopt; }	// If no collision occurred, the object is not grounded
-	if (collidedComponent->HasComponent<PhysicsComponent>()) { return std::nullopt; }	// If the collided object has no physics component, this cannot be grounded
-	return std::pair<CollisionComponent, CollisionComponent> {castResult.first, *castResult.second};
-}
-
-bool PhysicsComponent::IsStillGrounded()
-{
-    CollisionComponent* collisionComponent = this->GetComponent<CollisionComponent>();
-    if (!collisionComponent) { return false; }	// If this has no collision component, this cannot be grounded
-	
-    glm::dvec3 gravity = SERVICE_LOCATOR.GetPhysicsManager()->GetGravity();
-	double gravityDot = glm::dot(m_velocity, gravity); // how much of the velocity is aligned with gravity
-	if (gravityDot < 0) { return false; } // If dot product is negative, the object is moving upwards and not grounded
-
-    glm::dvec3 startPosition = collisionComponent->GetCollisionShape()->GetPosition();
-	glm::dvec3 endPosition = startPosition + (glm::normalize(gravity) * s_offset);	// Small offset in the direction of gravity
-    glm::dvec3 startRotation = collisionComponent->GetCollisionShape()->GetRotation();
-    glm::dvec3 endRotation = startRotation;
-
-    auto castResult = collisionComponent->Cast_FirstCollision(startPosition, endPosition, startRotation, endRotation);
-    CollisionComponent* collidedComponent = castResult.second;
-    if (!collidedComponent) { return false; }	// If no collision occurred, the object is not grounded
-    if (collidedComponent->HasComponent<PhysicsComponent>()) { return false; } // If the collided object has no physics component, this cannot be grounded
-
-    return true;
-}
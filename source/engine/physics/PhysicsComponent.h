@@ -1,25 +1,39 @@
 #pragma once
 
 class CollisionComponent;
+class PhysicsBodyStorage;
 
 class PhysicsComponent : public Component
 {
 public:
+	// What the object stands on, found among the contacts of the last collision update
+	struct GroundInfo
+	{
+		glm::dvec3 normal{ 0.0 };				// Surface normal of the ground, pointing at the object
+		glm::dvec3 velocity{ 0.0 };				// Velocity of the ground, zero for colliders without a body
+		CollisionComponent* support = nullptr;	// Collider stood on, nullptr while the object is in the air
+	};
 
+	//@brief Constructor
+	//@param mass : The mass, 0 or less for a body that forces and contacts do not move
 	PhysicsComponent(double mass = 1, double gravityMultiplyer = 1, double bounciness = 0, 
-		double drag = 0, double rotationalDrag = 0);
+		double drag = 0, double rotationalDrag = 0, double friction = 0.5);
 
 	~PhysicsComponent();
 
+	// A component owns its body slot
+	PhysicsComponent(const PhysicsComponent&) = delete;
+	PhysicsComponent& operator=(const PhysicsComponent&) = delete;
+
 	//-------------------
 	//Component essentials
 	//-------------------
 
 	//@brief Initialize the component
 	void Init() override;
-	//@brief Update the component
+	//@brief Steps this body alone by deltaTime
 	void Update(double deltaTime);
-	//@brief Update the component
+	//@brief Does nothing, bodies are stepped by the PhysicsManager on the fixed time step
 	void Update() override;
 	//@brief Shutdown the component
 	void Shutdown() override;
@@ -27,17 +41,20 @@ public:
 	//-------------------
 	// PhysicsComponent essentials
 	//-------------------
-	//@brief Manage object reaction to being grounded
+	//@brief Manage object reaction to being grounded, the ground is set by the PhysicsManager from the contacts
 	void GroundedResponse();
-	//@brief Expensive check if the object is grounded
-	std::optional < std::pair<CollisionComponent, CollisionComponent>> CheckForGround();
-	//@brief Cheap check if the object is still grounded
-	bool IsStillGrounded();
+	//@brief Wakes the object if it is sleeping, along with its island on the next step. Forces, torques,
+	// velocities and moving its transform wake it on their own
+	inline void Wake() { m_pBodies->Wake(m_pBodies->Index(m_body)); }
+	//@brief Returns whether the object is simulated, sleeping objects are skipped until something wakes them
+	//@return bool Whether the object is awake
+	inline bool IsAwake() const { return m_pBodies->awake[m_pBodies->Index(m_body)] != 0; }
 	//@brief Apply a force to the object
 	//@param force : The force to apply
 	void ApplyForce(const glm::dvec3& force)
 	{
-		m_acceleration += force * m_inverseMass;
+		Wake();
+		acceleration() += PhysicsVec3(force) * m_inverseMass;
 	}
 	//@brief Apply a force to the object
 	//@param x : The x component of the force
@@ -45,15 +62,15 @@ public:
 	//@param z : The z component of the force
 	void ApplyForce(double x, double y, double z)
 	{
-		m_acceleration.x += x * m_inverseMass;
-		m_acceleration.y += y * m_inverseMass;
-		m_acceleration.z += z * m_inverseMass;
+		Wake();
+		acceleration() += PhysicsVec3(x, y, z) * m_inverseMass;
 	}
 	//@brief Apply a torque to the object
 	// @param torque : The torque to apply
 	void ApplyTorque(const glm::dvec3& torque)
 	{
-		m_rotationalAcceleration += torque;
+		Wake();
+		rotationalAcceleration() += PhysicsVec3(torque);
 	}
 	//@brief Apply a torque to the object
 	//@param x : The x component of the torque
@@ -61,9 +78,8 @@ public:
 	//@param z : The z component of the torque
 	void ApplyTorque(double x, double y, double z)
 	{
-		m_rotationalAcceleration.x += x;
-		m_rotationalAcceleration.y += y;
-		m_rotationalAcceleration.z += z;
+		Wake();
+		rotationalAcceleration() += PhysicsVec3(x, y, z);
 	}
 
 	//--------------------------------
@@ -75,26 +91,32 @@ public:
 	inline void SetGrounded(bool grounded) { m_grounded = grounded; }
 	//@brief Set the velocity of the object
 	//@param velocity : The velocity to set
-	inline void SetVelocity(const glm::dvec3& velocity) { m_velocity = velocity; }
+	inline void SetVelocity(const glm::dvec3& velocity) { Wake(); this->velocity() = PhysicsVec3(velocity); }
 	//@brief Set the velocity of the object
 	//@param x : The x component of the velocity
 	//@param y : The y component of the velocity
 	//@param z : The z component of the velocity
 	inline void SetVelocity(double x, double y, double z)
 	{
-		m_velocity.x = x;
-		m_velocity.y = y;
-		m_velocity.z = z;
+		Wake();
+		velocity() = PhysicsVec3(x, y, z);
 	}
-	//@brief Set the mass of the object
+	//@brief Set the mass of the object. A mass of 0 or less gives an inverse mass of 0, a body that forces
+	// and contacts do not move, as colliders without a body; its velocity and gravity still move it
 	//@param mass : The mass to set
-	inline void SetMass(double mass) { m_mass = mass; m_inverseMass = 1 / mass; }
+	inline void SetMass(double mass) { m_mass = static_cast<PhysicsReal>(mass); m_inverseMass = inverseOf(m_mass); }
 	//@brief Set the drag of the object
 	//@param drag : The drag to set
-	inline void SetDrag(double drag) { m_drag = drag; }
+	inline void SetDrag(double drag) { m_drag = static_cast<PhysicsReal>(drag); }
 	//@brief Set the gravity of the object
 	//@param gravity : The gravity to set
-	inline void SetGravityMultiplyer(double gravity) { m_gravityMultiplier = gravity; }
+	inline void SetGravityMultiplyer(double gravity) { m_gravityMultiplier = static_cast<PhysicsReal>(gravity); }
+	//@brief Set how much of its speed the object keeps when it bounces off something
+	//@param bounciness : The bounciness to set
+	inline void SetBounciness(double bounciness) { m_bounciness = static_cast<PhysicsReal>(bounciness); }
+	//@brief Set how strongly the object resists sliding along what it touches
+	//@param friction : The friction coefficient to set
+	inline void SetFriction(double friction) { m_friction = static_cast<PhysicsReal>(friction); }
 
 	//--------------------------------
 	// Getters
@@ -103,14 +125,26 @@ public:
 	//@brief Get the grounded state of the object
 	//@return bool The grounded state of the object
 	inline bool Grounded() { return m_grounded; }
+	//@brief Get what the object stands on
+	//@return const GroundInfo& The ground, with no support while the object is in the air
+	inline const GroundInfo& GetGroundInfo() const { return m_ground; }
+	//@brief Get the surface normal of the ground
+	//@return glm::dvec3 The normal, zero while the object is in the air
+	inline glm::dvec3 GetGroundNormal() const { return m_ground.normal; }
+	//@brief Get the velocity of the ground, what a character standing on it is carried along by
+	//@return glm::dvec3 The velocity of the ground
+	inline glm::dvec3 GetGroundVelocity() const { return m_ground.velocity; }
+	//@brief Get the collider the object stands on
+	//@return CollisionComponent* The support, nullptr while the object is in the air
+	inline CollisionComponent* GetGroundSupport() const { return m_ground.support; }
 	//@brief Get the velocity of the object
 	//@return glm::dvec3 The velocity of the object
-	inline glm::dvec3 GetVelocity() { return m_velocity; }
+	inline glm::dvec3 GetVelocity() { return glm::dvec3(velocity()); }
 	//@brief Get the mass of the object
 	//@return double The mass of the object
 	inline double GetMass() { return m_mass; }
 	//@brief Get the inverse mass of the object
-	// @return double The inverse mass of the object
+	// @return double The inverse mass of the object, 0 for a mass of 0 or less
 	inline double GetInverseMass() { return m_inverseMass; }
 	//@brief Get the drag of the object
 	//@return double The drag of the object
@@ -118,26 +152,47 @@ public:
 	//@brief Get the gravity of the object
 	//@return double The gravity of the object
 	inline double GetGravityMultiplyer() { return m_gravityMultiplier; }
-
-
-	static inline const double s_offset { 0.01 }; // Offset for grounded check
+	//@brief Get the bounciness of the object
+	//@return double The bounciness of the object
+	inline double GetBounciness() { return m_bounciness; }
+	//@brief Get the friction coefficient of the object
+	//@return double The friction coefficient of the object
+	inline double GetFriction() { return m_friction; }
+	//@brief Get the handle of the object's body in the PhysicsBodyStorage
+	//@return uint32_t The body handle
+	inline uint32_t GetBody() const { return m_body; }
 
 private:
-	glm::dvec3 ApplyDrag();
-
-	glm::dvec3 ApplyRotationalDrag();
-
-	glm::dvec3 m_velocity;						// Component's velocity
-	glm::dvec3 m_rotationalVelocity;			// Component's rotational velocity
-	glm::dvec3 m_acceleration;					// Component's acceleration
-	glm::dvec3 m_rotationalAcceleration;		// Component's rotational acceleration
-	double m_mass;								// Component's mass
-	double m_inverseMass;						// (1/ mass)	avoids devision in calculations
-	double m_drag;								// (0-1) 0 being no drag, 1 being full drag
-	double m_rotationalDrag;					// (0-1) 0 being no drag, 1 being full drag
-	double m_gravityMultiplier;					// Multiplier for gravity
-	double m_bounciness;						// (0-1) 0 being no bounce, 1 being full bounce
+	// Speed away from the ground at which the object leaves it before the contact is gone
+	static constexpr PhysicsReal LEAVE_GROUND_SPEED = 0.5;
+
+	// 1 / mass, 0 for a mass of 0 or less rather than an infinite or negative inverse mass
+	static PhysicsReal inverseOf(PhysicsReal mass) { return mass > 0 ? 1 / mass : PhysicsReal(0); }
+
+	PhysicsVec3 ApplyDrag();
+
+	PhysicsVec3 ApplyRotationalDrag();
+
+	// Velocities and accelerations live in the PhysicsManager's PhysicsBodyStorage
+	inline PhysicsVec3& velocity() { return m_pBodies->velocity[m_pBodies->Index(m_body)]; }
+	inline PhysicsVec3& rotationalVelocity() { return m_pBodies->rotationalVelocity[m_pBodies->Index(m_body)]; }
+	inline PhysicsVec3& acceleration() { return m_pBodies->acceleration[m_pBodies->Index(m_body)]; }
+	inline PhysicsVec3& rotationalAcceleration() { return m_pBodies->rotationalAcceleration[m_pBodies->Index(m_body)]; }
+
+	PhysicsBodyStorage* m_pBodies;				// Storage holding the body
+	uint32_t m_body;							// Handle of the body in m_pBodies
+	PhysicsReal m_mass;								// Component's mass
+	PhysicsReal m_inverseMass;						// (1/ mass)	avoids devision in calculations
+	PhysicsReal m_drag;								// (0-1) 0 being no drag, 1 being full drag
+	PhysicsReal m_rotationalDrag;					// (0-1) 0 being no drag, 1 being full drag
+	PhysicsReal m_gravityMultiplier;					// Multiplier for gravity
+	PhysicsReal m_bounciness;						// (0-1) 0 being no bounce, 1 being full bounce
+	PhysicsReal m_friction;							// Coulomb coefficient, 0 being frictionless
 	bool m_grounded;							// Is the object grounded
+	GroundInfo m_ground;						// Set by the PhysicsManager before the grounded response
+	PhysicsVec3 m_carriedVelocity{ 0.0 };		// Ground velocity already in the body's, what the ground carries it at
+
+	friend class PhysicsManager;
 
 	void defineMember() override
 	{
@@ -146,11 +201,15 @@ private:
 		m_setters["drag"] = [this](std::any value) { SetDrag(std::any_cast<double>(value)); };
 		m_setters["gravityMultiplier"] = [this](std::any value) { SetGravityMultiplyer(std::any_cast<double>(value)); };
 		m_setters["grounded"] = [this](std::any value) { SetGrounded(std::any_cast<bool>(value)); };
+		m_setters["bounciness"] = [this](std::any value) { SetBounciness(std::any_cast<double>(value)); };
+		m_setters["friction"] = [this](std::any value) { SetFriction(std::any_cast<double>(value)); };
 
 		m_getters["velocity"] = [this]() -> std::any { return GetVelocity(); };
 		m_getters["mass"] = [this]() -> std::any { return GetMass(); };
 		m_getters["drag"] = [this]() -> std::any { return GetDrag(); };
 		m_getters["gravityMultiplier"] = [this]() -> std::any { return GetGravityMultiplyer(); };
 		m_getters["grounded"] = [this]() -> std::any { return Grounded(); };
+		m_getters["bounciness"] = [this]() -> std::any { return GetBounciness(); };
+		m_getters["friction"] = [this]() -> std::any { return GetFriction(); };
 	}
 };
@@ -34,119 +34,220 @@ void PhysicsManager::Init()
 
 void PhysicsManager::Update(double dt)
 {
-	for (auto& component : m_physicsComponents)
+	// Same steps as PhysicsComponent::Update, run as linear passes over the body storage. The ground
+	// of each body is read from the contacts first, so the grounded response only touches its own
+	// body and runs on the workers too. Sleeping bodies are skipped by every pass
+	JobSystem& jobs = *SERVICE_LOCATOR.GetJobSystem();
+	updateIslands(static_cast<PhysicsReal>(dt));
+	m_bodies.IntegrateForces(jobs);
+	findGround();
+	jobs.ParallelFor(m_bodies.Size(), PhysicsBodyStorage::BATCH_SIZE, [this](uint32_t begin, uint32_t end)
 	{
-		component->Update(dt);
-	}
+		for (uint32_t i = begin; i < end; i++)
+		{
+			if (m_bodies.transform[i] != StorageIndex::INVALID && m_bodies.awake[i])
+				m_bodies.owner[i]->GroundedResponse();
+		}
+	});
+	// Contacts come from the collision update at the end of the last step, after gravity so resting
+	// bodies are held up in the same step they are pulled down
+	m_contactSolver.Solve(SERVICE_LOCATOR.GetCollisionManager()->GetContacts(), m_bodies, dt);
+	m_bodies.IntegrateVelocities(dt, Transform::GetStorage(), jobs);
+	preventTunnelling();
 }
 
-void PhysicsManager::Shutdown()
+void PhysicsManager::findGround()
 {
-	printf("PhysicsManager Shutdown\n");
-	while (!m_physicsComponents.empty())
+	for (uint32_t i = 0; i < m_bodies.Size(); i++)
+		m_bodies.owner[i]->m_ground = {};
+	if (glm::length2(m_gravity) == 0)
+		return;
+
+	const PhysicsVec3 up = -glm::normalize(m_gravity);
+	auto stand = [this, &up](CollisionComponent* component, CollisionComponent* ground, const PhysicsVec3& normal)
+	{
+		PhysicsComponent* physics = component->GetComponent<PhysicsComponent>();
+		const PhysicsReal facing = glm::dot(normal, up);
+		if (!physics || facing < m_minGroundCosine)
+			return;
+		PhysicsComponent::GroundInfo& info = physics->m_ground;
+		if (info.support && glm::dot(PhysicsVec3(info.normal), up) >= facing)
+			return;
+		PhysicsComponent* body = ground->GetComponent<PhysicsComponent>();
+		info = { glm::dvec3(normal), body ? body->GetVelocity() : glm::dvec3(0.0), ground };
+	};
+	// Manifold normals point from the first collider to the second
+	for (const CollisionManager::Contact& contact : SERVICE_LOCATOR.GetCollisionManager()->GetContacts())
 	{
-		delete m_physicsComponents[0];
+		stand(contact.component1, contact.component2, -contact.manifold.normal);
+		stand(contact.component2, contact.component1, contact.manifold.normal);
 	}
-	m_physicsComponents.clear();
 }
-#pragma endregion
 
-// ****** Collision Response ****** //
-#pragma region CollisionResponse
-void PhysicsManager::CollisionRouting(std::vector<std::pair<GameObject*, GameObject*>> collisions)
+void PhysicsManager::preventTunnelling()
 {
-	for (auto& collision : collisions)
+	// Casts only read the static colliders and each body writes back its own slots, so bodies are
+	// swept on the workers
+	TransformStorage& transforms = Transform::GetStorage();
+	CollisionManager* collisionManager = SERVICE_LOCATOR.GetCollisionManager();
+	SERVICE_LOCATOR.GetJobSystem()->ParallelFor(m_bodies.Size(), TUNNELLING_BATCH_SIZE, [this, &transforms, collisionManager](uint32_t begin, uint32_t end)
 	{
-		CollisionResponse(collision.first, collision.second);
-	}
+		for (uint32_t i = begin; i < end; i++)
+		{
+			if (m_bodies.transform[i] == StorageIndex::INVALID || !m_bodies.awake[i])
+				continue;
+			CollisionComponent* collisionComponent = m_bodies.owner[i]->GetComponent<CollisionComponent>();
+			if (!collisionComponent)
+				continue;
+
+			// Slow bodies cannot skip past anything the discrete checks would miss
+			const CollisionShape* shape = collisionComponent->GetCollisionShape();
+			const AABB bounds = shape->GetBounds();
+			const PhysicsVec3 size = bounds.max - bounds.min;
+			const PhysicsReal thickness = std::min(size.x, std::min(size.y, size.z));
+			uint32_t t = transforms.Index(m_bodies.transform[i]);
+			const PhysicsVec3 start = m_bodies.previousPosition[i];
+			const PhysicsVec3 end = transforms.position[t];
+			if (glm::length2(end - start) <= thickness * thickness * CONTINUOUS_THRESHOLD * CONTINUOUS_THRESHOLD)
+				continue;
+
+			// Colliders the body already touched are left to the discrete response
+			QueryFilter filter = collisionComponent->GetQueryFilter();
+			filter.staticOnly = true;
+			filter.ignoreInitialOverlaps = true;
+			QueryHit hit;
+			if (!collisionManager->ShapeCast(*shape, start, end, hit, filter))
+				continue;
+
+			transforms.position[t] = hit.position;
+			m_bodies.simulatedPosition[i] = hit.position;
+			PhysicsVec3& velocity = m_bodies.velocity[i];
+			velocity -= std::min(glm::dot(velocity, hit.normal), PhysicsReal(0)) * hit.normal;
+		}
+	});
 }
 
-void PhysicsManager::CollisionResponse(GameObject* obj1, GameObject* obj2)
+void PhysicsManager::updateIslands(PhysicsReal dt)
 {
-	bool shape1_isStatic = !obj1->HasComponent<PhysicsComponent>();
-	bool shape2_isStatic = !obj2->HasComponent<PhysicsComponent>();
+	const uint32_t count = m_bodies.Size();
+	TransformStorage& transforms = Transform::GetStorage();
+	m_islands.resize(count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		m_islands[i] = i;
+		// A sleeping transform only changes when gameplay moves it, the same test interpolation uses
+		if (!m_bodies.awake[i] && m_bodies.transform[i] != StorageIndex::INVALID)
+		{
+			uint32_t t = transforms.Index(m_bodies.transform[i]);
+			if (transforms.position[t] != m_bodies.simulatedPosition[i] || transforms.orientation[t] != m_bodies.simulatedOrientation[i])
+				m_bodies.Wake(i);
+		}
+		if (m_bodies.awake[i])
+		{
+			const bool resting = glm::length2(m_bodies.velocity[i]) <= SLEEP_LINEAR_SPEED * SLEEP_LINEAR_SPEED &&
+				glm::length2(m_bodies.rotationalVelocity[i]) <= SLEEP_ANGULAR_SPEED * SLEEP_ANGULAR_SPEED;
+			m_bodies.restingTime[i] = resting ? m_bodies.restingTime[i] + dt : 0;
+		}
+	}
 
-	if (shape1_isStatic && shape2_isStatic)
+	for (const CollisionManager::Contact& contact : SERVICE_LOCATOR.GetCollisionManager()->GetContacts())
 	{
-		// Handle collision with static object
-		// Do static objects collide?
+		PhysicsComponent* physics1 = contact.component1->GetComponent<PhysicsComponent>();
+		PhysicsComponent* physics2 = contact.component2->GetComponent<PhysicsComponent>();
+		if (!physics1 || !physics2)
+			continue;
+		const uint32_t island1 = findIsland(m_bodies.Index(physics1->GetBody()));
+		const uint32_t island2 = findIsland(m_bodies.Index(physics2->GetBody()));
+		if (island1 != island2)
+			m_islands[std::max(island1, island2)] = std::min(island1, island2);
 	}
-	else if (shape1_isStatic)
+
+	// Sleeping bodies count as rested, so an island wakes as soon as one of its bodies moves
+	m_islandRest.assign(count, SLEEP_TIME);
+	for (uint32_t i = 0; i < count; i++)
 	{
-		//StaticDynamicResponse(obj1, obj2);
+		if (m_bodies.awake[i])
+		{
+			PhysicsReal& rest = m_islandRest[findIsland(i)];
+			rest = std::min(rest, m_bodies.restingTime[i]);
+		}
 	}
-	else if (shape2_isStatic)
+
+	m_sleepStats = {};
+	for (uint32_t i = 0; i < count; i++)
 	{
-		//StaticDynamicResponse(obj2, obj1);
+		const uint32_t island = findIsland(i);
+		const bool sleeps = m_islandRest[island] >= SLEEP_TIME;
+		if (sleeps && m_bodies.awake[i])
+			m_bodies.Sleep(i);
+		else if (!sleeps && !m_bodies.awake[i])
+			m_bodies.Wake(i);
+
+		if (island == i)
+		{
+			m_sleepStats.islands++;
+			m_sleepStats.sleepingIslands += sleeps;
+		}
+		if (m_bodies.awake[i])
+			m_sleepStats.awake++;
+		else
+			m_sleepStats.sleeping++;
 	}
-	else
+}
+
+uint32_t PhysicsManager::findIsland(uint32_t body)
+{
+	while (m_islands[body] != body)
 	{
-		// Handle collision with two dynamic objects
-		//DynamicBounce(obj1, obj2);
+		m_islands[body] = m_islands[m_islands[body]];
+		body = m_islands[body];
 	}
+	return body;
 }
 
-void PhysicsManager::StaticDynamicResponse(GameObject* staticObject, GameObject* dynamicObject)
+void PhysicsManager::BeginInterpolation(double alpha)
 {
-	PhysicsComponent* physicsComponent = dynamicObject->GetComponent<PhysicsComponent>();
-	// Calculate the normal of the collision
-	glm::dvec3 dir = dynamicObject->GetTransform()->GetPosition() - staticObject->GetTransform()->GetPosition();
-	dir = glm::normalize(dir);
-	// Calculate static objects normal at the point of collision
-	glm::dvec3 normal = staticObject->GetComponent<CollisionComponent>()->GetCollisionShape()->GetNormal(dir);
-	// Calculate the reflection of the velocity
-	glm::dvec3 velocity = physicsComponent->GetVelocity();
-	glm::dvec3 reflection = velocity - 2.0 * glm::dot(velocity, normal) * normal;
-	// Apply the reflection
-	physicsComponent->SetVelocity(reflection);
+	m_bodies.Interpolate(static_cast<float>(alpha), Transform::GetStorage(), *SERVICE_LOCATOR.GetJobSystem());
 }
 
-void PhysicsManager::DynamicDynamicCollision(GameObject* obj1, GameObject* obj2)
+void PhysicsManager::EndInterpolation()
 {
-	// Calculate the relative velocity
-	// Calculate the normal of the collision
-	// Calculate the reflection of the velocity
-	// Apply the reflection
-	DynamicBounce(obj1, obj2);
+	m_bodies.RestoreSimulated(Transform::GetStorage(), *SERVICE_LOCATOR.GetJobSystem());
 }
 
-void PhysicsManager::DynamicBounce(GameObject* shape1, GameObject* shape2)
+void PhysicsManager::ShiftOrigin(const glm::dvec3& shift)
 {
+	// Transforms are shifted in floats, the poses get the same rounded offset so they still compare equal
+	const glm::vec3 offset(shift);
+	for (uint32_t i = 0; i < m_bodies.Size(); i++)
+	{
+		Node* owner = m_bodies.owner[i]->GetOwner();
+		if (m_bodies.transform[i] == StorageIndex::INVALID || !owner || owner->GetParent())
+			continue;
+		m_bodies.previousPosition[i] += offset;
+		m_bodies.simulatedPosition[i] += offset;
+	}
+}
 
-	// m1*v1 + m2*v2 = m1*v1' + m2*v2'
-	// v1' = (v1*(m1-m2) + 2*m2*v2) / (m1+m2)
-	// v2' = (v2*(m2-m1) + 2*m1*v1) / (m1+m2)
-	PhysicsComponent* physicsComponent1 = shape1->GetComponent<PhysicsComponent>();
-	PhysicsComponent* physicsComponent2 = shape2->GetComponent<PhysicsComponent>();
-	// Calculate the relative velocity
-	glm::vec3 relativeVelocity = physicsComponent1->GetVelocity() - physicsComponent2->GetVelocity();
-	double m1 = physicsComponent1->GetMass();
-	double m2 = physicsComponent2->GetMass();
-	glm::dvec3 v1 = physicsComponent1->GetVelocity();
-	glm::dvec3 v2 = physicsComponent2->GetVelocity();
-	double inverse_sumedMasses = 1 / (m1 + m2);
-	glm::dvec3 v1_prime = (v1 * (m1 - m2) + 2 * m2 * v2) * inverse_sumedMasses;
-	glm::dvec3 v2_prime = (v2 * (m2 - m1) + 2 * m1 * v1) * inverse_sumedMasses;
-
-	// Apply the impulse
-	physicsComponent1->SetVelocity(v1_prime);
-	physicsComponent2->SetVelocity(v2_prime);
+void PhysicsManager::Shutdown()
+{
+	printf("PhysicsManager Shutdown\n");
+	while (m_bodies.Size() > 0)
+	{
+		delete m_bodies.owner[0];
+	}
 }
 #pragma endregion
 
 // ****** PhysicsComponent Management ****** //
 #pragma region PhysicsComponentManagement
-void PhysicsManager::AddPhysicsComponent(PhysicsComponent* component)
+uint32_t PhysicsManager::AddPhysicsComponent(PhysicsComponent* component)
 {
-	m_physicsComponents.push_back(component);
+	return m_bodies.Create(component);
 }
 
 void PhysicsManager::RemovePhysicsComponent(PhysicsComponent* component)
 {
-	auto it = std::find(m_physicsComponents.begin(), m_physicsComponents.end(), component);
-	if (it != m_physicsComponents.end())
-	{
-		m_physicsComponents.erase(it);
-	}
+	m_bodies.Destroy(component->GetBody());
 }
 #pragma endregion
\ No newline at end of file
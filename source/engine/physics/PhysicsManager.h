@@ -5,14 +5,30 @@ class PhysicsComponent;
 class PhysicsManager
 {
 public:
+	// Bodies touching each other form an island, which only sleeps and wakes as a whole. Colliders
+	// without a body hold bodies up without joining their islands
+	struct SleepStats
+	{
+		uint32_t awake = 0;				// bodies simulated in the last step
+		uint32_t sleeping = 0;
+		uint32_t islands = 0;
+		uint32_t sleepingIslands = 0;
+	};
+
 	~PhysicsManager();
 
 	// ****** Physics Engine ****** //
 
 	//@brief Initializes the physics engine
 	void Init();
-	//@brief Updates the physics engine
+	//@brief Advances the simulation by one step
+	//@param dt : Step length, the fixed delta time in the game loop
 	void Update(double dt);
+	//@brief Shows every body between its last two simulated poses until EndInterpolation
+	//@param alpha : Fraction of a step since the last one, see Time::GetInterpolationAlpha
+	void BeginInterpolation(double alpha);
+	//@brief Puts the simulated poses back after rendering
+	void EndInterpolation();
 	//@brief Shuts down the physics engine
 	void Shutdown();
 
@@ -20,44 +36,95 @@ public:
 	
 	//@brief Adds a physics component to the physics engine
 	//@param component : The physics component to add
-	void AddPhysicsComponent(PhysicsComponent* component);
+	//@return uint32_t : Handle of the component's body in the body storage
+	uint32_t AddPhysicsComponent(PhysicsComponent* component);
 	//@brief Removes a physics component from the physics engine
 	//@param component : The physics component to remove
 	void RemovePhysicsComponent(PhysicsComponent* component);
+	//@brief Returns the storage holding the state of all physics bodies
+	//@return PhysicsBodyStorage& : The body storage
+	inline PhysicsBodyStorage& GetBodies() { return m_bodies; }
 
 	// ****** Physics Settings ****** //
 	// 
 	//@brief Returns the gravity
-	//@return double : The gravity
-	inline glm::dvec3 GetGravity() const { return m_gravity; }
+	//@return PhysicsVec3 : The gravity
+	inline PhysicsVec3 GetGravity() const { return m_gravity; }
 	//@brief Sets the gravity
 	//@param g : The gravity to set
 	inline void SetGravity(glm::vec3 g) { m_gravity = g; }
+	//@brief Sets the steepest contact a body counts as standing on
+	//@param degrees : Largest angle between the contact normal and the direction against gravity
+	inline void SetMaxGroundSlope(double degrees) { m_minGroundCosine = static_cast<PhysicsReal>(std::cos(glm::radians(degrees))); }
+	//@brief Returns the steepest contact a body counts as standing on
+	//@return double : Angle in degrees
+	inline double GetMaxGroundSlope() const { return glm::degrees(std::acos(static_cast<double>(m_minGroundCosine))); }
+
+	// ****** Contact Solver ****** //
+
+	//@brief Returns the solver that keeps bodies in contact from passing through each other, to tune its
+	// iterations and read how quickly it converged
+	//@return ContactSolver& : The contact solver
+	inline ContactSolver& GetContactSolver() { return m_contactSolver; }
 
-	// ****** Collision Response ****** //
-	//@brief Loops through all collisions and handles them
-	void CollisionRouting(std::vector<std::pair<GameObject*,GameObject*>> collisions);
-	//@brief Handles a collision between two physics components
-	void CollisionResponse(GameObject* obj1, GameObject* obj2);
-	//@brief Handles a collision between a static and dynamic physics component
-	void StaticDynamicResponse(GameObject* staticObject, GameObject* dynamicObject);
-	//@brief Handles a collision between two dynamic physics components
-	void DynamicDynamicCollision(GameObject* obj1, GameObject* obj2);
-	//@brief Handles the bounce between two dynamic physics components
-	void DynamicBounce(GameObject* shape1, GameObject* shape2);
+	// ****** Sleeping ****** //
 
+	//@brief Returns how many bodies and islands were awake in the last step
+	//@return const SleepStats& : Bodies and islands by state
+	inline const SleepStats& GetSleepStats() const { return m_sleepStats; }
+
+	// ****** Floating Origin ****** //
+
+	//@brief Moves the poses of the bodies on root nodes along with their transforms when the Scene rebases
+	// its origin, so interpolation and tunnelling sweeps carry on from the same place. Bodies of child
+	// nodes move with their parent and are left alone
+	//@param shift : Offset added to every root position
+	void ShiftOrigin(const glm::dvec3& shift);
 
 private:
 	PhysicsManager();
 
+	// Distance a body may move in one step, as a fraction of its thinnest side, before it is swept for tunnelling
+	static constexpr PhysicsReal CONTINUOUS_THRESHOLD = 0.5;
+	// Bodies per job when they are swept for tunnelling, fewer than the integration passes as a cast costs more
+	static constexpr uint32_t TUNNELLING_BATCH_SIZE = 64;
+
+	// A body slower than both speeds for SLEEP_TIME seconds is resting, an island whose bodies all rest sleeps
+	static constexpr PhysicsReal SLEEP_LINEAR_SPEED = 0.05;
+	static constexpr PhysicsReal SLEEP_ANGULAR_SPEED = 2.0;		// degrees per second, rotation is in Euler angles
+	static constexpr PhysicsReal SLEEP_TIME = 0.5;
+
+	//@brief Wakes the bodies moved by gameplay since the last step, builds the islands from the contacts of the
+	// last collision update and puts the islands that rested long enough to sleep, waking every island with
+	// an awake body that is still moving
+	//@param dt : Step length the resting time grows by
+	void updateIslands(PhysicsReal dt);
+
+	//@brief Returns the root of a body's island, flattening the path to it
+	uint32_t findIsland(uint32_t body);
+
+	//@brief Sets the ground of every body to the flattest contact of the last collision update that faces
+	// against gravity, within the slope limit
+	void findGround();
+
+	//@brief Sweeps the bodies that moved far in the last step from where they were, and stops them at the
+	// first static collider they would have passed through
+	void preventTunnelling();
+
 	//@brief Defines gravitational force and direction
-	glm::dvec3 m_gravity { 0,-9.8,0 };
+	PhysicsVec3 m_gravity { 0,-9.8,0 };
+	//@brief Cosine of the steepest slope a body can stand on, 45 degrees by default
+	PhysicsReal m_minGroundCosine = static_cast<PhysicsReal>(0.70710678118654752);
 
 	//@brief Returns the instance of the physics manager
 	static PhysicsManager* GetInstance();
 	static std::unique_ptr<PhysicsManager> instance;
 
-	std::vector<PhysicsComponent*> m_physicsComponents;
+	PhysicsBodyStorage m_bodies;
+	ContactSolver m_contactSolver;
+	std::vector<uint32_t> m_islands;			// union-find parent of each body, rebuilt every step
+	std::vector<PhysicsReal> m_islandRest;		// shortest resting time in each island, by its root
+	SleepStats m_sleepStats;
 
 	friend class ServiceLocator;
 };
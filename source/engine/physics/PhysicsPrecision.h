@@ -0,0 +1,20 @@
+#pragma once
+
+// Scalar and vector types the physics pipeline computes in. Doubles by default; defining
+// PHYSICS_SINGLE_PRECISION in the project's preprocessor definitions switches the whole pipeline to
+// floats, which halves the memory the body and collider arrays take and doubles the pairs one SIMD
+// instruction of the narrowphase tests. Floats keep about 7 digits, so a millimetre is lost past a
+// few kilometres from the origin; rebasing the floating origin of the Scene keeps the simulation near it.
+// Components, scenes and scripts keep talking to the physics in doubles
+#ifdef PHYSICS_SINGLE_PRECISION
+using PhysicsReal = float;
+#else
+using PhysicsReal = double;
+#endif
+
+using PhysicsVec3 = glm::vec<3, PhysicsReal>;
+using PhysicsMat3 = glm::mat<3, 3, PhysicsReal>;
+using PhysicsQuat = glm::qua<PhysicsReal>;
+
+// Name of the precision the physics was built with, for benchmark and log output
+inline constexpr const char* PHYSICS_PRECISION_NAME = sizeof(PhysicsReal) == sizeof(float) ? "float" : "double";
@@ -0,0 +1,263 @@
+#include "../pch.h"
+#include "SweepAndPrune.h"
+
+// ****** Proxies ****** //
+#pragma region Proxies
+Broadphase::ProxyId SweepAndPrune::CreateProxy(const AABB& bounds, void* userData, GroupId group)
+{
+	assert(group < m_groupCount);
+	if (group >= m_orders.size())
+		m_orders.resize(group + 1);
+
+	ProxyId proxy;
+	if (!m_freeProxies.empty())
+	{
+		proxy = m_freeProxies.back();
+		m_freeProxies.pop_back();
+	}
+	else
+	{
+		proxy = static_cast<ProxyId>(m_proxies.size());
+		m_proxies.emplace_back();
+	}
+	m_proxies[proxy] = { bounds, userData, group, true, true };
+	m_orders[group].push_back(proxy);
+	m_movedSinceSort.push_back(proxy);
+	++m_addedProxies;
+	++m_movedProxies;
+	return proxy;
+}
+
+void SweepAndPrune::DestroyProxy(ProxyId proxy)
+{
+	// The id is only reused once FindPairs has dropped it from its order
+	m_proxies[proxy] = {};
+	m_destroyedProxies.push_back(proxy);
+}
+
+void SweepAndPrune::MoveProxy(ProxyId proxy, const AABB& bounds)
+{
+	Proxy& stored = m_proxies[proxy];
+	if (stored.bounds.min == bounds.min && stored.bounds.max == bounds.max)
+		return;
+	stored.bounds = bounds;
+	++m_movedProxies;
+	if (!stored.moved)
+	{
+		stored.moved = true;
+		m_movedSinceSort.push_back(proxy);
+	}
+}
+
+void SweepAndPrune::FindPairs(std::vector<Pair>& pairs)
+{
+	pairs.clear();
+	m_stats = {};
+	m_stats.movedProxies = m_movedProxies;
+	m_movedProxies = 0;
+
+	if (!m_destroyedProxies.empty())
+	{
+		for (std::vector<ProxyId>& order : m_orders)
+			std::erase_if(order, [this](ProxyId proxy) { return !m_proxies[proxy].alive; });
+		m_freeProxies.insert(m_freeProxies.end(), m_destroyedProxies.begin(), m_destroyedProxies.end());
+		m_destroyedProxies.clear();
+	}
+	for (const std::vector<ProxyId>& order : m_orders)
+		m_stats.proxies += static_cast<uint32_t>(order.size());
+
+	int axis = chooseAxis();
+	bool full = axis != m_axis || m_addedProxies > m_stats.proxies / 8;
+	m_axis = axis;
+	sort(full);
+	snapshot();
+
+	for (GroupId group1 = 0; group1 < m_orders.size(); ++group1)
+	{
+		for (GroupId group2 = group1; group2 < m_orders.size(); ++group2)
+		{
+			if (!CanPair(group1, group2))
+				continue;
+			if (group1 == group2)
+				sweep(m_orders[group1], pairs);
+			else
+				sweep(m_orders[group1], m_orders[group2], pairs);
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end());
+	m_stats.pairs = static_cast<uint32_t>(pairs.size());
+}
+
+template <typename Visit>
+void SweepAndPrune::visitCandidates(PhysicsReal lower, PhysicsReal upper, Visit&& visit) const
+{
+	// An unmoved proxy overlaps the range when it starts before its end and at most its group's longest
+	// interval before its start, the sorted lower bounds narrow that to a binary search
+	for (GroupId group = 0; group < m_sortedLower.size(); ++group)
+	{
+		const std::vector<PhysicsReal>& sorted = m_sortedLower[group];
+		const std::vector<ProxyId>& order = m_orders[group];
+		auto first = std::lower_bound(sorted.begin(), sorted.end(), lower - m_longestInterval[group]);
+		auto last = std::upper_bound(first, sorted.end(), upper);
+		for (auto it = first; it != last; ++it)
+		{
+			const ProxyId proxy = order[it - sorted.begin()];
+			if (m_proxies[proxy].alive && !m_proxies[proxy].moved && !visit(proxy))
+				return;
+		}
+	}
+	for (ProxyId proxy : m_movedSinceSort)
+	{
+		if (m_proxies[proxy].alive && !visit(proxy))
+			return;
+	}
+}
+
+void SweepAndPrune::query(const AABB& bounds, QueryCallback callback, void* context) const
+{
+	visitCandidates(bounds.min[m_axis], bounds.max[m_axis], [&](ProxyId proxy)
+		{
+			return !m_proxies[proxy].bounds.Overlaps(bounds) || callback(context, proxy);
+		});
+}
+
+void SweepAndPrune::rayCast(const PhysicsVec3& origin, const PhysicsVec3& delta, RayCastCallback callback, void* context) const
+{
+	const PhysicsVec3 inverseDelta = inverse(delta);
+	PhysicsReal maxFraction = 1.0;
+	const PhysicsReal end = origin[m_axis] + delta[m_axis];
+	visitCandidates(std::min(origin[m_axis], end), std::max(origin[m_axis], end), [&](ProxyId proxy)
+		{
+			if (m_proxies[proxy].bounds.RayOverlaps(origin, inverseDelta, maxFraction))
+				maxFraction = std::min(maxFraction, callback(context, proxy, maxFraction));
+			return maxFraction > 0.0;
+		});
+}
+#pragma endregion
+
+// ****** Sorting ****** //
+#pragma region Sorting
+int SweepAndPrune::chooseAxis() const
+{
+	PhysicsVec3 sum(0.0);
+	PhysicsVec3 sumSquares(0.0);
+	size_t count = 0;
+	for (const std::vector<ProxyId>& order : m_orders)
+	{
+		for (ProxyId proxy : order)
+		{
+			PhysicsVec3 center = (m_proxies[proxy].bounds.min + m_proxies[proxy].bounds.max) * PhysicsReal(0.5);
+			sum += center;
+			sumSquares += center * center;
+		}
+		count += order.size();
+	}
+	if (count < 2)
+		return m_axis;
+	PhysicsVec3 variance = sumSquares - sum * sum / static_cast<PhysicsReal>(count);
+
+	// Only switch for a clear winner, flipping between two close axes would force a full sort every call
+	int axis = m_axis;
+	for (int candidate = 0; candidate < 3; ++candidate)
+	{
+		if (variance[candidate] > variance[axis] * 1.5)
+			axis = candidate;
+	}
+	return axis;
+}
+
+void SweepAndPrune::sort(bool full)
+{
+	m_addedProxies = 0;
+	auto lowerBound = [this](ProxyId proxy) { return m_proxies[proxy].bounds.min[m_axis]; };
+
+	for (std::vector<ProxyId>& order : m_orders)
+	{
+		if (full)
+		{
+			std::sort(order.begin(), order.end(), [&](ProxyId a, ProxyId b) { return lowerBound(a) < lowerBound(b); });
+			continue;
+		}
+
+		for (size_t i = 1; i < order.size(); ++i)
+		{
+			ProxyId proxy = order[i];
+			PhysicsReal key = lowerBound(proxy);
+			size_t j = i;
+			while (j > 0 && lowerBound(order[j - 1]) > key)
+			{
+				order[j] = order[j - 1];
+				--j;
+			}
+			order[j] = proxy;
+		}
+	}
+}
+
+void SweepAndPrune::snapshot()
+{
+	m_sortedLower.resize(m_orders.size());
+	m_longestInterval.assign(m_orders.size(), PhysicsReal(0));
+	for (GroupId group = 0; group < m_orders.size(); ++group)
+	{
+		std::vector<PhysicsReal>& sorted = m_sortedLower[group];
+		sorted.clear();
+		for (ProxyId proxy : m_orders[group])
+		{
+			const AABB& bounds = m_proxies[proxy].bounds;
+			sorted.push_back(bounds.min[m_axis]);
+			m_longestInterval[group] = std::max(m_longestInterval[group], bounds.max[m_axis] - bounds.min[m_axis]);
+		}
+	}
+
+	for (ProxyId proxy : m_movedSinceSort)
+		m_proxies[proxy].moved = false;
+	m_movedSinceSort.clear();
+}
+#pragma endregion
+
+// ****** Sweeping ****** //
+#pragma region Sweeping
+void SweepAndPrune::sweep(const std::vector<ProxyId>& order, std::vector<Pair>& pairs)
+{
+	// Everything starting before the end of a proxy's interval on the axis may overlap it
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		const AABB& bounds = m_proxies[order[i]].bounds;
+		for (size_t j = i + 1; j < order.size(); ++j)
+		{
+			const AABB& other = m_proxies[order[j]].bounds;
+			if (other.min[m_axis] > bounds.max[m_axis])
+				break;
+			++m_stats.boundsTests;
+			if (overlapsOffAxis(bounds, other))
+				pairs.emplace_back(std::min(order[i], order[j]), std::max(order[i], order[j]));
+		}
+	}
+}
+
+void SweepAndPrune::sweep(const std::vector<ProxyId>& order1, const std::vector<ProxyId>& order2, std::vector<Pair>& pairs)
+{
+	// Walks both orders as if merged. Each proxy is tested against the proxies of the other group that
+	// start within its interval, ties going to the first group so no pair is tested twice
+	size_t i = 0;
+	size_t j = 0;
+	while (i < order1.size() && j < order2.size())
+	{
+		const bool first = m_proxies[order1[i]].bounds.min[m_axis] <= m_proxies[order2[j]].bounds.min[m_axis];
+		const ProxyId proxy = first ? order1[i++] : order2[j++];
+		const std::vector<ProxyId>& others = first ? order2 : order1;
+		const AABB& bounds = m_proxies[proxy].bounds;
+		for (size_t k = first ? j : i; k < others.size(); ++k)
+		{
+			const AABB& other = m_proxies[others[k]].bounds;
+			if (other.min[m_axis] > bounds.max[m_axis])
+				break;
+			++m_stats.boundsTests;
+			if (overlapsOffAxis(bounds, other))
+				pairs.emplace_back(std::min(proxy, others[k]), std::max(proxy, others[k]));
+		}
+	}
+}
+#pragma endregion
@@ -0,0 +1,74 @@
+#pragma once
+
+// Sort and sweep along one axis. Proxies are kept sorted by the lower bound of their box on the
+// axis where the colliders are most spread out, the sweep then only tests proxies whose
+// intervals overlap on it. Between frames the order barely changes, so an insertion sort
+// restores it in close to linear time. The axis is re-chosen every call, and a change of axis
+// or a burst of new proxies falls back to a full sort. Each group is sorted on its own, and two
+// groups that can pair are swept against each other as one merged order
+class SweepAndPrune : public Broadphase
+{
+public:
+	inline BroadphaseType GetType() const override { return BroadphaseType::SWEEP_AND_PRUNE; }
+	ProxyId CreateProxy(const AABB& bounds, void* userData, GroupId group) override;
+	void DestroyProxy(ProxyId proxy) override;
+	void MoveProxy(ProxyId proxy, const AABB& bounds) override;
+	void FindPairs(std::vector<Pair>& pairs) override;
+	inline void* GetUserData(ProxyId proxy) const override { return m_proxies[proxy].userData; }
+
+protected:
+	void query(const AABB& bounds, QueryCallback callback, void* context) const override;
+	void rayCast(const PhysicsVec3& origin, const PhysicsVec3& delta, RayCastCallback callback, void* context) const override;
+
+private:
+	struct Proxy
+	{
+		AABB bounds;
+		void* userData = nullptr;
+		GroupId group = 0;
+		bool alive = false;
+		bool moved = false;		// created or moved since the last sort, so its place in the order is stale
+	};
+
+	//@brief Picks the axis along which the centers of the proxies vary most
+	int chooseAxis() const;
+
+	//@brief Restores the order of every group along m_axis
+	void sort(bool full);
+
+	//@brief Records the lower bounds and the longest interval of every group as sorted, for the queries
+	void snapshot();
+
+	//@brief Calls visit for every proxy that may overlap [lower, upper] on m_axis: the ones sorted in
+	// range and the ones moved since
+	template <typename Visit>
+	void visitCandidates(PhysicsReal lower, PhysicsReal upper, Visit&& visit) const;
+
+	//@brief Adds the overlapping pairs within one group
+	void sweep(const std::vector<ProxyId>& order, std::vector<Pair>& pairs);
+
+	//@brief Adds the overlapping pairs with one proxy from each of two groups
+	void sweep(const std::vector<ProxyId>& order1, const std::vector<ProxyId>& order2, std::vector<Pair>& pairs);
+
+	//@brief Returns whether two boxes that overlap on m_axis overlap on the other two
+	inline bool overlapsOffAxis(const AABB& bounds1, const AABB& bounds2) const
+	{
+		const int axis1 = (m_axis + 1) % 3;
+		const int axis2 = (m_axis + 2) % 3;
+		return bounds1.min[axis1] <= bounds2.max[axis1] && bounds2.min[axis1] <= bounds1.max[axis1]
+			&& bounds1.min[axis2] <= bounds2.max[axis2] && bounds2.min[axis2] <= bounds1.max[axis2];
+	}
+
+	std::vector<Proxy> m_proxies;
+	std::vector<ProxyId> m_freeProxies;
+	std::vector<std::vector<ProxyId>> m_orders;	// live proxies of each group by lower bound on m_axis, dead ones until the next FindPairs
+	int m_axis = 0;
+	uint32_t m_addedProxies = 0;	// appended to the orders since the last sort
+	std::vector<ProxyId> m_destroyedProxies;	// freed once FindPairs has dropped them from the order
+	uint32_t m_movedProxies = 0;
+	// Per group as of the last sort: lower bound on m_axis of each proxy of the order, and the longest
+	// interval. Queries search them, proxies moved since are checked one by one from m_movedSinceSort
+	std::vector<std::vector<PhysicsReal>> m_sortedLower;
+	std::vector<PhysicsReal> m_longestInterval;
+	std::vector<ProxyId> m_movedSinceSort;
+};
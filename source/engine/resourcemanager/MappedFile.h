@@ -0,0 +1,35 @@
+#pragma once
+
+// Read-only view of a whole file mapped into memory. Pages are loaded by the OS on first
+// touch, so opening is cheap however large the file is and nothing is copied
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	//@brief Maps a file, unmapping the previous one
+	//@param path : Path of the file
+	//@return bool : Whether the file could be mapped, empty files cannot
+	bool Open(const std::string& path);
+
+	//@brief Unmaps the file
+	void Close();
+
+	//@brief Returns whether a file is mapped
+	inline bool IsOpen() const { return m_data != nullptr; }
+
+	//@brief Returns the bytes of the file
+	inline std::span<const std::byte> GetBytes() const { return { m_data, m_size }; }
+
+private:
+	const std::byte* m_data = nullptr;
+	size_t m_size = 0;
+#ifdef _WIN32
+	void* m_file = nullptr;		// HANDLE of the file
+	void* m_mapping = nullptr;	// HANDLE of the file mapping
+#endif
+};
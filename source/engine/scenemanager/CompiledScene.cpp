@@ -0,0 +1,590 @@
+#include "../pch.h"
+#include "CompiledScene.h"
+#include "TransformComponent.h"
+#include "RenderComponent.h"
+#include "../physics/PhysicsComponent.h"
+#include "../physics/CollisionComponent.h"
+#include "../ControllerComponent.h"
+#include "../ScriptComponent.h"
+
+template <typename T>
+static IHasGettersSetters* attachComponent(GameObject* owner)
+{
+	return owner->AddComponent<T>();
+}
+
+template <typename T>
+static IHasGettersSetters* newShape(GameObject*)
+{
+	return new T();
+}
+
+template <typename T>
+static const T& readValue(const std::byte* value)
+{
+	return *reinterpret_cast<const T*>(value);
+}
+
+static size_t valueSize(CompiledScene::ValueType type)
+{
+	using ValueType = CompiledScene::ValueType;
+	switch (type)
+	{
+	case ValueType::INT:		return sizeof(int32_t);
+	case ValueType::FLOAT:		return sizeof(float);
+	case ValueType::DOUBLE:		return sizeof(double);
+	case ValueType::BOOL:		return sizeof(uint8_t);
+	case ValueType::STRING:		return 2 * sizeof(uint32_t);
+	case ValueType::VEC2:		return sizeof(glm::vec2);
+	case ValueType::VEC3:		return sizeof(glm::vec3);
+	case ValueType::DVEC3:		return sizeof(glm::dvec3);
+	case ValueType::VEC4:		return sizeof(glm::vec4);
+	case ValueType::UV_TYPE:	return sizeof(int32_t);
+	case ValueType::SHAPE:		return 3 * sizeof(uint32_t);
+	}
+	return 0;
+}
+
+static const CompiledScene::TypeBinding* findType(std::string_view name, CompiledScene::TypeKind kind)
+{
+	for (const CompiledScene::TypeBinding& type : CompiledScene::GetBindings())
+	{
+		if (type.name == name && type.kind == kind)
+			return &type;
+	}
+	return nullptr;
+}
+
+// The value types follow the type names of the json loader's dictionary
+static bool findValueType(std::string_view typeName, CompiledScene::ValueType& type)
+{
+	using ValueType = CompiledScene::ValueType;
+	auto name2type = GameObjectTypeDictionary::typeStore.find(typeName);
+	if (name2type == GameObjectTypeDictionary::typeStore.end())
+		return false;
+
+	type = std::visit([](auto&& value) {
+		using T = std::decay_t<decltype(value)>;
+		if constexpr (std::is_same_v<T, int>)					return ValueType::INT;
+		else if constexpr (std::is_same_v<T, float>)			return ValueType::FLOAT;
+		else if constexpr (std::is_same_v<T, double>)			return ValueType::DOUBLE;
+		else if constexpr (std::is_same_v<T, bool>)				return ValueType::BOOL;
+		else if constexpr (std::is_same_v<T, std::string>)		return ValueType::STRING;
+		else if constexpr (std::is_same_v<T, glm::vec2>)		return ValueType::VEC2;
+		else if constexpr (std::is_same_v<T, glm::vec3>)		return ValueType::VEC3;
+		else if constexpr (std::is_same_v<T, glm::dvec3>)		return ValueType::DVEC3;
+		else if constexpr (std::is_same_v<T, glm::vec4>)		return ValueType::VEC4;
+		else if constexpr (std::is_same_v<T, UV_TYPE>)			return ValueType::UV_TYPE;
+		else													return ValueType::SHAPE;
+		}, name2type->second);
+	return true;
+}
+
+// ****** Bindings ****** //
+#pragma region Bindings
+std::span<const CompiledScene::TypeBinding> CompiledScene::GetBindings()
+{
+	// Same classes as GameObjectFactory creates, their properties are the setters they define
+	static const TypeBinding types[] =
+	{
+		{ GameObjectSystemComponentConstants::TRANSFORM_COMPONENT, TypeKind::COMPONENT, &attachComponent<TransformComponent> },
+		{ GameObjectSystemComponentConstants::RENDER_COMPONENT, TypeKind::COMPONENT, &attachComponent<RenderComponent> },
+		{ GameObjectSystemComponentConstants::PHYSICS_COMPONENT, TypeKind::COMPONENT, &attachComponent<PhysicsComponent> },
+		{ GameObjectSystemComponentConstants::COLLISION_COMPONENT, TypeKind::COMPONENT, &attachComponent<CollisionComponent> },
+		{ GameObjectSystemComponentConstants::CONTROLLER_COMPONENT, TypeKind::COMPONENT, &attachComponent<ControllerComponent> },
+		{ GameObjectSystemComponentConstants::SCRIPT_COMPONENT, TypeKind::COMPONENT, &attachComponent<ScriptComponent> },
+		{ CollisionShapeConstants::SPHERE, TypeKind::SHAPE, &newShape<CollisionShape_Sphere> },
+		{ CollisionShapeConstants::CUBOID, TypeKind::SHAPE, &newShape<CollisionShape_Cuboid> },
+	};
+	return types;
+}
+#pragma endregion
+
+// ****** Compiling ****** //
+#pragma region Compiling
+// Accumulates the tables of a compiled scene, then lays them out in one file
+class CompiledScene::Writer
+{
+public:
+	//@brief Appends the game objects and, after each one, its children depth first
+	void AddObjects(const rapidjson::Value& gameObjects, int32_t parent)
+	{
+		for (auto& gameObject : gameObjects.GetObject())
+		{
+			const int32_t index = static_cast<int32_t>(m_objects.size());
+			m_objects.push_back({ addString(gameObject.name.GetString()), parent, static_cast<uint32_t>(m_components.size()), 0 });
+
+			auto components = gameObject.value.FindMember("Components");
+			if (components != gameObject.value.MemberEnd() && components->value.IsObject())
+			{
+				// Nested shapes only add properties, so the components of an object stay contiguous
+				for (auto& component : components->value.GetObject())
+				{
+					const std::string_view typeName = component.name.GetString();
+					const TypeBinding* type = findType(typeName, TypeKind::COMPONENT);
+					if (!type)
+					{
+						std::cerr << "Unknown component type: " << typeName << std::endl;
+						continue;
+					}
+					m_components.push_back(addInstance(*type, component.value));
+					++m_objects[index].componentCount;
+				}
+			}
+
+			auto children = gameObject.value.FindMember("Children");
+			if (children != gameObject.value.MemberEnd() && children->value.IsObject())
+				AddObjects(children->value, index);
+		}
+	}
+
+	//@brief Writes the file
+	//@return bool : Whether the file could be written
+	bool Save(const std::string& path) const
+	{
+		Header header{};
+		header.magic = MAGIC;
+		header.version = VERSION;
+		header.typeCount = static_cast<uint32_t>(m_types.size());
+		header.keyCount = static_cast<uint32_t>(m_keys.size());
+		header.objectCount = static_cast<uint32_t>(m_objects.size());
+		header.componentCount = static_cast<uint32_t>(m_components.size());
+		header.propertyCount = static_cast<uint32_t>(m_properties.size());
+
+		uint64_t size = sizeof(Header);
+		auto place = [&size](uint64_t bytes) { const uint64_t offset = align(size); size = offset + bytes; return offset; };
+		header.typeOffset = place(m_types.size() * sizeof(TypeRecord));
+		header.keyOffset = place(m_keys.size() * sizeof(KeyRecord));
+		header.objectOffset = place(m_objects.size() * sizeof(ObjectRecord));
+		header.componentOffset = place(m_components.size() * sizeof(InstanceRecord));
+		header.propertyOffset = place(m_properties.size() * sizeof(PropertyRecord));
+		header.valueSize = m_values.size();
+		header.valueOffset = place(header.valueSize);
+		header.stringSize = m_strings.size();
+		header.stringOffset = place(header.stringSize);
+
+		std::vector<std::byte> file(size);
+		auto copy = [&file](uint64_t offset, const void* data, size_t bytes) { if (bytes) std::memcpy(file.data() + offset, data, bytes); };
+		copy(0, &header, sizeof(Header));
+		copy(header.typeOffset, m_types.data(), m_types.size() * sizeof(TypeRecord));
+		copy(header.keyOffset, m_keys.data(), m_keys.size() * sizeof(KeyRecord));
+		copy(header.objectOffset, m_objects.data(), m_objects.size() * sizeof(ObjectRecord));
+		copy(header.componentOffset, m_components.data(), m_components.size() * sizeof(InstanceRecord));
+		copy(header.propertyOffset, m_properties.data(), m_properties.size() * sizeof(PropertyRecord));
+		copy(header.valueOffset, m_values.data(), m_values.size());
+		copy(header.stringOffset, m_strings.data(), m_strings.size());
+
+		std::ofstream outFile(path, std::ios::binary | std::ios::trunc);
+		if (!outFile)
+			return false;
+		outFile.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+		return static_cast<bool>(outFile);
+	}
+
+private:
+	static constexpr uint64_t ALIGNMENT = 8;
+
+	static uint64_t align(uint64_t offset) { return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+	//@brief Returns the string in the blob, adding it once
+	StringRef addString(std::string_view string)
+	{
+		auto it = m_stringRefs.find(std::string(string));
+		if (it != m_stringRefs.end())
+			return it->second;
+
+		StringRef ref{ static_cast<uint32_t>(m_strings.size()), static_cast<uint32_t>(string.size()) };
+		m_strings.insert(m_strings.end(), string.begin(), string.end());
+		m_strings.push_back('\0');
+		m_stringRefs.emplace(std::string(string), ref);
+		return ref;
+	}
+
+	uint32_t addType(const TypeBinding& type)
+	{
+		auto [it, added] = m_typeIndices.try_emplace(&type, static_cast<uint32_t>(m_types.size()));
+		if (added)
+			m_types.push_back({ addString(type.name), type.kind });
+		return it->second;
+	}
+
+	uint32_t addKey(uint32_t type, std::string_view name, ValueType valueType)
+	{
+		auto [it, added] = m_keyIndices.try_emplace({ type, std::string(name), valueType }, static_cast<uint32_t>(m_keys.size()));
+		if (added)
+			m_keys.push_back({ addString(name), type, valueType });
+		return it->second;
+	}
+
+	template <typename T>
+	uint32_t addValue(const T& value)
+	{
+		const size_t offset = align(m_values.size());
+		m_values.resize(offset + sizeof(T));
+		std::memcpy(m_values.data() + offset, &value, sizeof(T));
+		return static_cast<uint32_t>(offset);
+	}
+
+	template <glm::length_t L, typename T>
+	static bool readVector(const rapidjson::Value& json, glm::vec<L, T>& vector)
+	{
+		if (!json.IsArray() || json.Size() != L)
+			return false;
+		for (glm::length_t i = 0; i < L; ++i)
+		{
+			if (!json[i].IsNumber())
+				return false;
+			vector[i] = static_cast<T>(json[i].GetDouble());
+		}
+		return true;
+	}
+
+	template <glm::length_t L, typename T>
+	bool addVector(const rapidjson::Value& json, uint32_t& offset)
+	{
+		glm::vec<L, T> vector;
+		if (!readVector(json, vector))
+			return false;
+		offset = addValue(vector);
+		return true;
+	}
+
+	//@brief Stores a json value in the layout of the property, numbers are converted to the property's type
+	//@return bool : Whether the json value fits the property
+	bool addProperty(ValueType type, const rapidjson::Value& json, uint32_t& offset)
+	{
+		switch (type)
+		{
+		case ValueType::INT:
+		case ValueType::UV_TYPE:
+			if (!json.IsInt())
+				return false;
+			offset = addValue(static_cast<int32_t>(json.GetInt()));
+			return true;
+		case ValueType::FLOAT:
+			if (!json.IsNumber())
+				return false;
+			offset = addValue(json.GetFloat());
+			return true;
+		case ValueType::DOUBLE:
+			if (!json.IsNumber())
+				return false;
+			offset = addValue(json.GetDouble());
+			return true;
+		case ValueType::BOOL:
+			if (!json.IsBool())
+				return false;
+			offset = addValue(static_cast<uint8_t>(json.GetBool()));
+			return true;
+		case ValueType::STRING:
+			if (!json.IsString())
+				return false;
+			offset = addValue(addString({ json.GetString(), json.GetStringLength() }));
+			return true;
+		case ValueType::VEC2:	return addVector<2, float>(json, offset);
+		case ValueType::VEC3:	return addVector<3, float>(json, offset);
+		case ValueType::DVEC3:	return addVector<3, double>(json, offset);
+		case ValueType::VEC4:	return addVector<4, float>(json, offset);
+		case ValueType::SHAPE:
+		{
+			if (!json.IsObject())
+				return false;
+			auto shapeType = json.FindMember("shapeType");
+			if (shapeType == json.MemberEnd() || !shapeType->value.IsArray() || shapeType->value.Size() < 2 || !shapeType->value[1].IsString())
+				return false;
+
+			const std::string_view typeName = shapeType->value[1].GetString();
+			const TypeBinding* type = findType(typeName, TypeKind::SHAPE);
+			if (!type)
+			{
+				std::cerr << "Unknown collision shape type: " << typeName << std::endl;
+				return false;
+			}
+			offset = addValue(addInstance(*type, json));
+			return true;
+		}
+		}
+		return false;
+	}
+
+	//@brief Stores the properties of a component or shape and returns its record
+	InstanceRecord addInstance(const TypeBinding& type, const rapidjson::Value& properties)
+	{
+		const uint32_t typeIndex = addType(type);
+
+		// Values first: a nested shape appends its own properties, which must not land between ours
+		std::vector<PropertyRecord> records;
+		for (auto& member : properties.GetObject())
+		{
+			const std::string_view name = member.name.GetString();
+			if (type.kind == TypeKind::SHAPE && name == "shapeType")
+				continue;
+
+			// Properties are stored as [type name, value]
+			ValueType valueType;
+			uint32_t offset = 0;
+			if (!member.value.IsArray() || member.value.Size() < 2 || !member.value[0].IsString()
+				|| !findValueType(member.value[0].GetString(), valueType) || !addProperty(valueType, member.value[1], offset))
+			{
+				std::cerr << "Skipping malformed property " << name << " of " << type.name << std::endl;
+				continue;
+			}
+			records.push_back({ addKey(typeIndex, name, valueType), offset });
+		}
+
+		InstanceRecord instance{ typeIndex, static_cast<uint32_t>(m_properties.size()), static_cast<uint32_t>(records.size()) };
+		m_properties.insert(m_properties.end(), records.begin(), records.end());
+		return instance;
+	}
+
+	std::vector<TypeRecord> m_types;
+	std::vector<KeyRecord> m_keys;
+	std::vector<ObjectRecord> m_objects;
+	std::vector<InstanceRecord> m_components;
+	std::vector<PropertyRecord> m_properties;
+	std::vector<std::byte> m_values;
+	std::vector<char> m_strings;
+
+	std::unordered_map<const TypeBinding*, uint32_t> m_typeIndices;
+	std::map<std::tuple<uint32_t, std::string, ValueType>, uint32_t> m_keyIndices;
+	std::unordered_map<std::string, StringRef> m_stringRefs;
+};
+
+std::string CompiledScene::GetCompiledPath(const std::string& sceneSource)
+{
+	return std::filesystem::path(sceneSource).replace_extension(EXTENSION).string();
+}
+
+bool CompiledScene::IsStale(const std::string& sceneSource)
+{
+	std::error_code error;
+	const std::filesystem::path compiledPath = GetCompiledPath(sceneSource);
+	if (!std::filesystem::exists(compiledPath, error))
+		return true;
+	if (!std::filesystem::exists(sceneSource, error))
+		return false;
+	return std::filesystem::last_write_time(sceneSource, error) > std::filesystem::last_write_time(compiledPath, error);
+}
+
+bool CompiledScene::Compile(const std::string& sceneSource)
+{
+	FILE* fp;
+	fopen_s(&fp, sceneSource.c_str(), "rb");
+	if (!fp)
+	{
+		std::cerr << "Failed to load data source " << sceneSource << std::endl;
+		return false;
+	}
+
+	char readBuffer[8192];
+	rapidjson::FileReadStream inputStream(fp, readBuffer, sizeof(readBuffer));
+
+	rapidjson::Document sceneDoc;
+	sceneDoc.ParseStream(inputStream);
+	fclose(fp);
+
+	const std::string compiledPath = GetCompiledPath(sceneSource);
+	if (!sceneDoc.HasParseError() && sceneDoc.IsObject() && sceneDoc.MemberCount() > 0)
+	{
+		const rapidjson::Value& sceneData = sceneDoc.MemberBegin()->value;
+		if (sceneData.IsObject())
+		{
+			auto gameObjects = sceneData.FindMember("GameObject");
+			if (gameObjects != sceneData.MemberEnd() && gameObjects->value.IsObject() && !gameObjects->value.ObjectEmpty())
+				return Compile(gameObjects->value, compiledPath);
+		}
+	}
+	else if (sceneDoc.HasParseError())
+		std::cerr << "Error parsing the scene json file " << sceneSource << std::endl;
+
+	// Nothing worth compiling, make sure an outdated binary does not shadow the json
+	std::error_code error;
+	std::filesystem::remove(compiledPath, error);
+	return false;
+}
+
+bool CompiledScene::Compile(const rapidjson::Value& gameObjects, const std::string& compiledPath)
+{
+	Writer writer;
+	writer.AddObjects(gameObjects, -1);
+	if (!writer.Save(compiledPath))
+	{
+		std::cerr << "Failed to write the compiled scene " << compiledPath << std::endl;
+		return false;
+	}
+	return true;
+}
+#pragma endregion
+
+// ****** Loading ****** //
+#pragma region Loading
+bool CompiledScene::Open(const std::string& compiledPath)
+{
+	Close();
+	if (!m_file.Open(compiledPath))
+		return false;
+
+	// Every record is checked once here so loading can index the tables blindly
+	const std::span<const std::byte> bytes = m_file.GetBytes();
+	const std::byte* base = bytes.data();
+	const Header* header = table<Header>(base, 0);
+	auto fits = [&bytes](uint64_t offset, uint64_t count, uint64_t size)
+	{
+		return offset % alignof(uint64_t) == 0 && offset <= bytes.size() && count <= (bytes.size() - offset) / size;
+	};
+	bool valid = bytes.size() >= sizeof(Header) && header->magic == MAGIC && header->version == VERSION
+		&& fits(header->typeOffset, header->typeCount, sizeof(TypeRecord))
+		&& fits(header->keyOffset, header->keyCount, sizeof(KeyRecord))
+		&& fits(header->objectOffset, header->objectCount, sizeof(ObjectRecord))
+		&& fits(header->componentOffset, header->componentCount, sizeof(InstanceRecord))
+		&& fits(header->propertyOffset, header->propertyCount, sizeof(PropertyRecord))
+		&& fits(header->valueOffset, header->valueSize, 1)
+		&& fits(header->stringOffset, header->stringSize, 1);
+	if (!valid)
+	{
+		std::cerr << "Compiled scene " << compiledPath << " is not a version " << VERSION << " scene" << std::endl;
+		Close();
+		return false;
+	}
+
+	m_header = header;
+	m_objects = table<ObjectRecord>(base, header->objectOffset);
+	m_components = table<InstanceRecord>(base, header->componentOffset);
+	m_properties = table<PropertyRecord>(base, header->propertyOffset);
+	m_values = base + header->valueOffset;
+	m_strings = table<char>(base, header->stringOffset);
+
+	auto validString = [header](StringRef string) { return uint64_t(string.offset) + string.length < header->stringSize; };
+	auto validInstance = [header](const InstanceRecord& instance, uint32_t typeCount)
+	{
+		return instance.type < typeCount && uint64_t(instance.firstProperty) + instance.propertyCount <= header->propertyCount;
+	};
+
+	// Types and keys are matched against the bindings by name, a rename invalidates the file
+	const TypeRecord* types = table<TypeRecord>(base, header->typeOffset);
+	for (uint32_t i = 0; valid && i < header->typeCount; ++i)
+	{
+		const TypeBinding* binding = validString(types[i].name) ? findType(getString(types[i].name), types[i].kind) : nullptr;
+		m_types.push_back(binding);
+		valid = binding != nullptr;
+	}
+	// Keys are matched against the setters when applied, a property that lost its setter is skipped
+	m_keys = table<KeyRecord>(base, header->keyOffset);
+	for (uint32_t i = 0; valid && i < header->keyCount; ++i)
+	{
+		const KeyRecord& key = m_keys[i];
+		valid = key.type < header->typeCount && validString(key.name) && key.valueType <= ValueType::SHAPE;
+		if (valid)
+			m_keyNames.emplace_back(getString(key.name));
+	}
+
+	for (uint32_t i = 0; valid && i < header->objectCount; ++i)
+	{
+		const ObjectRecord& object = m_objects[i];
+		valid = validString(object.name) && object.parent >= -1 && object.parent < static_cast<int32_t>(i)
+			&& uint64_t(object.firstComponent) + object.componentCount <= header->componentCount;
+	}
+	for (uint32_t i = 0; valid && i < header->componentCount; ++i)
+		valid = validInstance(m_components[i], header->typeCount) && m_types[m_components[i].type]->kind == TypeKind::COMPONENT;
+	for (uint32_t i = 0; valid && i < header->propertyCount; ++i)
+	{
+		const PropertyRecord& property = m_properties[i];
+		valid = property.key < header->keyCount && property.value % alignof(uint64_t) == 0
+			&& uint64_t(property.value) + valueSize(m_keys[property.key].valueType) <= header->valueSize;
+		if (!valid)
+			break;
+
+		const std::byte* value = m_values + property.value;
+		if (m_keys[property.key].valueType == ValueType::STRING)
+			valid = validString(readValue<StringRef>(value));
+		else if (m_keys[property.key].valueType == ValueType::SHAPE)
+		{
+			// Shapes are written before the properties of the component holding them, so they cannot nest
+			const InstanceRecord& shape = readValue<InstanceRecord>(value);
+			valid = validInstance(shape, header->typeCount) && m_types[shape.type]->kind == TypeKind::SHAPE
+				&& shape.firstProperty + shape.propertyCount <= i;
+		}
+	}
+
+	if (!valid)
+	{
+		std::cerr << "Compiled scene " << compiledPath << " does not match this build, recompile it" << std::endl;
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void CompiledScene::Close()
+{
+	m_file.Close();
+	m_header = nullptr;
+	m_objects = nullptr;
+	m_components = nullptr;
+	m_properties = nullptr;
+	m_values = nullptr;
+	m_strings = nullptr;
+	m_types.clear();
+	m_keys = nullptr;
+	m_keyNames.clear();
+}
+
+std::string_view CompiledScene::GetObjectName(uint32_t object) const
+{
+	return getString(m_objects[object].name);
+}
+
+void CompiledScene::AttachComponents(uint32_t object, GameObject* gameObject) const
+{
+	const ObjectRecord& record = m_objects[object];
+	for (uint32_t i = record.firstComponent; i < record.firstComponent + record.componentCount; ++i)
+		instantiate(m_components[i], gameObject);
+}
+
+IHasGettersSetters* CompiledScene::instantiate(const InstanceRecord& instance, GameObject* owner) const
+{
+	IHasGettersSetters* target = m_types[instance.type]->create(owner);
+	const auto& setters = target->GetSetters();
+	for (uint32_t i = instance.firstProperty; i < instance.firstProperty + instance.propertyCount; ++i)
+	{
+		const PropertyRecord& property = m_properties[i];
+		auto setter = setters.find(m_keyNames[property.key]);
+		if (setter == setters.end())
+		{
+			std::cerr << "Skipping unknown property " << m_keyNames[property.key] << " of " << m_types[instance.type]->name << std::endl;
+			continue;
+		}
+		setter->second(readProperty(m_keys[property.key].valueType, m_values + property.value));
+	}
+	return target;
+}
+
+std::any CompiledScene::readProperty(ValueType type, const std::byte* value) const
+{
+	switch (type)
+	{
+	case ValueType::INT:		return static_cast<int>(readValue<int32_t>(value));
+	case ValueType::FLOAT:		return readValue<float>(value);
+	case ValueType::DOUBLE:		return readValue<double>(value);
+	case ValueType::BOOL:		return readValue<uint8_t>(value) != 0;
+	case ValueType::STRING:		return std::string(getString(readValue<StringRef>(value)));
+	case ValueType::VEC2:		return readValue<glm::vec2>(value);
+	case ValueType::VEC3:		return readValue<glm::vec3>(value);
+	case ValueType::DVEC3:		return readValue<glm::dvec3>(value);
+	case ValueType::VEC4:		return readValue<glm::vec4>(value);
+	case ValueType::UV_TYPE:	return static_cast<UV_TYPE>(readValue<int32_t>(value));
+	case ValueType::SHAPE:		return createShape(value);
+	}
+	return {};
+}
+
+std::string_view CompiledScene::getString(StringRef string) const
+{
+	return { m_strings + string.offset, string.length };
+}
+
+CollisionShape* CompiledScene::createShape(const std::byte* value) const
+{
+	return static_cast<CollisionShape*>(instantiate(readValue<InstanceRecord>(value), nullptr));
+}
+#pragma endregion
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "../resourcemanager/MappedFile.h"
+
+// Binary form of a scene json, produced by Compile and memory-mapped by Open. The file is a
+// header followed by flat tables of fixed-size records, a blob of property values and a blob
+// of strings, every table addressed by an offset from the start of the file:
+//
+//   types       component and collision shape classes used by the scene
+//   keys        (type, property, value type) triples, the value type taken from the json's type name
+//   objects     game objects in spawn order (parents first, document order)
+//   components  component records, contiguous per object
+//   properties  (key, value offset) pairs, contiguous per component or collision shape
+//   values      property values in their in-memory layout, 8 byte aligned
+//   strings     names and string values, null terminated
+//
+// Loading reads values straight out of the mapping and hands them to the setters each class
+// registers in defineMember, the same ones the json loader calls, so nothing is parsed and a new
+// property needs no change here
+class CompiledScene
+{
+public:
+	static constexpr uint32_t MAGIC = 0x424E4353;	// "SCNB"
+	static constexpr uint32_t VERSION = 2;
+	static constexpr std::string_view EXTENSION = ".scnb";
+
+	// Layout of a property value in the value blob
+	enum class ValueType : uint32_t
+	{
+		INT,		// int32_t
+		FLOAT,		// float
+		DOUBLE,		// double
+		BOOL,		// uint8_t
+		STRING,		// StringRef
+		VEC2,		// glm::vec2
+		VEC3,		// glm::vec3
+		DVEC3,		// glm::dvec3
+		VEC4,		// glm::vec4
+		UV_TYPE,	// int32_t
+		SHAPE		// InstanceRecord of a collision shape
+	};
+
+	enum class TypeKind : uint32_t
+	{
+		COMPONENT,
+		SHAPE
+	};
+
+	// A component or collision shape class that can be stored in a compiled scene, its properties
+	// are the setters it defines
+	struct TypeBinding
+	{
+		std::string_view name;
+		TypeKind kind;
+		IHasGettersSetters* (*create)(GameObject* owner);	// Attaches a component to owner, or allocates a shape
+	};
+
+	//@brief Returns the path of the compiled scene next to a scene json
+	//@param sceneSource : Path of the scene json
+	static std::string GetCompiledPath(const std::string& sceneSource);
+
+	//@brief Returns whether the compiled scene is missing or older than its json
+	//@param sceneSource : Path of the scene json
+	static bool IsStale(const std::string& sceneSource);
+
+	//@brief Compiles a scene json into the binary next to it
+	//@param sceneSource : Path of the scene json
+	//@return bool : Whether a compiled scene was written, scenes without game objects are not compiled
+	static bool Compile(const std::string& sceneSource);
+
+	//@brief Compiles game objects into a binary file. Unknown components and value types are skipped with a warning,
+	// properties without a setter when the scene is loaded
+	//@param gameObjects : Json object of game objects, as found under "GameObject" in a scene file
+	//@param compiledPath : Path of the file to write
+	//@return bool : Whether the file was written
+	static bool Compile(const rapidjson::Value& gameObjects, const std::string& compiledPath);
+
+	//@brief Maps a compiled scene and resolves its types and keys against the bindings
+	//@param compiledPath : Path of the compiled scene
+	//@return bool : Whether the file is a compiled scene this build can load
+	bool Open(const std::string& compiledPath);
+
+	//@brief Unmaps the compiled scene
+	void Close();
+
+	//@brief Returns the number of game objects
+	inline uint32_t GetObjectCount() const { return m_header ? m_header->objectCount : 0; }
+
+	//@brief Returns the name of a game object
+	std::string_view GetObjectName(uint32_t object) const;
+
+	//@brief Returns the index of the parent of a game object, -1 for root objects
+	inline int32_t GetParent(uint32_t object) const { return m_objects[object].parent; }
+
+	//@brief Attaches the components of a game object and applies their properties. Main thread only,
+	// component constructors register with their managers
+	//@param object : Index of the game object
+	//@param gameObject : Game object to attach to
+	void AttachComponents(uint32_t object, GameObject* gameObject) const;
+
+	//@brief Returns the types the compiler and loader know about
+	static std::span<const TypeBinding> GetBindings();
+
+private:
+	struct StringRef
+	{
+		uint32_t offset;	// From the start of the string blob
+		uint32_t length;	// Without the null terminator
+	};
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t typeCount;
+		uint32_t keyCount;
+		uint32_t objectCount;
+		uint32_t componentCount;
+		uint32_t propertyCount;
+		uint32_t reserved;
+		uint64_t typeOffset;
+		uint64_t keyOffset;
+		uint64_t objectOffset;
+		uint64_t componentOffset;
+		uint64_t propertyOffset;
+		uint64_t valueOffset;
+		uint64_t valueSize;
+		uint64_t stringOffset;
+		uint64_t stringSize;
+	};
+
+	struct TypeRecord
+	{
+		StringRef name;
+		TypeKind kind;
+	};
+
+	struct KeyRecord
+	{
+		StringRef name;
+		uint32_t type;		// Index into the type table
+		ValueType valueType;
+	};
+
+	struct ObjectRecord
+	{
+		StringRef name;
+		int32_t parent;
+		uint32_t firstComponent;
+		uint32_t componentCount;
+	};
+
+	// A component, or a collision shape stored as a property value
+	struct InstanceRecord
+	{
+		uint32_t type;		// Index into the type table
+		uint32_t firstProperty;
+		uint32_t propertyCount;
+	};
+
+	struct PropertyRecord
+	{
+		uint32_t key;		// Index into the key table
+		uint32_t value;		// Offset from the start of the value blob
+	};
+
+	class Writer;
+
+	//@brief Creates an instance and applies its properties through its setters
+	//@return IHasGettersSetters* : The component or shape
+	IHasGettersSetters* instantiate(const InstanceRecord& instance, GameObject* owner) const;
+
+	//@brief Reads a property value into the type its setter casts to
+	//@param type : Layout of the value
+	//@param value : The value in the value blob
+	//@return std::any : The value, a new collision shape for SHAPE values
+	std::any readProperty(ValueType type, const std::byte* value) const;
+
+	//@brief Returns a string of the string blob
+	std::string_view getString(StringRef string) const;
+
+	//@brief Builds a collision shape stored as a property value, ownership goes to the caller
+	CollisionShape* createShape(const std::byte* value) const;
+
+	template <typename T>
+	static const T* table(const std::byte* base, uint64_t offset) { return reinterpret_cast<const T*>(base + offset); }
+
+	MappedFile m_file;
+	const Header* m_header = nullptr;
+	const ObjectRecord* m_objects = nullptr;
+	const InstanceRecord* m_components = nullptr;
+	const PropertyRecord* m_properties = nullptr;
+	const std::byte* m_values = nullptr;
+	const char* m_strings = nullptr;
+
+	// Bindings of the type table and setter names of the key table, resolved by Open
+	std::vector<const TypeBinding*> m_types;
+	const KeyRecord* m_keys = nullptr;
+	std::vector<std::string> m_keyNames;
+};
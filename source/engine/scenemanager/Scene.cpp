@@ -1,7 +1,12 @@
 #include "../pch.h"
 #include "../objectmanager/GameObjectFactory.h"
+#include "../objectmanager/GameObjectManager.h"
+#include "CompiledScene.h"
 #include "../resourcemanager/ResourceManager.h"
+#include "../physics/PhysicsManager.h"
 #include "../ui/UI.h"
+#include "RenderComponent.h"
+#include "../Camera.h"
 
 unsigned int quadVAO = 0;
 unsigned int quadVBO;
@@ -32,12 +37,68 @@ void renderQuad()
 	glBindVertexArray(0);
 }
 
+Scene::Scene() : m_nodeCount(0), m_broadphase(BroadphaseType::AABB_TREE), m_origin(0.0), m_pOriginFocus(nullptr),
+	m_originThreshold(DEFAULT_ORIGIN_THRESHOLD), m_refreshAllWorlds(true), m_hierarchyChanged(true)
+{
+}
+
 Scene::~Scene()
 {
 	Shutdown();
 }
 
 void Scene::Init()
+{
+	SERVICE_LOCATOR.GetCollisionManager()->SetBroadphase(m_broadphase);
+
+	// The compiled scene is used while it is up to date, the json is only parsed without one
+	CompiledScene compiled;
+	if (!CompiledScene::IsStale(m_sceneSource) && compiled.Open(CompiledScene::GetCompiledPath(m_sceneSource)))
+	{
+		SERVICE_LOCATOR.GetGameObjectFactory()->CreateAllGameObjects(compiled);
+		compiled.Close();
+		initNodes();
+	}
+	else if (!loadJson())
+		return;
+
+	// Light Setup
+	lightPosition = glm::vec3(0.0f, 9.0f, 0.0f);
+	lightSpecular = glm::vec3(1.0f);
+	lightDiffuse = glm::vec3(0.75f);
+	lightAmbient = lightDiffuse * glm::vec3(0.2f);
+	// Light Matrix
+	near_plane = 1.0f; far_plane = 20.0f;
+	glm::mat4 lightProjection = glm::perspective(90.0f, SHADOW_WIDTH / (float)SHADOW_HEIGHT, near_plane, far_plane);
+	//glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, near_plane, far_plane)
+	glm::mat4 lightView = glm::lookAt(lightPosition,
+		glm::vec3(0.0f, 0.0f, 0.0f),
+		glm::vec3(0.0f, 1.0f, 0.0f));
+	lightSpaceMatrix = lightProjection * lightView;
+
+	// FBO for shadow map setup
+	glGenFramebuffers(1, &depthMapFBO);
+	glGenTextures(1, &depthMap);
+	glBindTexture(GL_TEXTURE_2D, depthMap);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// attach depth texture as FBO's depth buffer
+	glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthMap, 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	Shader* shadowDebug = SERVICE_LOCATOR.GetResourceManager()->GetShader("ShadowDebug");
+	//shadowDebug->Use();
+	//shadowDebug->SetUniform("depthMap", 0);
+
+}
+
+bool Scene::loadJson()
 {
 	FILE* fp;
 	fopen_s(&fp, m_sceneSource.c_str(), "rb");
@@ -63,7 +124,7 @@ void Scene::Init()
 		const std::string sceneName = scene->name.GetString();
 		const rapidjson::Value& sceneData = scene->value;
 		if (sceneData.IsNull() || sceneData.ObjectEmpty())
-			return;
+			return false;
 
 		const rapidjson::Value& gameObjects = sceneData.FindMember("GameObject")->value;
 
@@ -85,77 +146,81 @@ void Scene::Init()
 			// Skybox loading should be done here
 		}
 		// TODO: Add the skybox to the scene
-		m_pSkybox = std::unique_ptr<Skybox>(new Skybox("../../content/art/skybox/NightSky.png"));
-		for (auto& node : m_nodes)
-			node->Init();
+		initNodes();
 	}
 	else
 		std::cerr << "Scene json file is empty" << std::endl;
 
-	// Light Setup
-	lightPosition = glm::vec3(0.0f, 9.0f, 0.0f);
-	lightSpecular = glm::vec3(1.0f);
-	lightDiffuse = glm::vec3(0.75f);
-	lightAmbient = lightDiffuse * glm::vec3(0.2f);
-	// Light Matrix
-	near_plane = 1.0f; far_plane = 20.0f;
-	glm::mat4 lightProjection = glm::perspective(90.0f, SHADOW_WIDTH / (float)SHADOW_HEIGHT, near_plane, far_plane);
-	//glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, near_plane, far_plane)
-	glm::mat4 lightView = glm::lookAt(lightPosition,
-		glm::vec3(0.0f, 0.0f, 0.0f),
-		glm::vec3(0.0f, 1.0f, 0.0f));
-	lightSpaceMatrix = lightProjection * lightView;
-
-	// FBO for shadow map setup
-	glGenFramebuffers(1, &depthMapFBO);
-	glGenTextures(1, &depthMap);
-	glBindTexture(GL_TEXTURE_2D, depthMap);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	// attach depth texture as FBO's depth buffer
-	glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthMap, 0);
-	glDrawBuffer(GL_NONE);
-	glReadBuffer(GL_NONE);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-	Shader* shadowDebug = SERVICE_LOCATOR.GetResourceManager()->GetShader("ShadowDebug");
-	//shadowDebug->Use();
-	//shadowDebug->SetUniform("depthMap", 0);
+	return true;
+}
 
+void Scene::initNodes()
+{
+	m_pSkybox = std::unique_ptr<Skybox>(new Skybox("../../content/art/skybox/NightSky.png"));
+	refreshHierarchy();
+	for (size_t i = 0; i < m_hierarchyNodes.size(); ++i)
+		m_hierarchyNodes[i]->Init();
 }
 
 void Scene::Update()
 {
-	for (auto& node : m_nodes)
-		node->Update();
+	// Children are not roots and their parents do not update them, the flattened hierarchy holds both
+	refreshHierarchy();
+	for (size_t i = 0; i < m_hierarchyNodes.size(); ++i)
+		m_hierarchyNodes[i]->Update();
 }
 
 void Scene::Render()
 {
-	// Shadow Map Pass
-	glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-	glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-	glClear(GL_DEPTH_BUFFER_BIT);
-	Shader* shadow = SERVICE_LOCATOR.GetResourceManager()->GetShader("Shadow");
-	shadow->Use();
-	shadow->SetUniform("lightSpaceMatrix", lightSpaceMatrix);
+	UpdateWorldTransforms();
 
-	// Render all game objects from light's perspective
-	for (auto& node : m_nodes)
+	// Objects are culled against the light's and the camera's frustum separately, then go into the
+	// passes that see them, sorted so objects sharing state are drawn together
+	Renderer* renderer = SERVICE_LOCATOR.GetRenderer();
+	RenderQueue& queue = renderer->GetRenderQueue();
+	FrustumCuller& culler = renderer->GetCuller();
+	Camera* camera = Camera::GetInstance();
+	Shader* shadow = SERVICE_LOCATOR.GetResourceManager()->GetShader("Shadow");
+	culler.Clear();
+	m_renderables.clear();
+	for (Node* node : m_hierarchyNodes)
 	{
-		GameObject* gameObject = dynamic_cast<GameObject*>(node);
-		if (gameObject)
+		if (RenderComponent* renderComponent = node->GetComponent<RenderComponent>())
 		{
-			gameObject->Render(shadow);
+			Geometry* geometry = renderComponent->GetGeometry();
+			culler.Add(geometry ? geometry->GetBoundingVolume() : BoundingVolume(), node->GetWorldTransform());
+			m_renderables.push_back(renderComponent);
 		}
-		else
-			continue;
 	}
-	shadow->Unuse();
+	renderer->Cull(RenderPass::SHADOW, lightSpaceMatrix);
+	renderer->Cull(RenderPass::MAIN, camera->m_worldProjection * camera->m_worldView);
+
+	queue.Clear();
+	for (uint32_t i = 0; i < m_renderables.size(); ++i)
+	{
+		m_renderables[i]->Queue(queue, shadow, camera->m_worldView,
+			renderer->IsVisible(RenderPass::SHADOW, i), renderer->IsVisible(RenderPass::MAIN, i));
+	}
+	queue.Sort();
+
+	FrameUniforms frame;
+	frame.view = camera->m_worldView;
+	frame.projection = camera->m_worldProjection;
+	frame.shadowMatrix = SERVICE_LOCATOR.GetGameObjectManager()->GetShadowMatrix(camera->m_worldProjection);
+	frame.lightSpaceMatrix = lightSpaceMatrix;
+	frame.lightPosition = lightPosition;
+	frame.lightAmbient = lightAmbient;
+	frame.lightDiffuse = lightDiffuse;
+	frame.lightSpecular = lightSpecular;
+	frame.shadowMap = depthMap;
+	frame.debugNormals = SERVICE_LOCATOR.GetUI()->GetState("Debug Options", "Normals", IMGUI_ELEMENT_TYPE::DROPDOWN_TOGGLE);
+	renderer->GetBackend().BeginFrame(frame);
+
+	// Shadow Map Pass
+	glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
+	glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
+	glClear(GL_DEPTH_BUFFER_BIT);
+	queue.Submit(RenderPass::SHADOW, renderer->GetBackend());
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
 	// Reset viewport for scene or debugging
@@ -177,40 +242,80 @@ void Scene::Render()
 		shadowDebug->Unuse();
 	}
 
-	
 	// Final Render Pass
-	for (auto& node : m_nodes)
+	if (SERVICE_LOCATOR.GetUI()->GetState("Debug Options", "Wireframes", IMGUI_ELEMENT_TYPE::DROPDOWN_TOGGLE))
+		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+	queue.Submit(RenderPass::MAIN, renderer->GetBackend());
+	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+	for (Node* node : m_hierarchyNodes)
 	{
-		GameObject* gameObject = dynamic_cast<GameObject*>(node);
-		if (gameObject)
-		{
-			gameObject->Render();
-		}
+		if (RenderComponent* renderComponent = node->GetComponent<RenderComponent>())
+			renderComponent->DrawDebug();
 		else
 			node->Render();
 	}
-		
+
+	renderer->EndFrame();
 }
 
 void Scene::PostUpdate()
 {
     for (auto& node : m_nodes)
+    {
+        // deleted nodes take their transforms with them
+        if (node->NeedsDeletion())
+            MarkHierarchyChanged();
         node->Flush();
+    }
 }
 
 void Scene::Shutdown()
 {
+	// Runs again from the destructor, and for scenes that never ran, which have nothing to release
+	if (m_nodes.empty() && m_pools.IsReleased())
+		return;
+
 	for (auto& node : m_nodes)
 		node->Shutdown();
 
-    for (auto& node : m_nodes)
-        node->Destroy();
+#ifdef _DEBUG
+	m_pools.PrintStats();
+#endif // _DEBUG
+
+	// Only this scene's objects are forgotten, the manager may hold another scene's. Destructors still run
+	// so components can unregister from their managers, but the memory is handed back page by page
+	GameObjectManager* gameObjects = SERVICE_LOCATOR.GetGameObjectManager();
+	std::vector<Node*> owned(m_nodes.begin(), m_nodes.end());
+	for (size_t i = 0; i < owned.size(); ++i)
+	{
+		if (GameObject* object = dynamic_cast<GameObject*>(owned[i]))
+			gameObjects->Forget(object);
+		for (Node* child : owned[i]->GetChildren())
+			owned.push_back(child);
+	}
+	m_pools.BeginRelease();
+	for (auto& node : m_nodes)
+	{
+		// Node::~Node deletes the children, deleting one that is also listed here would free it twice
+		if (!node->GetParent())
+			delete node;
+	}
+	m_nodes.clear();
+	m_nodeCount = 0;
+	m_pOriginFocus = nullptr;
+	m_origin = glm::dvec3(0.0);
+	m_pools.Release();
+	m_hierarchy.clear();
+	m_hierarchyNodes.clear();
+	MarkHierarchyChanged();
 }
 
 void Scene::AddNode(Node* node)
 {
     m_nodes.push_back(node);
     node->SetID(++m_nodeCount);
+    MarkHierarchyChanged();
 }
 
 void Scene::DeleteNode(Node* node)
@@ -230,19 +335,118 @@ Node* Scene::RemoveNode(Node* node)
     auto it = std::find_if(m_nodes.begin(), m_nodes.end(),
         [id](Node* node) { return node->GetID() == id; });
 
+    // nodes that were never added to the scene (children created by the factory) have nothing to remove
+    if (it == m_nodes.end())
+        return nullptr;
+
+    Node* removed = *it;
     // replace the last node with deleted one unless we are deleting the last node in order to prevent access violation
-    if (it != m_nodes.end()) {
-        auto lastNode = m_nodes.back();
+    auto lastNode = m_nodes.back();
+    if (id != lastNode->GetID())
+    {
+        lastNode->SetID(id);
+        *it = lastNode;
+    }
 
-        if (id != lastNode->GetID())
-        {
-            lastNode->SetID(id);
-            *it = lastNode;
-        }
+    m_nodes.pop_back();
+    m_nodeCount--;
+    if (removed == m_pOriginFocus)
+        m_pOriginFocus = nullptr;
+    MarkHierarchyChanged();
 
-        m_nodes.pop_back();
-        m_nodeCount--;
-    }
+    return removed;
+}
+
+void Scene::SetOriginFocus(Node* focus, double threshold)
+{
+	m_pOriginFocus = focus;
+	m_originThreshold = threshold;
+}
+
+void Scene::UpdateOrigin()
+{
+	if (!m_pOriginFocus)
+		return;
+	const glm::dvec3 focus(m_pOriginFocus->GetTransform()->GetPosition());
+	if (glm::length2(focus) <= m_originThreshold * m_originThreshold)
+		return;
+	// Whole metres, so positions that were exact stay exact
+	ShiftOrigin(-glm::round(focus));
+}
+
+void Scene::ShiftOrigin(const glm::dvec3& shift)
+{
+	const glm::vec3 offset(shift);
+	for (Node* node : m_nodes)
+		node->GetTransform()->SetPosition(node->GetTransform()->GetPosition() + offset);
+	SERVICE_LOCATOR.GetPhysicsManager()->ShiftOrigin(shift);
+	SERVICE_LOCATOR.GetCollisionManager()->ShiftOrigin(shift);
+
+	// The light keeps its place in the world, the shadow map keeps looking at the same spot
+	lightPosition += offset;
+	lightSpaceMatrix = lightSpaceMatrix * glm::translate(glm::mat4(1.0f), -offset);
+	m_origin -= shift;
+}
+
+void Scene::UpdateWorldTransforms()
+{
+	// A rebuilt hierarchy may have re-parented nodes, so every world matrix is refreshed once
+	refreshHierarchy();
+	const bool refreshAll = m_refreshAllWorlds;
+	m_refreshAllWorlds = false;
+
+	TransformStorage& transforms = Transform::GetStorage();
+	for (size_t i = 0; i < m_hierarchy.size(); ++i)
+	{
+		const HierarchyEntry& entry = m_hierarchy[i];
+		uint32_t index = transforms.Index(entry.transform);
+		bool parentChanged = entry.parent >= 0 && m_worldChanged[entry.parent];
+
+		if (!refreshAll && !parentChanged && !(transforms.dirty[index] & TransformStorage::STALE_WORLD))
+		{
+			m_worldChanged[i] = 0;
+			continue;
+		}
+
+		transforms.Resolve(index);
+		if (entry.parent >= 0)
+			transforms.world[index] = transforms.world[transforms.Index(m_hierarchy[entry.parent].transform)] * transforms.model[index];
+		else
+			transforms.world[index] = transforms.model[index];
+		transforms.dirty[index] &= ~TransformStorage::STALE_WORLD;
+		m_worldChanged[i] = 1;
+	}
+}
 
-    return *it;
-}
\ No newline at end of file
+void Scene::refreshHierarchy()
+{
+	if (!m_hierarchyChanged.exchange(false, std::memory_order_relaxed))
+		return;
+	rebuildHierarchy();
+	m_refreshAllWorlds = true;
+}
+
+void Scene::rebuildHierarchy()
+{
+	m_hierarchy.clear();
+	std::vector<Node*>& order = m_hierarchyNodes;
+	order.clear();
+	order.reserve(m_nodes.size());
+
+	for (Node* node : m_nodes)
+	{
+		order.push_back(node);
+		m_hierarchy.push_back({ node->GetTransform()->GetHandle(), -1 });
+	}
+
+	// breadth first: the children of entry i are appended after every entry before them
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		for (Node* child : order[i]->GetChildren())
+		{
+			order.push_back(child);
+			m_hierarchy.push_back({ child->GetTransform()->GetHandle(), static_cast<int32_t>(i) });
+		}
+	}
+	m_worldChanged.assign(m_hierarchy.size(), 0);
+}
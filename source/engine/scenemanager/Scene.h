@@ -1,11 +1,13 @@
 class Node;
 class Skybox;	
+class RenderComponent;
+enum class BroadphaseType;
 
 #pragma once
 class Scene
 {
 public:
-	Scene() : m_nodeCount(0) {};
+	Scene();
 	~Scene();
 
 	void Init();
@@ -27,6 +29,37 @@ public:
 	//@return Node* : Removed node
 	Node* RemoveNode(Node* node);
 	
+	//@brief Refreshes the cached world matrices, parents before children, touching only
+	// nodes whose transform changed and their descendants
+	void UpdateWorldTransforms();
+
+	//@brief Flags the flattened hierarchy for a rebuild after nodes were added, removed or re-parented
+	inline void MarkHierarchyChanged() { m_hierarchyChanged.store(true, std::memory_order_relaxed); }
+
+	// Distance the origin focus may stray from the origin before the scene is rebased onto it, in metres
+	static constexpr double DEFAULT_ORIGIN_THRESHOLD = 1000.0;
+
+	//@brief Keeps the origin near a node, usually the player. Positions are floats, which lose millimetres
+	// a few kilometres out, so the whole scene is moved back around the focus once it strays too far
+	//@param focus : Node to follow, nullptr to leave the origin where it is
+	//@param threshold : Distance from the origin that triggers a rebase
+	void SetOriginFocus(Node* focus, double threshold = DEFAULT_ORIGIN_THRESHOLD);
+
+	//@brief Returns the node the origin follows
+	//@return Node* : Origin focus, nullptr if there is none
+	inline Node* GetOriginFocus() const { return m_pOriginFocus; }
+
+	//@brief Rebases the origin onto the focus if it strayed past the threshold. Runs after each physics step
+	void UpdateOrigin();
+
+	//@brief Moves every root node, the bodies and colliders on them and the light by shift
+	//@param shift : Offset added to every root position
+	void ShiftOrigin(const glm::dvec3& shift);
+
+	//@brief Returns where the current origin lies in the coordinates the scene was loaded in
+	//@return glm::dvec3 : Accumulated origin
+	inline const glm::dvec3& GetOrigin() const { return m_origin; }
+
 	//@brief Sets the scene name
 	//@param name : Scene name
 	void SetName(const std::string& name) { m_name = name; }
@@ -35,6 +68,10 @@ public:
 	//@param sceneSource : Scene source
 	void SetSceneSource(const char* sceneSource) { m_sceneSource = sceneSource; }
 
+	//@brief Sets how the collision manager finds candidate pairs while this scene is active
+	//@param broadphase : Broadphase strategy, the AABB tree by default
+	inline void SetBroadphase(BroadphaseType broadphase) { m_broadphase = broadphase; }
+
 	//@brief Returns the list of nodes
 	//@return std::vector<Node*> : List of nodes
 	std::vector<Node*> GetNodes() { return m_nodes; }
@@ -47,6 +84,14 @@ public:
 	//@return std::string : Scene source
 	inline std::string GetSceneSource() const { return m_sceneSource; }
 
+	//@brief Returns the broadphase strategy of the scene
+	//@return BroadphaseType : Broadphase strategy
+	inline BroadphaseType GetBroadphase() const { return m_broadphase; }
+
+	//@brief Returns the pools the scene's game objects and components are allocated from
+	//@return ScenePools& : Scene pools
+	inline ScenePools& GetPools() { return m_pools; }
+
 	glm::vec3 lightPosition;
 	glm::vec3 lightSpecular;
 	glm::vec3 lightDiffuse;
@@ -55,10 +100,41 @@ public:
 	float near_plane, far_plane;
 	unsigned int depthMap;
 private:
+	// Node of the flattened hierarchy, stored breadth first so parents precede their children
+	struct HierarchyEntry
+	{
+		uint32_t transform;		// Transform handle of the node
+		int32_t parent;			// Index of the parent entry, -1 for root nodes
+	};
+
+	//@brief Flattens the node tree into m_hierarchy in breadth-first order
+	void rebuildHierarchy();
+
+	//@brief Rebuilds the flattened hierarchy if nodes were added, removed or re-parented since the last rebuild
+	void refreshHierarchy();
+
+	//@brief Parses the scene json and creates its game objects
+	//@return bool : False if the scene has no data and needs no further setup
+	bool loadJson();
+
+	//@brief Creates the skybox and initializes the nodes once the scene's game objects exist
+	void initNodes();
+
 	int m_nodeCount;
 	std::string m_name;
 	std::string m_sceneSource;
+	BroadphaseType m_broadphase;
 	std::vector<Node*> m_nodes;
+	glm::dvec3 m_origin;
+	Node* m_pOriginFocus;
+	double m_originThreshold;
+	ScenePools m_pools;
+	std::vector<HierarchyEntry> m_hierarchy;
+	std::vector<Node*> m_hierarchyNodes;	// node of each entry, children included
+	bool m_refreshAllWorlds;				// the hierarchy was rebuilt since the last world transform pass
+	std::vector<uint8_t> m_worldChanged;	// per entry, world matrix was refreshed in the current pass
+	std::vector<RenderComponent*> m_renderables;	// of the frame Render draws, indexed as the renderer's culler
+	std::atomic<bool> m_hierarchyChanged;
 	std::unique_ptr<Skybox> m_pSkybox;
 	const unsigned int SHADOW_WIDTH = 1024, SHADOW_HEIGHT = 1024;
 	unsigned int depthMapFBO;
@@ -1,5 +1,6 @@
 #include "../pch.h"
 #include "SceneManager.h"
+#include "CompiledScene.h"
 
 std::unique_ptr<SceneManager> SceneManager::instance = nullptr;
 
@@ -86,6 +87,19 @@ void SceneManager::ExportScene(Scene* scene)
 
 	// Output the message with the file name and path
 	std::cout << "Scene exported to file: " << sourcePath.filename() << " in path: " << directory << std::endl;
+
+	// Keep the compiled scene in step with the json it was built from
+	CompiledScene::Compile(source);
+}
+
+void SceneManager::CompileScenes()
+{
+	for (const std::string& name : m_sceneOrder)
+	{
+		const std::string source = m_scenes[name]->GetSceneSource();
+		if (CompiledScene::IsStale(source) && CompiledScene::Compile(source))
+			std::cout << "Scene compiled: " << CompiledScene::GetCompiledPath(source) << std::endl;
+	}
 }
 
 void SceneManager::AddScene(std::string name, const std::source_location& location)
@@ -267,7 +281,7 @@ void SceneManager::processNode(Node* node, rapidjson::Value& nodeJson, rapidjson
 		rapidjson::Value componentJson(rapidjson::kObjectType);
 
 		processComponent(component, componentJson, allocator);
-		componentGroupJson.AddMember(rapidjson::Value(name.c_str(), allocator).Move(), componentJson, allocator);
+		componentGroupJson.AddMember(rapidjson::Value(name.data(), static_cast<rapidjson::SizeType>(name.size()), allocator).Move(), componentJson, allocator);
 	}
 	nodeJson.AddMember(rapidjson::Value("Components", allocator).Move(), componentGroupJson, allocator);
 }
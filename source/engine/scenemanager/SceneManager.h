@@ -11,6 +11,9 @@ public:
 	//@param scene : Scene to export
 	void ExportScene(Scene* scene);
 
+	//@brief Compiles the json of every scene whose compiled binary is missing or out of date
+	void CompileScenes();
+
 	//@brief Adds a new scene to the list
 	void AddScene(std::string name = "", const std::source_location& location = std::source_location::current());
 
@@ -40,6 +43,15 @@ public:
 
 	inline Scene* GetCurrentScene() { return m_pCurrentScene; }
 
+	//@brief Returns a scene by name
+	//@param name : Scene name
+	//@return Scene* : The scene, nullptr if there is none by that name
+	inline Scene* GetScene(const std::string& name)
+	{
+		auto it = m_scenes.find(name);
+		return it != m_scenes.end() ? it->second : nullptr;
+	}
+
 
 private:
 	static SceneManager* GetInstance();
@@ -0,0 +1,62 @@
+#include "../pch.h"
+#include "ScenePools.h"
+
+void ScenePools::BeginRelease()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (auto& pool : m_pools)
+	{
+		if (pool)
+			pool->BeginRelease();
+	}
+}
+
+void ScenePools::Release()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (auto& pool : m_pools)
+	{
+		if (pool)
+			pool->Release();
+	}
+}
+
+bool ScenePools::IsReleased() const
+{
+	for (const auto& stats : GetStats())
+	{
+		if (stats.pages != 0)
+			return false;
+	}
+	return true;
+}
+
+std::vector<PoolAllocator::Stats> ScenePools::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::vector<PoolAllocator::Stats> stats;
+	for (auto& pool : m_pools)
+	{
+		if (pool)
+			stats.push_back(pool->GetStats());
+	}
+	return stats;
+}
+
+void ScenePools::PrintStats() const
+{
+	for (const auto& stats : GetStats())
+	{
+		std::cout << stats.name << ": " << stats.liveObjects << " live, " << stats.peakObjects << " peak, "
+			<< stats.totalAllocations << " allocations, " << stats.pages << " pages ("
+			<< stats.reservedBytes / 1024 << " KB, " << stats.slotSize << " B/slot)" << std::endl;
+	}
+}
+
+size_t ScenePools::registerPool()
+{
+	size_t id = s_poolCount.fetch_add(1, std::memory_order_acq_rel);
+	if (id >= MAX_POOLS)
+		throw std::runtime_error("Too many pooled types, raise ScenePools::MAX_POOLS");
+	return id;
+}
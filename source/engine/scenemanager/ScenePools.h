@@ -0,0 +1,56 @@
+#pragma once
+
+// The pools a scene allocates its game objects and components from, one PoolAllocator
+// per type. Shutting the scene down drops the pools page by page
+class ScenePools
+{
+public:
+	// Upper bound of distinct pooled types
+	static constexpr size_t MAX_POOLS = 64;
+
+	//@brief Returns the pool of the type, creating it on the first call
+	//@return PoolAllocator& : Pool sized for DataType
+	template <typename DataType>
+	PoolAllocator& Get()
+	{
+		static_assert(alignof(DataType) <= PoolAllocator::SLOT_ALIGNMENT, "Type is over-aligned for the pool");
+		static const size_t id = registerPool();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		std::unique_ptr<PoolAllocator>& pool = m_pools[id];
+		if (!pool)
+			pool = std::make_unique<PoolAllocator>(Utils::GetClassName<DataType>(), sizeof(DataType));
+		return *pool;
+	}
+
+	//@brief Preallocates pages so count objects of the type can be created without touching the heap
+	//@param count : Number of objects
+	template <typename DataType>
+	void Reserve(size_t count) { Get<DataType>().Reserve(count); }
+
+	//@brief Makes deletes no-ops until Release, objects can then be destroyed without returning their slots
+	void BeginRelease();
+
+	//@brief Drops the pages of every pool
+	void Release();
+
+	//@brief Returns whether no pool holds pages, as before the first allocation or after Release
+	bool IsReleased() const;
+
+	//@brief Returns the statistics of every pool created so far
+	//@return std::vector<PoolAllocator::Stats> : One entry per pool
+	std::vector<PoolAllocator::Stats> GetStats() const;
+
+	//@brief Prints the statistics of every pool
+	void PrintStats() const;
+
+private:
+	//@brief Reserves the next free pool ID for a new type
+	//@return size_t : The reserved ID
+	static size_t registerPool();
+
+	static inline std::atomic<size_t> s_poolCount{ 0 };
+
+	std::array<std::unique_ptr<PoolAllocator>, MAX_POOLS> m_pools;
+	mutable std::mutex m_mutex;
+};
@@ -6,6 +6,7 @@
 #include "RenderComponent.h"
 #include "../DeserializeJSON.h"
 #include "../scenemanager/SceneManager.h"
+#include "../physics/PhysicsManager.h"
 
 bool UI::m_Hovering = false;
 
@@ -125,6 +126,20 @@ void UI::Render()
         }
         ImGui::PopID();
 
+        // Vertex data sent to the GPU in the last frame, 0 once every mesh is resident
+        if (mp_windowProps->Width >= 1010)
+        {
+            ImGui::SetCursorPosX(static_cast<float>(mp_windowProps->Width - 310));
+            ImGui::Text("Uploaded: %llu B", static_cast<unsigned long long>(SERVICE_LOCATOR.GetRenderer()->GetBytesUploaded()));
+        }
+
+        // Bodies the last physics step simulated, the rest are asleep
+        if (mp_windowProps->Width >= 890)
+        {
+            ImGui::SetCursorPosX(static_cast<float>(mp_windowProps->Width - 190));
+            ImGui::Text("Awake: %u", SERVICE_LOCATOR.GetPhysicsManager()->GetSleepStats().awake);
+        }
+
         // Display the frame rate on the far right
         if (mp_windowProps->Width >= 790)
         {
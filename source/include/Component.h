@@ -1,7 +1,7 @@
 #pragma once
 class Node;
 
-class Component : public IHasGettersSetters
+class Component : public IHasGettersSetters, public PooledObject
 {
 public:
 	Component() : pOwner(nullptr) {}
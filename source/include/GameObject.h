@@ -16,6 +16,19 @@ public:
 	void SetDead(bool isDead);
 
 	const bool IsDead() const { return !m_isAlive; }
+
+	//@brief Returns the handle the GameObjectManager issued for this object
+	//@return GameObjectHandle : Handle, null if the object is not registered
+	inline GameObjectHandle GetHandle() const { return m_handle; }
+protected:
+	//@brief Invalidates the manager's cached queries when a component is added or removed
+	void onComponentsChanged() override;
 private:
+	//@brief Assigns the handle (GameObjectManager only)
+	inline void SetHandle(GameObjectHandle handle) { m_handle = handle; }
+
 	bool m_isAlive;
+	GameObjectHandle m_handle;
+
+	friend class GameObjectManager;
 };
\ No newline at end of file
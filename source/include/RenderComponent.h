@@ -15,6 +15,17 @@ public:
 	// object
 	void Render();
 	void Render(Shader* shader);
+
+	//@brief Queues the object in the passes that see it
+	//@param queue : Queue of the frame
+	//@param shadowShader : Shader of the shadow pass
+	//@param view : View matrix of the camera, to sort the main pass by depth
+	//@param inShadow : Whether the object is in the light's frustum
+	//@param inView : Whether the object is in the camera's frustum
+	void Queue(RenderQueue& queue, Shader* shadowShader, const glm::mat4& view, bool inShadow, bool inView);
+	//@brief Draws the collider and velocity of the object if the debug options ask for them
+	void DrawDebug();
+
 	void DrawCollider();
 	void DrawVelocity();
 
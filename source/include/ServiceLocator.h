@@ -15,6 +15,7 @@ class ResourceManager;
 class GameObjectFactory;
 class GameObjectManager;
 class AudioManager;
+class JobSystem;
 
 class ServiceLocator
 {
@@ -29,6 +30,7 @@ private:
 	CollisionManager* mp_CollisionManager;
 	ScriptManager* mp_ScriptManager;
 	AudioManager* mp_AudioManager;
+	JobSystem* mp_JobSystem;
 
 	mutable SceneManager* mp_SceneManager = nullptr;
 	mutable ResourceFactory* mp_ResourceFactory = nullptr;
@@ -61,6 +63,8 @@ public:
 	SceneManager* GetSceneManager() const;
 	//@brief Returns the AudioManager
 	AudioManager* GetAudioManager() const;
+	//@brief Returns the JobSystem
+	JobSystem* GetJobSystem() const;
 
 	// @brief Returns the ResourceFactory
 	ResourceFactory* GetResourceFactory() const;